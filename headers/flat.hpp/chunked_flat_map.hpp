@@ -0,0 +1,728 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "flat_fwd.hpp"
+
+#include <iterator>
+
+namespace flat_hpp
+{
+    template < typename Key
+             , typename Value
+             , typename Compare
+             , std::size_t ChunkSize >
+    class chunked_flat_map
+        : private detail::pair_compare<
+            std::pair<Key, Value>,
+            Compare>
+    {
+        using base_type = detail::pair_compare<
+            std::pair<Key, Value>,
+            Compare>;
+
+        using chunk_type = std::vector<std::pair<Key, Value>>;
+        using chunks_type = std::vector<chunk_type>;
+
+        static_assert(
+            ChunkSize > 1,
+            "flat_hpp::chunked_flat_map: ChunkSize must be greater than one");
+
+        template < bool Const >
+        class basic_iterator;
+    public:
+        using key_type = Key;
+        using mapped_type = Value;
+        using value_type = std::pair<Key, Value>;
+
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        using key_compare = Compare;
+
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using pointer = value_type*;
+        using const_pointer = const value_type*;
+
+        using iterator = basic_iterator<false>;
+        using const_iterator = basic_iterator<true>;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        static constexpr size_type chunk_size = ChunkSize;
+    public:
+        chunked_flat_map() = default;
+        ~chunked_flat_map() = default;
+
+        explicit chunked_flat_map(const Compare& c)
+        : base_type(c) {}
+
+        template < typename InputIter >
+        chunked_flat_map(InputIter first, InputIter last) {
+            from_range_(first, last);
+        }
+
+        template < typename InputIter >
+        chunked_flat_map(InputIter first, InputIter last, const Compare& c)
+        : base_type(c) {
+            from_range_(first, last);
+        }
+
+        chunked_flat_map(std::initializer_list<value_type> ilist) {
+            from_range_(ilist.begin(), ilist.end());
+        }
+
+        chunked_flat_map(std::initializer_list<value_type> ilist, const Compare& c)
+        : base_type(c) {
+            from_range_(ilist.begin(), ilist.end());
+        }
+
+        chunked_flat_map(chunked_flat_map&& other) = default;
+        chunked_flat_map(const chunked_flat_map& other) = default;
+
+        chunked_flat_map& operator=(chunked_flat_map&& other) = default;
+        chunked_flat_map& operator=(const chunked_flat_map& other) = default;
+
+        chunked_flat_map& operator=(std::initializer_list<value_type> ilist) {
+            chunked_flat_map(ilist, key_comp()).swap(*this);
+            return *this;
+        }
+
+        iterator begin()
+        noexcept {
+            return iterator(&chunks_, 0, 0);
+        }
+
+        const_iterator begin() const
+        noexcept {
+            return const_iterator(&chunks_, 0, 0);
+        }
+
+        const_iterator cbegin() const
+        noexcept {
+            return const_iterator(&chunks_, 0, 0);
+        }
+
+        iterator end()
+        noexcept {
+            return iterator(&chunks_, chunks_.size(), 0);
+        }
+
+        const_iterator end() const
+        noexcept {
+            return const_iterator(&chunks_, chunks_.size(), 0);
+        }
+
+        const_iterator cend() const
+        noexcept {
+            return const_iterator(&chunks_, chunks_.size(), 0);
+        }
+
+        reverse_iterator rbegin()
+        noexcept {
+            return reverse_iterator(end());
+        }
+
+        const_reverse_iterator rbegin() const
+        noexcept {
+            return const_reverse_iterator(end());
+        }
+
+        const_reverse_iterator crbegin() const
+        noexcept {
+            return const_reverse_iterator(end());
+        }
+
+        reverse_iterator rend()
+        noexcept {
+            return reverse_iterator(begin());
+        }
+
+        const_reverse_iterator rend() const
+        noexcept {
+            return const_reverse_iterator(begin());
+        }
+
+        const_reverse_iterator crend() const
+        noexcept {
+            return const_reverse_iterator(begin());
+        }
+
+        bool empty() const
+        noexcept {
+            return size_ == 0;
+        }
+
+        size_type size() const
+        noexcept {
+            return size_;
+        }
+
+        size_type chunk_count() const
+        noexcept {
+            return chunks_.size();
+        }
+
+        mapped_type& operator[](key_type&& key) {
+            return try_emplace(std::move(key)).first->second;
+        }
+
+        mapped_type& operator[](const key_type& key) {
+            return try_emplace(key).first->second;
+        }
+
+        mapped_type& at(const key_type& key) {
+            const iterator iter = find(key);
+            if ( iter != end() ) {
+                return iter->second;
+            }
+            throw std::out_of_range("chunked_flat_map::at: key not found");
+        }
+
+        const mapped_type& at(const key_type& key) const {
+            const const_iterator iter = find(key);
+            if ( iter != end() ) {
+                return iter->second;
+            }
+            throw std::out_of_range("chunked_flat_map::at: key not found");
+        }
+
+        std::pair<iterator, bool> insert(value_type&& value) {
+            const position pos = lower_position_(value.first);
+            return found_(pos, value.first)
+                ? std::make_pair(make_iterator_(pos), false)
+                : std::make_pair(insert_at_(pos, std::move(value)), true);
+        }
+
+        std::pair<iterator, bool> insert(const value_type& value) {
+            return insert(value_type(value));
+        }
+
+        template < typename InputIter >
+        void insert(InputIter first, InputIter last) {
+            for ( ; first != last; ++first ) {
+                insert(*first);
+            }
+        }
+
+        void insert(std::initializer_list<value_type> ilist) {
+            insert(ilist.begin(), ilist.end());
+        }
+
+        template < typename... Args >
+        std::pair<iterator, bool> emplace(Args&&... args) {
+            return insert(value_type(std::forward<Args>(args)...));
+        }
+
+        template < typename TT >
+        std::pair<iterator, bool> insert_or_assign(key_type&& key, TT&& value) {
+            const std::pair<iterator, bool> result = try_emplace(std::move(key), std::forward<TT>(value));
+            if ( !result.second ) {
+                result.first->second = std::forward<TT>(value);
+            }
+            return result;
+        }
+
+        template < typename TT >
+        std::pair<iterator, bool> insert_or_assign(const key_type& key, TT&& value) {
+            const std::pair<iterator, bool> result = try_emplace(key, std::forward<TT>(value));
+            if ( !result.second ) {
+                result.first->second = std::forward<TT>(value);
+            }
+            return result;
+        }
+
+        template < typename... Args >
+        std::pair<iterator, bool> try_emplace(key_type&& key, Args&&... args) {
+            const position pos = lower_position_(key);
+            if ( found_(pos, key) ) {
+                return {make_iterator_(pos), false};
+            }
+            return {insert_at_(pos, value_type(
+                std::piecewise_construct,
+                std::forward_as_tuple(std::move(key)),
+                std::forward_as_tuple(std::forward<Args>(args)...))), true};
+        }
+
+        template < typename... Args >
+        std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args) {
+            const position pos = lower_position_(key);
+            if ( found_(pos, key) ) {
+                return {make_iterator_(pos), false};
+            }
+            return {insert_at_(pos, value_type(
+                std::piecewise_construct,
+                std::forward_as_tuple(key),
+                std::forward_as_tuple(std::forward<Args>(args)...))), true};
+        }
+
+        void clear() noexcept {
+            chunks_.clear();
+            firsts_.clear();
+            size_ = 0;
+        }
+
+        iterator erase(const_iterator iter) {
+            assert(iter != cend());
+            const size_type c = iter.chunk_;
+            const size_type i = iter.index_;
+
+            chunk_type& chunk = chunks_[c];
+            chunk.erase(chunk.begin() + static_cast<difference_type>(i));
+            --size_;
+
+            if ( chunk.empty() ) {
+                chunks_.erase(chunks_.begin() + static_cast<difference_type>(c));
+                firsts_.erase(firsts_.begin() + static_cast<difference_type>(c));
+                return iterator(&chunks_, c, 0);
+            }
+
+            if ( i == 0 ) {
+                firsts_[c] = chunk.front().first;
+            }
+
+            if ( chunk.size() < chunk_size / 4 && chunks_.size() > 1 ) {
+                return make_iterator_(merge_underfull_({c, i}));
+            }
+            return make_iterator_({c, i});
+        }
+
+        size_type erase(const key_type& key) {
+            const const_iterator iter = find(key);
+            if ( iter != end() ) {
+                erase(iter);
+                return 1;
+            }
+            return 0;
+        }
+
+        void swap(chunked_flat_map& other)
+            noexcept(std::is_nothrow_swappable_v<base_type>)
+        {
+            using std::swap;
+            swap(
+                static_cast<base_type&>(*this),
+                static_cast<base_type&>(other));
+            swap(chunks_, other.chunks_);
+            swap(firsts_, other.firsts_);
+            swap(size_, other.size_);
+        }
+
+        size_type count(const key_type& key) const {
+            return contains(key) ? 1 : 0;
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            size_type>
+        count(const K& key) const {
+            return contains(key) ? 1 : 0;
+        }
+
+        iterator find(const key_type& key) {
+            const position pos = lower_position_(key);
+            return found_(pos, key) ? make_iterator_(pos) : end();
+        }
+
+        const_iterator find(const key_type& key) const {
+            const position pos = lower_position_(key);
+            return found_(pos, key) ? make_const_iterator_(pos) : end();
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            iterator>
+        find(const K& key) {
+            const position pos = lower_position_(key);
+            return found_(pos, key) ? make_iterator_(pos) : end();
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            const_iterator>
+        find(const K& key) const {
+            const position pos = lower_position_(key);
+            return found_(pos, key) ? make_const_iterator_(pos) : end();
+        }
+
+        bool contains(const key_type& key) const {
+            return found_(lower_position_(key), key);
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            bool>
+        contains(const K& key) const {
+            return found_(lower_position_(key), key);
+        }
+
+        std::pair<iterator, iterator> equal_range(const key_type& key) {
+            return equal_range_(*this, key);
+        }
+
+        std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const {
+            return equal_range_(*this, key);
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            std::pair<iterator, iterator>>
+        equal_range(const K& key) {
+            return equal_range_(*this, key);
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            std::pair<const_iterator, const_iterator>>
+        equal_range(const K& key) const {
+            return equal_range_(*this, key);
+        }
+
+        iterator lower_bound(const key_type& key) {
+            return make_iterator_(lower_position_(key));
+        }
+
+        const_iterator lower_bound(const key_type& key) const {
+            return make_const_iterator_(lower_position_(key));
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            iterator>
+        lower_bound(const K& key) {
+            return make_iterator_(lower_position_(key));
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            const_iterator>
+        lower_bound(const K& key) const {
+            return make_const_iterator_(lower_position_(key));
+        }
+
+        iterator upper_bound(const key_type& key) {
+            return make_iterator_(upper_position_(key));
+        }
+
+        const_iterator upper_bound(const key_type& key) const {
+            return make_const_iterator_(upper_position_(key));
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            iterator>
+        upper_bound(const K& key) {
+            return make_iterator_(upper_position_(key));
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            const_iterator>
+        upper_bound(const K& key) const {
+            return make_const_iterator_(upper_position_(key));
+        }
+
+        key_compare key_comp() const {
+            return *this;
+        }
+    private:
+        struct position {
+            size_type chunk;
+            size_type index;
+        };
+
+        // the top level index keeps the first key of every chunk, so a lookup
+        // is a binary search over the chunks and then inside a single chunk
+        template < typename K >
+        size_type chunk_of_(const K& key) const {
+            const auto iter = std::upper_bound(firsts_.begin(), firsts_.end(), key,
+                [this](const K& l, const key_type& r){
+                    return static_cast<const Compare&>(*this)(l, r);
+                });
+            return iter != firsts_.begin()
+                ? static_cast<size_type>(iter - firsts_.begin()) - 1
+                : 0;
+        }
+
+        template < typename K >
+        position lower_position_(const K& key) const {
+            if ( chunks_.empty() ) {
+                return {0, 0};
+            }
+            const size_type c = chunk_of_(key);
+            const chunk_type& chunk = chunks_[c];
+            const auto iter = std::lower_bound(chunk.begin(), chunk.end(), key, base_type(*this));
+            return {c, static_cast<size_type>(iter - chunk.begin())};
+        }
+
+        template < typename K >
+        position upper_position_(const K& key) const {
+            if ( chunks_.empty() ) {
+                return {0, 0};
+            }
+            const size_type c = chunk_of_(key);
+            const chunk_type& chunk = chunks_[c];
+            const auto iter = std::upper_bound(chunk.begin(), chunk.end(), key, base_type(*this));
+            return {c, static_cast<size_type>(iter - chunk.begin())};
+        }
+
+        template < typename K >
+        bool found_(const position& pos, const K& key) const {
+            return pos.chunk < chunks_.size()
+                && pos.index < chunks_[pos.chunk].size()
+                && !this->operator()(key, chunks_[pos.chunk][pos.index]);
+        }
+
+        position normalized_(position pos) const noexcept {
+            return pos.chunk < chunks_.size() && pos.index == chunks_[pos.chunk].size()
+                ? position{pos.chunk + 1, 0}
+                : pos;
+        }
+
+        iterator make_iterator_(const position& pos) noexcept {
+            const position npos = normalized_(pos);
+            return iterator(&chunks_, npos.chunk, npos.index);
+        }
+
+        const_iterator make_const_iterator_(const position& pos) const noexcept {
+            const position npos = normalized_(pos);
+            return const_iterator(&chunks_, npos.chunk, npos.index);
+        }
+
+        template < typename Self, typename K >
+        static auto equal_range_(Self& self, const K& key) {
+            const auto first = self.lower_bound(key);
+            const bool found = first != self.end() && !self.operator()(key, *first);
+            auto last = first;
+            return std::make_pair(first, found ? ++last : last);
+        }
+
+        iterator insert_at_(position pos, value_type&& value) {
+            if ( chunks_.empty() ) {
+                chunks_.emplace_back();
+                firsts_.push_back(value.first);
+            }
+
+            chunk_type& chunk = chunks_[pos.chunk];
+            chunk.insert(chunk.begin() + static_cast<difference_type>(pos.index), std::move(value));
+            ++size_;
+
+            if ( pos.index == 0 ) {
+                firsts_[pos.chunk] = chunk.front().first;
+            }
+
+            // a full chunk is split in halves, so an insert moves at most
+            // chunk_size elements plus one pointer per chunk in the index
+            if ( chunk.size() > chunk_size ) {
+                const size_type half = chunk.size() / 2;
+                chunk_type tail(
+                    std::make_move_iterator(chunk.begin() + static_cast<difference_type>(half)),
+                    std::make_move_iterator(chunk.end()));
+                chunk.erase(chunk.begin() + static_cast<difference_type>(half), chunk.end());
+
+                const auto next = static_cast<difference_type>(pos.chunk + 1);
+                firsts_.insert(firsts_.begin() + next, tail.front().first);
+                chunks_.insert(chunks_.begin() + next, std::move(tail));
+
+                if ( pos.index >= half ) {
+                    pos = {pos.chunk + 1, pos.index - half};
+                }
+            }
+
+            return iterator(&chunks_, pos.chunk, pos.index);
+        }
+
+        // an underfull chunk is merged into a neighbour, and the merged
+        // chunk is split in halves again if it outgrows chunk_size
+        position merge_underfull_(position pos) {
+            const size_type left = pos.chunk + 1 < chunks_.size() ? pos.chunk : pos.chunk - 1;
+            if ( left != pos.chunk ) {
+                pos = {left, chunks_[left].size() + pos.index};
+            }
+
+            const auto right = static_cast<difference_type>(left + 1);
+            chunk_type& chunk = chunks_[left];
+            chunk.insert(chunk.end(),
+                std::make_move_iterator(chunks_[left + 1].begin()),
+                std::make_move_iterator(chunks_[left + 1].end()));
+            chunks_.erase(chunks_.begin() + right);
+            firsts_.erase(firsts_.begin() + right);
+
+            if ( chunk.size() > chunk_size ) {
+                const size_type half = chunk.size() / 2;
+                chunk_type tail(
+                    std::make_move_iterator(chunk.begin() + static_cast<difference_type>(half)),
+                    std::make_move_iterator(chunk.end()));
+                chunk.erase(chunk.begin() + static_cast<difference_type>(half), chunk.end());
+
+                firsts_.insert(firsts_.begin() + right, tail.front().first);
+                chunks_.insert(chunks_.begin() + right, std::move(tail));
+
+                if ( pos.index >= half ) {
+                    pos = {left + 1, pos.index - half};
+                }
+            }
+
+            return pos;
+        }
+
+        template < typename InputIter >
+        void from_range_(InputIter first, InputIter last) {
+            chunk_type data(first, last);
+            std::stable_sort(data.begin(), data.end(), base_type(*this));
+            data.erase(
+                std::unique(data.begin(), data.end(),
+                    detail::eq_compare<base_type>(*this)),
+                data.end());
+
+            for ( size_type i = 0; i < data.size(); i += chunk_size ) {
+                const size_type n = std::min(chunk_size, data.size() - i);
+                chunks_.emplace_back(
+                    std::make_move_iterator(data.begin() + static_cast<difference_type>(i)),
+                    std::make_move_iterator(data.begin() + static_cast<difference_type>(i + n)));
+                firsts_.push_back(chunks_.back().front().first);
+            }
+            size_ = data.size();
+        }
+    private:
+        chunks_type chunks_;
+        std::vector<key_type> firsts_;
+        size_type size_ = 0;
+    };
+
+    template < typename Key
+             , typename Value
+             , typename Compare
+             , std::size_t ChunkSize >
+    template < bool Const >
+    class chunked_flat_map<Key, Value, Compare, ChunkSize>::basic_iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = std::pair<Key, Value>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+        using reference = std::conditional_t<Const, const value_type&, value_type&>;
+    public:
+        basic_iterator() = default;
+
+        template < bool C = Const, typename = std::enable_if_t<C> >
+        basic_iterator(const basic_iterator<false>& other) noexcept
+        : chunks_(other.chunks_)
+        , chunk_(other.chunk_)
+        , index_(other.index_) {}
+
+        reference operator*() const
+        noexcept {
+            return (*chunks_)[chunk_][index_];
+        }
+
+        pointer operator->() const
+        noexcept {
+            return &(*chunks_)[chunk_][index_];
+        }
+
+        basic_iterator& operator++() noexcept {
+            if ( ++index_ == (*chunks_)[chunk_].size() ) {
+                ++chunk_;
+                index_ = 0;
+            }
+            return *this;
+        }
+
+        basic_iterator operator++(int) noexcept {
+            basic_iterator iter = *this;
+            ++*this;
+            return iter;
+        }
+
+        basic_iterator& operator--() noexcept {
+            if ( index_ == 0 ) {
+                --chunk_;
+                index_ = (*chunks_)[chunk_].size();
+            }
+            --index_;
+            return *this;
+        }
+
+        basic_iterator operator--(int) noexcept {
+            basic_iterator iter = *this;
+            --*this;
+            return iter;
+        }
+
+        friend bool operator==(const basic_iterator& l, const basic_iterator& r) noexcept {
+            return l.chunk_ == r.chunk_ && l.index_ == r.index_;
+        }
+
+        friend bool operator!=(const basic_iterator& l, const basic_iterator& r) noexcept {
+            return !(l == r);
+        }
+    private:
+        friend class chunked_flat_map;
+        template < bool > friend class basic_iterator;
+
+        using chunks_pointer = std::conditional_t<Const, const chunks_type*, chunks_type*>;
+
+        basic_iterator(chunks_pointer chunks, size_type chunk, size_type index) noexcept
+        : chunks_(chunks)
+        , chunk_(chunk)
+        , index_(index) {}
+    private:
+        chunks_pointer chunks_ = nullptr;
+        size_type chunk_ = 0;
+        size_type index_ = 0;
+    };
+}
+
+namespace flat_hpp
+{
+    template < typename Key
+             , typename Value
+             , typename Compare
+             , std::size_t ChunkSize >
+    void swap(
+        chunked_flat_map<Key, Value, Compare, ChunkSize>& l,
+        chunked_flat_map<Key, Value, Compare, ChunkSize>& r)
+        noexcept(noexcept(l.swap(r)))
+    {
+        l.swap(r);
+    }
+
+    template < typename Key
+             , typename Value
+             , typename Compare
+             , std::size_t ChunkSize >
+    bool operator==(
+        const chunked_flat_map<Key, Value, Compare, ChunkSize>& l,
+        const chunked_flat_map<Key, Value, Compare, ChunkSize>& r)
+    {
+        return l.size() == r.size()
+            && std::equal(l.begin(), l.end(), r.begin());
+    }
+
+    template < typename Key
+             , typename Value
+             , typename Compare
+             , std::size_t ChunkSize >
+    bool operator!=(
+        const chunked_flat_map<Key, Value, Compare, ChunkSize>& l,
+        const chunked_flat_map<Key, Value, Compare, ChunkSize>& r)
+    {
+        return !(l == r);
+    }
+}
@@ -0,0 +1,348 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "flat_fwd.hpp"
+
+#include <cstdint>
+#include <iterator>
+#include <limits>
+
+#include "detail/bit_utils.hpp"
+
+namespace flat_hpp
+{
+    template < typename Key
+             , std::size_t BlockSize >
+    class compressed_flat_set {
+        static_assert(
+            std::is_integral_v<Key> && std::is_unsigned_v<Key>,
+            "flat_hpp::compressed_flat_set: Key must be an unsigned integral type");
+
+        static_assert(
+            BlockSize > 1,
+            "flat_hpp::compressed_flat_set: BlockSize must be greater than one");
+    public:
+        using key_type = Key;
+        using value_type = Key;
+
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        using key_compare = std::less<Key>;
+        using value_compare = std::less<Key>;
+
+        using reference = value_type;
+        using const_reference = value_type;
+
+        class const_iterator;
+        using iterator = const_iterator;
+
+        static constexpr size_type block_size = BlockSize;
+    public:
+        compressed_flat_set() = default;
+        ~compressed_flat_set() = default;
+
+        template < typename InputIter >
+        compressed_flat_set(sorted_unique_range_t, InputIter first, InputIter last) {
+            from_range_(first, last);
+        }
+
+        template < typename Container >
+        explicit compressed_flat_set(const flat_set<Key, std::less<Key>, Container>& set) {
+            from_range_(set.begin(), set.end());
+        }
+
+        compressed_flat_set(compressed_flat_set&& other) = default;
+        compressed_flat_set(const compressed_flat_set& other) = default;
+
+        compressed_flat_set& operator=(compressed_flat_set&& other) = default;
+        compressed_flat_set& operator=(const compressed_flat_set& other) = default;
+
+        const_iterator begin() const
+        noexcept {
+            return const_iterator(this, 0);
+        }
+
+        const_iterator cbegin() const
+        noexcept {
+            return begin();
+        }
+
+        const_iterator end() const
+        noexcept {
+            return const_iterator(this, firsts_.size());
+        }
+
+        const_iterator cend() const
+        noexcept {
+            return end();
+        }
+
+        bool empty() const
+        noexcept {
+            return size_ == 0;
+        }
+
+        size_type size() const
+        noexcept {
+            return size_;
+        }
+
+        size_type memory_usage() const
+        noexcept {
+            return firsts_.size() * sizeof(Key)
+                + offsets_.size() * sizeof(size_type)
+                + widths_.size() * sizeof(std::uint8_t)
+                + words_.size() * sizeof(std::uint64_t);
+        }
+
+        void swap(compressed_flat_set& other) noexcept {
+            using std::swap;
+            swap(firsts_, other.firsts_);
+            swap(offsets_, other.offsets_);
+            swap(widths_, other.widths_);
+            swap(words_, other.words_);
+            swap(size_, other.size_);
+        }
+
+        size_type count(Key key) const {
+            return contains(key) ? 1 : 0;
+        }
+
+        const_iterator find(Key key) const {
+            const const_iterator iter = lower_bound(key);
+            return iter != end() && *iter == key
+                ? iter
+                : end();
+        }
+
+        bool contains(Key key) const {
+            return find(key) != end();
+        }
+
+        const_iterator lower_bound(Key key) const {
+            const auto block_iter = std::upper_bound(firsts_.begin(), firsts_.end(), key);
+            if ( block_iter == firsts_.begin() ) {
+                return begin();
+            }
+            const_iterator iter(this, static_cast<size_type>(block_iter - firsts_.begin()) - 1);
+            const size_type block = iter.block_;
+            while ( iter.block_ == block && *iter < key ) {
+                ++iter;
+            }
+            return iter;
+        }
+
+        const_iterator upper_bound(Key key) const {
+            return key == std::numeric_limits<Key>::max()
+                ? end()
+                : lower_bound(static_cast<Key>(key + 1));
+        }
+
+        std::pair<const_iterator, const_iterator> equal_range(Key key) const {
+            const const_iterator iter = lower_bound(key);
+            if ( iter != end() && *iter == key ) {
+                const_iterator next = iter;
+                return {iter, ++next};
+            }
+            return {iter, iter};
+        }
+
+        void decode_block(size_type block, Key* out) const
+        noexcept {
+            assert(block < firsts_.size());
+            const size_type count = block_count_(block);
+            const unsigned width = widths_[block];
+            const std::uint64_t* words = words_.data() + offsets_[block];
+
+            // unpack the deltas first and turn them into keys with a separate
+            // prefix pass, so both loops stay simple enough to vectorize
+            for ( size_type i = 1; i < count; ++i ) {
+                out[i] = static_cast<Key>(detail::read_bits(words, (i - 1) * width, width) + 1);
+            }
+
+            out[0] = firsts_[block];
+            for ( size_type i = 1; i < count; ++i ) {
+                out[i] = static_cast<Key>(out[i] + out[i - 1]);
+            }
+        }
+
+        size_type block_count() const
+        noexcept {
+            return firsts_.size();
+        }
+
+        key_compare key_comp() const {
+            return key_compare();
+        }
+
+        value_compare value_comp() const {
+            return value_compare();
+        }
+    private:
+        size_type block_count_(size_type block) const
+        noexcept {
+            return block + 1 < firsts_.size()
+                ? block_size
+                : size_ - block * block_size;
+        }
+
+        static std::uint64_t delta_(Key prev, Key next) noexcept {
+            return static_cast<std::uint64_t>(next) - prev - 1u;
+        }
+
+        template < typename Iter >
+        void from_range_(Iter first, Iter last) {
+            std::vector<Key> block;
+            block.reserve(block_size);
+            for ( ; first != last; ++first ) {
+                assert(block.empty() || block.back() < static_cast<Key>(*first));
+                block.push_back(static_cast<Key>(*first));
+                if ( block.size() == block_size ) {
+                    append_block_(block);
+                    block.clear();
+                }
+            }
+            if ( !block.empty() ) {
+                append_block_(block);
+            }
+            firsts_.shrink_to_fit();
+            offsets_.shrink_to_fit();
+            widths_.shrink_to_fit();
+            words_.shrink_to_fit();
+        }
+
+        void append_block_(const std::vector<Key>& block) {
+            std::uint64_t max_delta = 0;
+            for ( size_type i = 1; i < block.size(); ++i ) {
+                max_delta = std::max(max_delta, delta_(block[i - 1], block[i]));
+            }
+
+            const unsigned width = detail::bit_width64(max_delta);
+            const std::uint64_t bits = (block.size() - 1) * width;
+            const size_type offset = words_.size();
+
+            firsts_.push_back(block.front());
+            offsets_.push_back(offset);
+            widths_.push_back(static_cast<std::uint8_t>(width));
+            words_.resize(offset + static_cast<size_type>((bits + 63) / 64));
+
+            for ( size_type i = 1; i < block.size(); ++i ) {
+                detail::write_bits(
+                    words_.data() + offset,
+                    (i - 1) * width,
+                    width,
+                    delta_(block[i - 1], block[i]));
+            }
+
+            size_ += block.size();
+        }
+    private:
+        std::vector<Key> firsts_;
+        std::vector<size_type> offsets_;
+        std::vector<std::uint8_t> widths_;
+        std::vector<std::uint64_t> words_;
+        size_type size_ = 0;
+    };
+
+    template < typename Key
+             , std::size_t BlockSize >
+    // keys are decoded on the fly and returned by value, there is no key
+    // object to refer to, so the iterator is only an input iterator
+    class compressed_flat_set<Key, BlockSize>::const_iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Key;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Key;
+    public:
+        const_iterator() = default;
+
+        reference operator*() const
+        noexcept {
+            return value_;
+        }
+
+        const_iterator& operator++() noexcept {
+            if ( ++index_ < set_->block_count_(block_) ) {
+                const unsigned width = set_->widths_[block_];
+                value_ = static_cast<Key>(value_ + 1u + detail::read_bits(
+                    set_->words_.data() + set_->offsets_[block_],
+                    (index_ - 1) * width,
+                    width));
+            } else {
+                seek_(block_ + 1);
+            }
+            return *this;
+        }
+
+        const_iterator operator++(int) noexcept {
+            const_iterator iter = *this;
+            ++*this;
+            return iter;
+        }
+
+        friend bool operator==(const const_iterator& l, const const_iterator& r) noexcept {
+            return l.block_ == r.block_ && l.index_ == r.index_;
+        }
+
+        friend bool operator!=(const const_iterator& l, const const_iterator& r) noexcept {
+            return !(l == r);
+        }
+    private:
+        friend class compressed_flat_set;
+
+        const_iterator(const compressed_flat_set* set, size_type block) noexcept
+        : set_(set) {
+            seek_(block);
+        }
+
+        void seek_(size_type block) noexcept {
+            block_ = block;
+            index_ = 0;
+            value_ = block_ < set_->firsts_.size() ? set_->firsts_[block_] : Key();
+        }
+    private:
+        const compressed_flat_set* set_ = nullptr;
+        size_type block_ = 0;
+        size_type index_ = 0;
+        Key value_ = Key();
+    };
+}
+
+namespace flat_hpp
+{
+    template < typename Key
+             , std::size_t BlockSize >
+    void swap(
+        compressed_flat_set<Key, BlockSize>& l,
+        compressed_flat_set<Key, BlockSize>& r) noexcept
+    {
+        l.swap(r);
+    }
+
+    template < typename Key
+             , std::size_t BlockSize >
+    bool operator==(
+        const compressed_flat_set<Key, BlockSize>& l,
+        const compressed_flat_set<Key, BlockSize>& r)
+    {
+        return l.size() == r.size()
+            && std::equal(l.begin(), l.end(), r.begin());
+    }
+
+    template < typename Key
+             , std::size_t BlockSize >
+    bool operator!=(
+        const compressed_flat_set<Key, BlockSize>& l,
+        const compressed_flat_set<Key, BlockSize>& r)
+    {
+        return !(l == r);
+    }
+}
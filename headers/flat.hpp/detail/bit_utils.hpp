@@ -0,0 +1,107 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace flat_hpp::detail
+{
+    inline unsigned popcount64(std::uint64_t v) noexcept {
+    #if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned>(__builtin_popcountll(v));
+    #else
+        v = v - ((v >> 1u) & 0x5555555555555555ull);
+        v = (v & 0x3333333333333333ull) + ((v >> 2u) & 0x3333333333333333ull);
+        v = (v + (v >> 4u)) & 0x0F0F0F0F0F0F0F0Full;
+        return static_cast<unsigned>((v * 0x0101010101010101ull) >> 56u);
+    #endif
+    }
+
+    inline unsigned bit_width64(std::uint64_t v) noexcept {
+    #if defined(__GNUC__) || defined(__clang__)
+        return v != 0 ? 64u - static_cast<unsigned>(__builtin_clzll(v)) : 0u;
+    #else
+        unsigned width = 0;
+        while ( v != 0 ) {
+            v >>= 1u;
+            ++width;
+        }
+        return width;
+    #endif
+    }
+
+    inline std::uint64_t low_mask64(unsigned width) noexcept {
+        return width < 64 ? (std::uint64_t{1} << width) - 1 : ~std::uint64_t{0};
+    }
+
+    inline constexpr std::array<std::array<std::uint8_t, 8>, 256> select_in_byte_table = []{
+        std::array<std::array<std::uint8_t, 8>, 256> table{};
+        for ( unsigned byte = 0; byte < 256; ++byte ) {
+            unsigned rank = 0;
+            for ( unsigned bit = 0; bit < 8; ++bit ) {
+                if ( (byte >> bit) & 1u ) {
+                    table[byte][rank++] = static_cast<std::uint8_t>(bit);
+                }
+            }
+        }
+        return table;
+    }();
+
+    // position of the k-th (zero based) set bit, k must be less than popcount64(v)
+    inline unsigned select64(std::uint64_t v, unsigned k) noexcept {
+        std::uint64_t s = v - ((v >> 1u) & 0x5555555555555555ull);
+        s = (s & 0x3333333333333333ull) + ((s >> 2u) & 0x3333333333333333ull);
+        s = ((s + (s >> 4u)) & 0x0F0F0F0F0F0F0F0Full) * 0x0101010101010101ull;
+
+        unsigned byte = 0;
+        while ( byte < 7 && ((s >> (byte * 8u)) & 0xFFu) <= k ) {
+            ++byte;
+        }
+
+        const unsigned before = byte > 0
+            ? static_cast<unsigned>((s >> ((byte - 1) * 8u)) & 0xFFu)
+            : 0u;
+
+        return byte * 8u + select_in_byte_table[(v >> (byte * 8u)) & 0xFFu][k - before];
+    }
+
+    inline std::uint64_t read_bits(
+        const std::uint64_t* words,
+        std::uint64_t bit,
+        unsigned width) noexcept
+    {
+        if ( width == 0 ) {
+            return 0;
+        }
+        const std::size_t index = static_cast<std::size_t>(bit >> 6u);
+        const unsigned shift = static_cast<unsigned>(bit & 63u);
+        std::uint64_t value = words[index] >> shift;
+        if ( shift + width > 64 ) {
+            value |= words[index + 1] << (64 - shift);
+        }
+        return value & low_mask64(width);
+    }
+
+    inline void write_bits(
+        std::uint64_t* words,
+        std::uint64_t bit,
+        unsigned width,
+        std::uint64_t value) noexcept
+    {
+        if ( width == 0 ) {
+            return;
+        }
+        const std::size_t index = static_cast<std::size_t>(bit >> 6u);
+        const unsigned shift = static_cast<unsigned>(bit & 63u);
+        words[index] |= value << shift;
+        if ( shift + width > 64 ) {
+            words[index + 1] |= value >> (64 - shift);
+        }
+    }
+}
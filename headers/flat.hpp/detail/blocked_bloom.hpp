@@ -0,0 +1,124 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "bit_utils.hpp"
+
+namespace flat_hpp::detail
+{
+    inline std::uint64_t mix64(std::uint64_t h) noexcept {
+        h ^= h >> 33u;
+        h *= 0xFF51AFD7ED558CCDull;
+        h ^= h >> 33u;
+        h *= 0xC4CEB9FE1A85EC53ull;
+        h ^= h >> 33u;
+        return h;
+    }
+
+    // bloom filter split into cache line sized blocks, every key
+    // sets all of its bits inside the single block it is hashed to
+    class blocked_bloom {
+    public:
+        static constexpr std::size_t block_words = 8;
+        static constexpr std::size_t block_bits = block_words * 64;
+    public:
+        blocked_bloom() = default;
+
+        blocked_bloom(std::size_t capacity, std::size_t bits_per_key)
+        : capacity_(capacity)
+        , hash_count_(static_cast<unsigned>(std::clamp<std::size_t>(bits_per_key * 69 / 100, 1, 16))) {
+            const std::size_t bits = std::max<std::size_t>(capacity * bits_per_key, 1);
+            words_.assign((bits + block_bits - 1) / block_bits * block_words, 0);
+        }
+
+        void add(std::uint64_t hash) noexcept {
+            std::uint64_t* block = block_(hash);
+            for ( unsigned i = 0; i < hash_count_; ++i ) {
+                const unsigned bit = bit_(hash, i);
+                block[bit / 64u] |= std::uint64_t{1} << (bit % 64u);
+            }
+            ++key_count_;
+        }
+
+        bool may_contain(std::uint64_t hash) const noexcept {
+            if ( words_.empty() ) {
+                return true;
+            }
+            const std::uint64_t* block = block_(hash);
+            for ( unsigned i = 0; i < hash_count_; ++i ) {
+                const unsigned bit = bit_(hash, i);
+                if ( ((block[bit / 64u] >> (bit % 64u)) & 1u) == 0 ) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        double false_positive_rate() const noexcept {
+            if ( words_.empty() ) {
+                return 1.0;
+            }
+            double rate = 0.0;
+            for ( std::size_t i = 0; i < words_.size(); i += block_words ) {
+                unsigned ones = 0;
+                for ( std::size_t j = 0; j < block_words; ++j ) {
+                    ones += popcount64(words_[i + j]);
+                }
+                rate += std::pow(static_cast<double>(ones) / block_bits, hash_count_);
+            }
+            return rate / static_cast<double>(words_.size() / block_words);
+        }
+
+        std::size_t capacity() const noexcept {
+            return capacity_;
+        }
+
+        std::size_t key_count() const noexcept {
+            return key_count_;
+        }
+
+        unsigned hash_count() const noexcept {
+            return hash_count_;
+        }
+
+        std::size_t memory_usage() const noexcept {
+            return words_.size() * sizeof(std::uint64_t);
+        }
+    private:
+        std::size_t block_index_(std::uint64_t hash) const noexcept {
+            const std::uint64_t block_count = words_.size() / block_words;
+            return static_cast<std::size_t>(((hash >> 32u) * block_count) >> 32u);
+        }
+
+        std::uint64_t* block_(std::uint64_t hash) noexcept {
+            return words_.data() + block_index_(hash) * block_words;
+        }
+
+        const std::uint64_t* block_(std::uint64_t hash) const noexcept {
+            return words_.data() + block_index_(hash) * block_words;
+        }
+
+        static unsigned bit_(std::uint64_t hash, unsigned index) noexcept {
+            // the high half picks the block, the bits inside it
+            // are generated from the low half by double hashing
+            const std::uint32_t h1 = static_cast<std::uint32_t>(hash);
+            const std::uint32_t h2 = static_cast<std::uint32_t>((hash * 0x9E3779B97F4A7C15ull) >> 32u) | 1u;
+            return static_cast<unsigned>((h1 + index * h2) % block_bits);
+        }
+    private:
+        std::vector<std::uint64_t> words_;
+        std::size_t capacity_ = 0;
+        std::size_t key_count_ = 0;
+        unsigned hash_count_ = 0;
+    };
+}
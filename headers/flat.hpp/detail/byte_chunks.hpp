@@ -0,0 +1,42 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace flat_hpp::detail
+{
+    template < typename Flat, typename = void >
+    struct is_contiguous
+    : std::is_pointer<typename Flat::const_iterator> {};
+
+    template < typename Flat >
+    struct is_contiguous<Flat, std::void_t<
+        decltype(std::declval<const typename Flat::container_type&>().data())
+    >> : std::true_type {};
+
+    template < typename Flat >
+    inline constexpr bool is_contiguous_v = is_contiguous<Flat>::value;
+
+    template < typename Flat, typename F >
+    void for_each_byte_chunk(const Flat& flat, F&& f) {
+        using value_type = typename Flat::value_type;
+        if constexpr ( is_contiguous_v<Flat> ) {
+            if ( !flat.empty() ) {
+                f(static_cast<const void*>(std::addressof(*flat.begin())),
+                    flat.size() * sizeof(value_type));
+            }
+        } else {
+            for ( const value_type& value : flat ) {
+                f(static_cast<const void*>(std::addressof(value)),
+                    sizeof(value_type));
+            }
+        }
+    }
+}
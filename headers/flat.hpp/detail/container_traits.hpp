@@ -0,0 +1,54 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace flat_hpp::detail
+{
+    template < typename Container, typename = void >
+    struct has_reserve : std::false_type {};
+
+    template < typename Container >
+    struct has_reserve<Container, std::void_t<
+        decltype(std::declval<Container&>().reserve(std::size_t{}))
+    >> : std::true_type {};
+
+    template < typename Container >
+    inline constexpr bool has_reserve_v = has_reserve<Container>::value;
+
+    template < typename Container, typename = void >
+    struct has_get_allocator : std::false_type {};
+
+    template < typename Container >
+    struct has_get_allocator<Container, std::void_t<
+        decltype(std::declval<const Container&>().get_allocator())
+    >> : std::true_type {};
+
+    template < typename Container >
+    inline constexpr bool has_get_allocator_v = has_get_allocator<Container>::value;
+
+    template < typename Container >
+    void reserve_if_possible(Container& container, std::size_t size) {
+        if constexpr ( has_reserve_v<Container> ) {
+            container.reserve(size);
+        }
+    }
+
+    // returns an empty container with the allocator of the flat container
+    template < typename Flat >
+    typename Flat::container_type empty_container_like(const Flat& flat) {
+        using container_type = typename Flat::container_type;
+        if constexpr ( has_get_allocator_v<Flat> ) {
+            return container_type(flat.get_allocator());
+        } else {
+            return container_type();
+        }
+    }
+}
@@ -0,0 +1,56 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "../flat_fwd.hpp"
+
+namespace flat_hpp::detail
+{
+    template < typename Policy >
+    struct is_duplicate_policy
+    : std::false_type {};
+
+    template <>
+    struct is_duplicate_policy<keep_first_t>
+    : std::true_type {};
+
+    template <>
+    struct is_duplicate_policy<keep_last_t>
+    : std::true_type {};
+
+    template < typename Combiner >
+    struct is_duplicate_policy<combine_t<Combiner>>
+    : std::true_type {};
+
+    template < typename Policy >
+    inline constexpr bool is_duplicate_policy_v = is_duplicate_policy<Policy>::value;
+
+    template < typename Policy >
+    struct is_combine_policy
+    : std::false_type {};
+
+    template < typename Combiner >
+    struct is_combine_policy<combine_t<Combiner>>
+    : std::true_type {};
+
+    template < typename Policy >
+    inline constexpr bool is_combine_policy_v = is_combine_policy<Policy>::value;
+
+    template < typename T >
+    void resolve_duplicate(keep_first_t, T&, T&&) {
+    }
+
+    template < typename T >
+    void resolve_duplicate(keep_last_t, T& old_value, T&& new_value) {
+        old_value = std::move(new_value);
+    }
+
+    template < typename Combiner, typename T >
+    void resolve_duplicate(combine_t<Combiner>& policy, T& old_value, T&& new_value) {
+        old_value = policy.combiner(std::move(old_value), std::move(new_value));
+    }
+}
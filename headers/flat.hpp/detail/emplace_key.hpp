@@ -0,0 +1,43 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+namespace flat_hpp::detail
+{
+    template < typename Key, typename... Args >
+    struct is_map_emplace_key
+    : std::false_type {};
+
+    template < typename Key, typename K, typename V >
+    struct is_map_emplace_key<Key, K, V>
+    : std::is_same<Key, K> {};
+
+    template < typename Key, typename K, typename V >
+    struct is_map_emplace_key<Key, std::pair<K, V>>
+    : std::is_same<Key, std::remove_const_t<K>> {};
+
+    template < typename Key, typename... Args >
+    inline constexpr bool is_map_emplace_key_v =
+        is_map_emplace_key<Key, std::decay_t<Args>...>::value;
+
+    template < typename K, typename V >
+    const K& map_emplace_key(const K& key, const V&) noexcept {
+        return key;
+    }
+
+    template < typename K, typename V >
+    const K& map_emplace_key(const std::pair<K, V>& pair) noexcept {
+        return pair.first;
+    }
+
+    template < typename Key, typename... Args >
+    inline constexpr bool is_set_emplace_key_v =
+        sizeof...(Args) == 1 && std::conjunction_v<std::is_same<Key, std::decay_t<Args>>...>;
+}
@@ -0,0 +1,76 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace flat_hpp::detail
+{
+    // prefix sums of counters with O(log n) updates and rank searches
+    class fenwick_tree {
+    public:
+        fenwick_tree() = default;
+
+        void assign(const std::vector<std::size_t>& counts) {
+            tree_.assign(counts.size() + 1, 0);
+            for ( std::size_t i = 1; i < tree_.size(); ++i ) {
+                tree_[i] += counts[i - 1];
+                const std::size_t parent = i + lowest_bit_(i);
+                if ( parent < tree_.size() ) {
+                    tree_[parent] += tree_[i];
+                }
+            }
+        }
+
+        std::size_t size() const
+        noexcept {
+            return tree_.empty() ? 0 : tree_.size() - 1;
+        }
+
+        // the unsigned wrap makes negative deltas work as expected
+        void add(std::size_t index, std::ptrdiff_t delta) noexcept {
+            for ( std::size_t i = index + 1; i < tree_.size(); i += lowest_bit_(i) ) {
+                tree_[i] += static_cast<std::size_t>(delta);
+            }
+        }
+
+        std::size_t prefix(std::size_t count) const
+        noexcept {
+            std::size_t sum = 0;
+            for ( std::size_t i = count; i > 0; i -= lowest_bit_(i) ) {
+                sum += tree_[i];
+            }
+            return sum;
+        }
+
+        // returns the first counter whose prefix sum exceeds the rank,
+        // and the rank minus the prefix sum of the counters before it
+        std::pair<std::size_t, std::size_t> search(std::size_t rank) const
+        noexcept {
+            std::size_t step = 1;
+            while ( step * 2 <= size() ) {
+                step *= 2;
+            }
+            std::size_t index = 0;
+            for ( ; step > 0 && size() > 0; step /= 2 ) {
+                if ( index + step <= size() && tree_[index + step] <= rank ) {
+                    index += step;
+                    rank -= tree_[index];
+                }
+            }
+            return {index, rank};
+        }
+    private:
+        static std::size_t lowest_bit_(std::size_t i) noexcept {
+            return i & (~i + 1);
+        }
+    private:
+        std::vector<std::size_t> tree_;
+    };
+}
@@ -0,0 +1,29 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace flat_hpp::detail
+{
+    class fnv1a_64 {
+    public:
+        void update(const void* data, std::size_t size) noexcept {
+            const unsigned char* bytes = static_cast<const unsigned char*>(data);
+            for ( std::size_t i = 0; i < size; ++i ) {
+                hash_ = (hash_ ^ bytes[i]) * 1099511628211ull;
+            }
+        }
+
+        std::uint64_t value() const noexcept {
+            return hash_;
+        }
+    private:
+        std::uint64_t hash_ = 14695981039346656037ull;
+    };
+}
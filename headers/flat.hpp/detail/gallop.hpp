@@ -0,0 +1,60 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+
+namespace flat_hpp::detail
+{
+    // finds the partition point of [first, last) by galloping outward
+    // from the hint, costs O(log d) where d is the distance to the answer
+    template < typename Iter, typename Pred >
+    Iter gallop_partition_point(Iter first, Iter last, Iter hint, Pred pred) {
+        using diff_t = typename std::iterator_traits<Iter>::difference_type;
+
+        if ( hint != last && pred(*hint) ) {
+            Iter prev = hint;
+            for ( diff_t step = 1; ; step *= 2 ) {
+                if ( last - prev <= step ) {
+                    return std::partition_point(prev + 1, last, pred);
+                }
+                const Iter next = prev + step;
+                if ( !pred(*next) ) {
+                    return std::partition_point(prev + 1, next, pred);
+                }
+                prev = next;
+            }
+        }
+
+        Iter next = hint;
+        for ( diff_t step = 1; ; step *= 2 ) {
+            if ( next - first <= step ) {
+                return std::partition_point(first, next, pred);
+            }
+            const Iter prev = next - step;
+            if ( pred(*prev) ) {
+                return std::partition_point(prev + 1, next, pred);
+            }
+            next = prev;
+        }
+    }
+
+    template < typename Iter, typename K, typename Compare >
+    Iter gallop_lower_bound(Iter first, Iter last, Iter hint, const K& key, const Compare& comp) {
+        return gallop_partition_point(first, last, hint, [&key, &comp](const auto& v){
+            return comp(v, key);
+        });
+    }
+
+    template < typename Iter, typename K, typename Compare >
+    Iter gallop_upper_bound(Iter first, Iter last, Iter hint, const K& key, const Compare& comp) {
+        return gallop_partition_point(first, last, hint, [&key, &comp](const auto& v){
+            return !comp(key, v);
+        });
+    }
+}
@@ -0,0 +1,112 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "gallop.hpp"
+
+namespace flat_hpp::detail
+{
+    template < typename T, typename = void >
+    struct is_interpolating
+    : std::false_type {};
+
+    template < typename T >
+    struct is_interpolating<T, std::void_t<typename T::is_interpolating>>
+    : std::true_type {};
+
+    template < typename T >
+    inline constexpr bool is_interpolating_v = is_interpolating<T>::value;
+
+    inline constexpr std::size_t interpolation_max_probes = 8;
+
+    template < typename T >
+    const auto& interpolation_key(const T& value) noexcept {
+        if constexpr ( std::is_arithmetic_v<T> ) {
+            return value;
+        } else {
+            return value.first;
+        }
+    }
+
+    // interpolates the answer from the keys at the ends of the range and
+    // shrinks the range with every probe, after a few probes without
+    // hitting the answer it falls back to the plain binary search
+    template < typename Iter, typename K, typename Pred >
+    Iter interpolation_partition_point(Iter first, Iter last, const K& key, Pred pred) {
+        using diff_t = typename std::iterator_traits<Iter>::difference_type;
+
+        if ( first == last || !pred(*first) ) {
+            return first;
+        }
+
+        if ( pred(*(last - 1)) ) {
+            return last;
+        }
+
+        // pred(*lo) is true and pred(*hi) is false, the answer is in (lo, hi]
+        Iter lo = first;
+        Iter hi = last - 1;
+
+        for ( std::size_t probe = 0; probe < interpolation_max_probes && hi - lo > 1; ++probe ) {
+            const double lo_key = static_cast<double>(interpolation_key(*lo));
+            const double hi_key = static_cast<double>(interpolation_key(*hi));
+            const double ratio = (static_cast<double>(key) - lo_key) / (hi_key - lo_key);
+
+            const diff_t size = hi - lo;
+            const diff_t offset = ratio > 0.0
+                ? static_cast<diff_t>(std::ceil(ratio * static_cast<double>(size)))
+                : 1;
+
+            const Iter iter = lo + std::clamp<diff_t>(offset, 1, size - 1);
+            if ( pred(*iter) ) {
+                lo = iter;
+            } else {
+                hi = iter;
+            }
+        }
+
+        return std::partition_point(lo + 1, hi, pred);
+    }
+
+    template < typename Iter, typename K, typename Compare >
+    Iter search_lower_bound(Iter first, Iter last, const K& key, const Compare& comp) {
+        if constexpr ( is_interpolating_v<Compare> && std::is_arithmetic_v<K> ) {
+            return interpolation_partition_point(first, last, key, [&key, &comp](const auto& v){
+                return comp(v, key);
+            });
+        } else {
+            return std::lower_bound(first, last, key, comp);
+        }
+    }
+
+    template < typename Iter, typename K, typename Compare >
+    Iter search_upper_bound(Iter first, Iter last, const K& key, const Compare& comp) {
+        if constexpr ( is_interpolating_v<Compare> && std::is_arithmetic_v<K> ) {
+            return interpolation_partition_point(first, last, key, [&key, &comp](const auto& v){
+                return !comp(key, v);
+            });
+        } else {
+            return std::upper_bound(first, last, key, comp);
+        }
+    }
+
+    template < typename Iter, typename K, typename Compare >
+    std::pair<Iter, Iter> search_equal_range(Iter first, Iter last, const K& key, const Compare& comp) {
+        if constexpr ( is_interpolating_v<Compare> && std::is_arithmetic_v<K> ) {
+            const Iter lower = search_lower_bound(first, last, key, comp);
+            return {lower, gallop_upper_bound(lower, last, lower, key, comp)};
+        } else {
+            return std::equal_range(first, last, key, comp);
+        }
+    }
+}
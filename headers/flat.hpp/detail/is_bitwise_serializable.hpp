@@ -0,0 +1,35 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+namespace flat_hpp::detail
+{
+    // the raw bytes of a value are written and checksummed, so a type with
+    // padding bytes would leak indeterminate bytes into the image; float and
+    // double have no padding, but no unique representations either
+    template < typename T >
+    struct is_bitwise_serializable
+    : std::bool_constant<
+        std::has_unique_object_representations_v<T> ||
+        std::is_same_v<T, float> ||
+        std::is_same_v<T, double>> {};
+
+    // std::pair has a user-provided assignment operator, but its
+    // object representation is still just the two members
+    template < typename T, typename U >
+    struct is_bitwise_serializable<std::pair<T, U>>
+    : std::bool_constant<
+        is_bitwise_serializable<T>::value &&
+        is_bitwise_serializable<U>::value &&
+        sizeof(std::pair<T, U>) == sizeof(T) + sizeof(U)> {};
+
+    template < typename T >
+    inline constexpr bool is_bitwise_serializable_v = is_bitwise_serializable<T>::value;
+}
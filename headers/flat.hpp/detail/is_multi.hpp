@@ -0,0 +1,27 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "../flat_fwd.hpp"
+
+namespace flat_hpp::detail
+{
+    template < typename Flat >
+    struct is_multi
+    : std::false_type {};
+
+    template < typename Key, typename Compare, typename Container >
+    struct is_multi<flat_multiset<Key, Compare, Container>>
+    : std::true_type {};
+
+    template < typename Key, typename Value, typename Compare, typename Container >
+    struct is_multi<flat_multimap<Key, Value, Compare, Container>>
+    : std::true_type {};
+
+    template < typename Flat >
+    inline constexpr bool is_multi_v = is_multi<Flat>::value;
+}
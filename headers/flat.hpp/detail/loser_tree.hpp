@@ -0,0 +1,126 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "is_sorted.hpp"
+
+namespace flat_hpp::detail
+{
+    // tournament tree over k sorted runs, equal elements are
+    // ordered by run index, so merging with it is stable
+    template < typename Iter, typename Compare >
+    class loser_tree {
+    public:
+        using reference = typename std::iterator_traits<Iter>::reference;
+    public:
+        loser_tree(std::vector<std::pair<Iter, Iter>> runs, const Compare& comp)
+        : runs_(std::move(runs))
+        , comp_(comp) {
+            const std::size_t k = runs_.size();
+            if ( k > 0 ) {
+                tree_.resize(k);
+                tree_[0] = build_(1);
+            }
+        }
+
+        bool empty() const {
+            return runs_.empty() || exhausted_(tree_[0]);
+        }
+
+        std::size_t top_run() const {
+            return tree_[0];
+        }
+
+        reference top() const {
+            return *runs_[tree_[0]].first;
+        }
+
+        void pop() {
+            std::size_t winner = tree_[0];
+            ++runs_[winner].first;
+            for ( std::size_t node = (winner + runs_.size()) / 2; node > 0; node /= 2 ) {
+                if ( before_(tree_[node], winner) ) {
+                    std::swap(tree_[node], winner);
+                }
+            }
+            tree_[0] = winner;
+        }
+    private:
+        bool exhausted_(std::size_t run) const {
+            return runs_[run].first == runs_[run].second;
+        }
+
+        bool before_(std::size_t l, std::size_t r) const {
+            if ( exhausted_(l) || exhausted_(r) ) {
+                return !exhausted_(l) || (exhausted_(r) && l < r);
+            }
+            if ( comp_(*runs_[l].first, *runs_[r].first) ) {
+                return true;
+            }
+            if ( comp_(*runs_[r].first, *runs_[l].first) ) {
+                return false;
+            }
+            return l < r;
+        }
+
+        std::size_t build_(std::size_t node) {
+            const std::size_t k = runs_.size();
+            if ( node >= k ) {
+                return node - k;
+            }
+            const std::size_t l = build_(node * 2);
+            const std::size_t r = build_(node * 2 + 1);
+            if ( before_(l, r) ) {
+                tree_[node] = r;
+                return l;
+            }
+            tree_[node] = l;
+            return r;
+        }
+    private:
+        std::vector<std::pair<Iter, Iter>> runs_;
+        std::vector<std::size_t> tree_;
+        Compare comp_;
+    };
+
+    template < typename Runs >
+    auto collect_runs(const Runs& runs) {
+        using iter_t = decltype(std::cbegin(*std::cbegin(runs)));
+        std::vector<std::pair<iter_t, iter_t>> result;
+        for ( const auto& run : runs ) {
+            result.emplace_back(std::cbegin(run), std::cend(run));
+        }
+        return result;
+    }
+
+    template < typename Iter, typename Compare >
+    bool runs_sorted(const std::vector<std::pair<Iter, Iter>>& runs, const Compare& comp) {
+        for ( const auto& run : runs ) {
+            if ( !detail::is_sorted(run.first, run.second, comp) ) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template < typename Iter, typename Compare, typename Out >
+    void kway_merge(std::vector<std::pair<Iter, Iter>> runs, const Compare& comp, bool unique, Out& out) {
+        assert(runs_sorted(runs, comp));
+        loser_tree<Iter, Compare> tree(std::move(runs), comp);
+        for ( ; !tree.empty(); tree.pop() ) {
+            if ( !unique || out.empty() || comp(out.back(), tree.top()) ) {
+                out.push_back(tree.top());
+            }
+        }
+    }
+}
@@ -0,0 +1,134 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace flat_hpp::detail
+{
+    struct pair_first_projection {
+        template < typename Pair >
+        constexpr auto& operator()(Pair& p) const noexcept {
+            return p.first;
+        }
+    };
+
+    struct pair_second_projection {
+        template < typename Pair >
+        constexpr auto& operator()(Pair& p) const noexcept {
+            return p.second;
+        }
+    };
+
+    template < typename Iter, typename Projection >
+    class projection_iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using reference = decltype(std::declval<const Projection&>()(*std::declval<Iter>()));
+        using value_type = std::remove_cv_t<std::remove_reference_t<reference>>;
+        using difference_type = typename std::iterator_traits<Iter>::difference_type;
+        using pointer = std::add_pointer_t<reference>;
+    public:
+        projection_iterator() = default;
+
+        explicit projection_iterator(Iter iter)
+        : iter_(iter) {}
+
+        template < typename OtherIter
+                 , typename = std::enable_if_t<std::is_convertible_v<OtherIter, Iter>> >
+        projection_iterator(const projection_iterator<OtherIter, Projection>& other)
+        : iter_(other.base()) {}
+
+        Iter base() const {
+            return iter_;
+        }
+
+        reference operator*() const {
+            return Projection()(*iter_);
+        }
+
+        pointer operator->() const {
+            return &Projection()(*iter_);
+        }
+
+        reference operator[](difference_type n) const {
+            return Projection()(iter_[n]);
+        }
+
+        projection_iterator& operator++() {
+            ++iter_;
+            return *this;
+        }
+
+        projection_iterator operator++(int) {
+            return projection_iterator(iter_++);
+        }
+
+        projection_iterator& operator--() {
+            --iter_;
+            return *this;
+        }
+
+        projection_iterator operator--(int) {
+            return projection_iterator(iter_--);
+        }
+
+        projection_iterator& operator+=(difference_type n) {
+            iter_ += n;
+            return *this;
+        }
+
+        projection_iterator& operator-=(difference_type n) {
+            iter_ -= n;
+            return *this;
+        }
+
+        friend projection_iterator operator+(projection_iterator l, difference_type n) {
+            return l += n;
+        }
+
+        friend projection_iterator operator+(difference_type n, projection_iterator r) {
+            return r += n;
+        }
+
+        friend projection_iterator operator-(projection_iterator l, difference_type n) {
+            return l -= n;
+        }
+
+        friend difference_type operator-(const projection_iterator& l, const projection_iterator& r) {
+            return l.iter_ - r.iter_;
+        }
+
+        friend bool operator==(const projection_iterator& l, const projection_iterator& r) {
+            return l.iter_ == r.iter_;
+        }
+
+        friend bool operator!=(const projection_iterator& l, const projection_iterator& r) {
+            return l.iter_ != r.iter_;
+        }
+
+        friend bool operator<(const projection_iterator& l, const projection_iterator& r) {
+            return l.iter_ < r.iter_;
+        }
+
+        friend bool operator>(const projection_iterator& l, const projection_iterator& r) {
+            return l.iter_ > r.iter_;
+        }
+
+        friend bool operator<=(const projection_iterator& l, const projection_iterator& r) {
+            return l.iter_ <= r.iter_;
+        }
+
+        friend bool operator>=(const projection_iterator& l, const projection_iterator& r) {
+            return l.iter_ >= r.iter_;
+        }
+    private:
+        Iter iter_ = Iter();
+    };
+}
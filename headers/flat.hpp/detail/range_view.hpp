@@ -0,0 +1,60 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+
+namespace flat_hpp::detail
+{
+    template < typename Iter >
+    class range_view {
+    public:
+        using iterator = Iter;
+        using reference = typename std::iterator_traits<Iter>::reference;
+        using value_type = typename std::iterator_traits<Iter>::value_type;
+        using difference_type = typename std::iterator_traits<Iter>::difference_type;
+        using size_type = std::size_t;
+    public:
+        range_view() = default;
+
+        range_view(Iter first, Iter last)
+        : first_(first)
+        , last_(last) {}
+
+        Iter begin() const {
+            return first_;
+        }
+
+        Iter end() const {
+            return last_;
+        }
+
+        bool empty() const {
+            return first_ == last_;
+        }
+
+        size_type size() const {
+            return static_cast<size_type>(last_ - first_);
+        }
+
+        reference front() const {
+            return *first_;
+        }
+
+        reference back() const {
+            return *(last_ - 1);
+        }
+
+        reference operator[](size_type index) const {
+            return first_[static_cast<difference_type>(index)];
+        }
+    private:
+        Iter first_ = Iter();
+        Iter last_ = Iter();
+    };
+}
@@ -0,0 +1,60 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+
+#include "fnv1a.hpp"
+
+namespace flat_hpp::detail
+{
+    class stream_writer {
+    public:
+        explicit stream_writer(std::ostream& os)
+        : os_(os) {}
+
+        void write(const void* data, std::size_t size) {
+            checksum_.update(data, size);
+            os_.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        }
+
+        std::uint64_t checksum() const noexcept {
+            return checksum_.value();
+        }
+    private:
+        std::ostream& os_;
+        fnv1a_64 checksum_;
+    };
+
+    class stream_reader {
+    public:
+        stream_reader(std::istream& is, bool with_checksum)
+        : is_(is)
+        , with_checksum_(with_checksum) {}
+
+        void read(void* data, std::size_t size) {
+            is_.read(static_cast<char*>(data), static_cast<std::streamsize>(size));
+            if ( static_cast<std::size_t>(is_.gcount()) != size ) {
+                throw std::runtime_error("flat_hpp::load: unexpected end of stream");
+            }
+            if ( with_checksum_ ) {
+                checksum_.update(data, size);
+            }
+        }
+
+        std::uint64_t checksum() const noexcept {
+            return checksum_.value();
+        }
+    private:
+        std::istream& is_;
+        bool with_checksum_ = false;
+        fnv1a_64 checksum_;
+    };
+}
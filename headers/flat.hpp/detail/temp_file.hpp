@@ -0,0 +1,52 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+
+namespace flat_hpp::detail
+{
+    // anonymous binary file which is removed automatically when closed,
+    // provides the same write/read interface as the stream helpers
+    class temp_file {
+    public:
+        temp_file()
+        : file_(std::tmpfile()) {
+            if ( !file_ ) {
+                throw std::runtime_error("flat_hpp::temp_file: failed to create a temporary file");
+            }
+        }
+
+        void write(const void* data, std::size_t size) {
+            if ( std::fwrite(data, 1, size, file_.get()) != size ) {
+                throw std::runtime_error("flat_hpp::temp_file: failed to write a temporary file");
+            }
+        }
+
+        void read(void* data, std::size_t size) {
+            if ( std::fread(data, 1, size, file_.get()) != size ) {
+                throw std::runtime_error("flat_hpp::temp_file: unexpected end of file");
+            }
+        }
+
+        void rewind() {
+            if ( std::fflush(file_.get()) != 0 || std::fseek(file_.get(), 0, SEEK_SET) != 0 ) {
+                throw std::runtime_error("flat_hpp::temp_file: failed to rewind a temporary file");
+            }
+        }
+    private:
+        struct closer {
+            void operator()(std::FILE* file) const noexcept {
+                std::fclose(file);
+            }
+        };
+    private:
+        std::unique_ptr<std::FILE, closer> file_;
+    };
+}
@@ -0,0 +1,366 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "flat_fwd.hpp"
+
+#include <cstdint>
+#include <iterator>
+
+#include "detail/bit_utils.hpp"
+
+namespace flat_hpp
+{
+    template < typename Key >
+    class elias_fano_set {
+        static_assert(
+            std::is_integral_v<Key> && std::is_unsigned_v<Key>,
+            "flat_hpp::elias_fano_set: Key must be an unsigned integral type");
+    public:
+        using key_type = Key;
+        using value_type = Key;
+
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        using key_compare = std::less<Key>;
+        using value_compare = std::less<Key>;
+
+        using reference = value_type;
+        using const_reference = value_type;
+
+        class const_iterator;
+        using iterator = const_iterator;
+
+        static constexpr size_type sample_step = 256;
+    public:
+        elias_fano_set() = default;
+        ~elias_fano_set() = default;
+
+        template < typename ForwardIter >
+        elias_fano_set(sorted_unique_range_t, ForwardIter first, ForwardIter last) {
+            from_range_(first, last);
+        }
+
+        template < typename Container >
+        explicit elias_fano_set(const flat_set<Key, std::less<Key>, Container>& set) {
+            from_range_(set.begin(), set.end());
+        }
+
+        elias_fano_set(elias_fano_set&& other) = default;
+        elias_fano_set(const elias_fano_set& other) = default;
+
+        elias_fano_set& operator=(elias_fano_set&& other) = default;
+        elias_fano_set& operator=(const elias_fano_set& other) = default;
+
+        const_iterator begin() const
+        noexcept {
+            return size_ > 0
+                ? const_iterator(this, 0, next_one_(0))
+                : end();
+        }
+
+        const_iterator cbegin() const
+        noexcept {
+            return begin();
+        }
+
+        const_iterator end() const
+        noexcept {
+            return const_iterator(this, size_, 0);
+        }
+
+        const_iterator cend() const
+        noexcept {
+            return end();
+        }
+
+        bool empty() const
+        noexcept {
+            return size_ == 0;
+        }
+
+        size_type size() const
+        noexcept {
+            return size_;
+        }
+
+        size_type memory_usage() const
+        noexcept {
+            return (lows_.size() + highs_.size() + ones_.size() + zeros_.size())
+                * sizeof(std::uint64_t);
+        }
+
+        void swap(elias_fano_set& other) noexcept {
+            using std::swap;
+            swap(lows_, other.lows_);
+            swap(highs_, other.highs_);
+            swap(ones_, other.ones_);
+            swap(zeros_, other.zeros_);
+            swap(size_, other.size_);
+            swap(low_width_, other.low_width_);
+            swap(max_, other.max_);
+        }
+
+        size_type count(Key key) const {
+            return contains(key) ? 1 : 0;
+        }
+
+        const_iterator find(Key key) const {
+            const const_iterator iter = next_geq(key);
+            return iter != end() && *iter == key
+                ? iter
+                : end();
+        }
+
+        bool contains(Key key) const {
+            return find(key) != end();
+        }
+
+        const_iterator next_geq(Key key) const {
+            if ( size_ == 0 || key > max_ ) {
+                return end();
+            }
+
+            // the two clear bits around the high bucket of the key bound
+            // its elements, their low bits are sorted and binary searched
+            const std::uint64_t high = static_cast<std::uint64_t>(key) >> low_width_;
+            const std::uint64_t bucket_first = high > 0
+                ? select0_(high - 1) + 1
+                : 0;
+            const std::uint64_t bucket_last = select0_(high);
+
+            const std::uint64_t low = key & detail::low_mask64(low_width_);
+            std::uint64_t first = bucket_first - high;
+            std::uint64_t count = bucket_last - bucket_first;
+            while ( count > 0 ) {
+                const std::uint64_t step = count / 2;
+                if ( low_(static_cast<size_type>(first + step)) < low ) {
+                    first += step + 1;
+                    count -= step + 1;
+                } else {
+                    count = step;
+                }
+            }
+
+            // past the bucket the answer is the first element of the next
+            // non-empty one, the key is not greater than max_ so it exists
+            return first < bucket_last - high
+                ? const_iterator(this, static_cast<size_type>(first), first + high)
+                : const_iterator(this, static_cast<size_type>(first), next_one_(bucket_last + 1));
+        }
+
+        size_type rank(Key key) const {
+            return next_geq(key).index();
+        }
+
+        Key select(size_type index) const {
+            assert(index < size_);
+            return value_(index, select1_(index));
+        }
+
+        key_compare key_comp() const {
+            return key_compare();
+        }
+
+        value_compare value_comp() const {
+            return value_compare();
+        }
+    private:
+        Key value_(size_type index, std::uint64_t pos) const noexcept {
+            const std::uint64_t high = pos - index;
+            return static_cast<Key>((high << low_width_) | low_(index));
+        }
+
+        std::uint64_t low_(size_type index) const noexcept {
+            return detail::read_bits(
+                lows_.data(), std::uint64_t{index} * low_width_, low_width_);
+        }
+
+        std::uint64_t next_one_(std::uint64_t pos) const noexcept {
+            std::size_t word = static_cast<std::size_t>(pos >> 6u);
+            std::uint64_t bits = highs_[word] & ~detail::low_mask64(static_cast<unsigned>(pos & 63u));
+            while ( bits == 0 ) {
+                bits = highs_[++word];
+            }
+            return std::uint64_t{word} * 64u + detail::select64(bits, 0);
+        }
+
+        template < bool Ones >
+        std::uint64_t select_(const std::vector<std::uint64_t>& samples, std::uint64_t rank) const noexcept {
+            const std::uint64_t pos = samples[static_cast<std::size_t>(rank / sample_step)];
+            std::uint64_t left = rank % sample_step;
+
+            std::size_t word = static_cast<std::size_t>(pos >> 6u);
+            std::uint64_t bits = (Ones ? highs_[word] : ~highs_[word])
+                & ~detail::low_mask64(static_cast<unsigned>(pos & 63u));
+
+            for ( unsigned count = detail::popcount64(bits); left >= count; count = detail::popcount64(bits) ) {
+                left -= count;
+                ++word;
+                bits = Ones ? highs_[word] : ~highs_[word];
+            }
+
+            return std::uint64_t{word} * 64u + detail::select64(bits, static_cast<unsigned>(left));
+        }
+
+        std::uint64_t select1_(std::uint64_t rank) const noexcept {
+            return select_<true>(ones_, rank);
+        }
+
+        std::uint64_t select0_(std::uint64_t rank) const noexcept {
+            return select_<false>(zeros_, rank);
+        }
+
+        template < typename ForwardIter >
+        void from_range_(ForwardIter first, ForwardIter last) {
+            assert(detail::is_sorted_unique(first, last, key_comp()));
+            size_ = static_cast<size_type>(std::distance(first, last));
+            if ( size_ == 0 ) {
+                return;
+            }
+
+            max_ = static_cast<Key>(*std::next(first, static_cast<difference_type>(size_ - 1)));
+            const std::uint64_t ratio = static_cast<std::uint64_t>(max_) / size_;
+            low_width_ = ratio > 1 ? detail::bit_width64(ratio) - 1 : 0;
+
+            // one set bit per element and one clear bit per high bucket,
+            // the extra word lets the scans read past the last bit safely
+            const std::uint64_t high_bits = size_ + (static_cast<std::uint64_t>(max_) >> low_width_) + 1;
+            lows_.resize(static_cast<std::size_t>((std::uint64_t{size_} * low_width_ + 63) / 64 + 1));
+            highs_.resize(static_cast<std::size_t>((high_bits + 63) / 64 + 1));
+
+            size_type index = 0;
+            for ( ; first != last; ++first, ++index ) {
+                const std::uint64_t key = static_cast<Key>(*first);
+                detail::write_bits(
+                    lows_.data(),
+                    std::uint64_t{index} * low_width_,
+                    low_width_,
+                    key & detail::low_mask64(low_width_));
+                const std::uint64_t pos = (key >> low_width_) + index;
+                highs_[static_cast<std::size_t>(pos >> 6u)] |= std::uint64_t{1} << (pos & 63u);
+            }
+
+            sample_(ones_, high_bits, [](std::uint64_t bits){ return bits; });
+            sample_(zeros_, high_bits, [](std::uint64_t bits){ return ~bits; });
+        }
+
+        template < typename Project >
+        void sample_(std::vector<std::uint64_t>& samples, std::uint64_t high_bits, Project project) {
+            std::uint64_t rank = 0;
+            std::uint64_t next = 0;
+            for ( std::uint64_t pos = 0; pos < high_bits; pos += 64 ) {
+                const std::uint64_t bits = project(highs_[static_cast<std::size_t>(pos >> 6u)])
+                    & detail::low_mask64(static_cast<unsigned>(std::min<std::uint64_t>(high_bits - pos, 64)));
+                const unsigned count = detail::popcount64(bits);
+                for ( ; next < rank + count; next += sample_step ) {
+                    samples.push_back(pos + detail::select64(bits, static_cast<unsigned>(next - rank)));
+                }
+                rank += count;
+            }
+        }
+    private:
+        std::vector<std::uint64_t> lows_;
+        std::vector<std::uint64_t> highs_;
+        std::vector<std::uint64_t> ones_;
+        std::vector<std::uint64_t> zeros_;
+        size_type size_ = 0;
+        unsigned low_width_ = 0;
+        Key max_ = Key();
+    };
+
+    // keys are decoded on the fly and returned by value, there is no key
+    // object to refer to, so the iterator is only an input iterator
+    template < typename Key >
+    class elias_fano_set<Key>::const_iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Key;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Key;
+    public:
+        const_iterator() = default;
+
+        reference operator*() const
+        noexcept {
+            return value_;
+        }
+
+        const_iterator& operator++() noexcept {
+            if ( ++index_ < set_->size_ ) {
+                pos_ = set_->next_one_(pos_ + 1);
+                value_ = set_->value_(index_, pos_);
+            }
+            return *this;
+        }
+
+        const_iterator operator++(int) noexcept {
+            const_iterator iter = *this;
+            ++*this;
+            return iter;
+        }
+
+        size_type index() const
+        noexcept {
+            return index_;
+        }
+
+        friend bool operator==(const const_iterator& l, const const_iterator& r) noexcept {
+            return l.index_ == r.index_;
+        }
+
+        friend bool operator!=(const const_iterator& l, const const_iterator& r) noexcept {
+            return !(l == r);
+        }
+    private:
+        friend class elias_fano_set;
+
+        const_iterator(const elias_fano_set* set, size_type index, std::uint64_t pos) noexcept
+        : set_(set)
+        , index_(index)
+        , pos_(pos) {
+            if ( index_ < set_->size_ ) {
+                value_ = set_->value_(index_, pos_);
+            }
+        }
+    private:
+        const elias_fano_set* set_ = nullptr;
+        size_type index_ = 0;
+        std::uint64_t pos_ = 0;
+        Key value_ = Key();
+    };
+}
+
+namespace flat_hpp
+{
+    template < typename Key >
+    void swap(
+        elias_fano_set<Key>& l,
+        elias_fano_set<Key>& r) noexcept
+    {
+        l.swap(r);
+    }
+
+    template < typename Key >
+    bool operator==(
+        const elias_fano_set<Key>& l,
+        const elias_fano_set<Key>& r)
+    {
+        return l.size() == r.size()
+            && std::equal(l.begin(), l.end(), r.begin());
+    }
+
+    template < typename Key >
+    bool operator!=(
+        const elias_fano_set<Key>& l,
+        const elias_fano_set<Key>& r)
+    {
+        return !(l == r);
+    }
+}
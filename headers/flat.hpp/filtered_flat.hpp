@@ -0,0 +1,205 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "flat_fwd.hpp"
+
+#include <cstdint>
+
+#include "detail/blocked_bloom.hpp"
+
+namespace flat_hpp
+{
+    struct filter_stats {
+        std::size_t memory_usage = 0;
+        std::size_t key_count = 0;
+        std::size_t stale_count = 0;
+        unsigned hash_count = 0;
+        double bits_per_key = 0.0;
+        double false_positive_rate = 0.0;
+    };
+
+    template < typename Flat
+             , typename Hash >
+    class filtered_flat {
+    public:
+        using flat_type = Flat;
+
+        using key_type = typename Flat::key_type;
+        using value_type = typename Flat::value_type;
+        using size_type = typename Flat::size_type;
+        using hasher = Hash;
+
+        using iterator = typename Flat::iterator;
+        using const_iterator = typename Flat::const_iterator;
+
+        static constexpr size_type default_bits_per_key = 10;
+    public:
+        filtered_flat() {
+            freeze();
+        }
+
+        explicit filtered_flat(Flat flat, size_type bits_per_key = default_bits_per_key, const Hash& hash = Hash())
+        : flat_(std::move(flat))
+        , hash_(hash)
+        , bits_per_key_(std::max<size_type>(bits_per_key, 1)) {
+            freeze();
+        }
+
+        const Flat& flat() const
+        noexcept {
+            return flat_;
+        }
+
+        Flat extract() && {
+            Flat flat = std::move(flat_);
+            flat_.clear();
+            freeze();
+            return flat;
+        }
+
+        const_iterator begin() const
+        noexcept {
+            return flat_.begin();
+        }
+
+        const_iterator cbegin() const
+        noexcept {
+            return flat_.cbegin();
+        }
+
+        const_iterator end() const
+        noexcept {
+            return flat_.end();
+        }
+
+        const_iterator cend() const
+        noexcept {
+            return flat_.cend();
+        }
+
+        bool empty() const
+        noexcept {
+            return flat_.empty();
+        }
+
+        size_type size() const
+        noexcept {
+            return flat_.size();
+        }
+
+        decltype(auto) insert(value_type&& value) {
+            const std::uint64_t hash = hash_key_(key_of_(value));
+            const size_type old_size = flat_.size();
+            decltype(auto) result = flat_.insert(std::move(value));
+            if ( flat_.size() != old_size ) {
+                add_(hash);
+            }
+            return result;
+        }
+
+        decltype(auto) insert(const value_type& value) {
+            return insert(value_type(value));
+        }
+
+        template < typename InputIter >
+        void insert(InputIter first, InputIter last) {
+            flat_.insert(first, last);
+            freeze();
+        }
+
+        size_type erase(const key_type& key) {
+            const size_type count = flat_.erase(key);
+            stale_count_ += count;
+            return count;
+        }
+
+        void clear() noexcept {
+            flat_.clear();
+            filter_ = detail::blocked_bloom();
+            stale_count_ = 0;
+        }
+
+        void freeze() {
+            rebuild_(flat_.size());
+        }
+
+        size_type count(const key_type& key) const {
+            return may_contain_(key) ? flat_.count(key) : 0;
+        }
+
+        iterator find(const key_type& key) {
+            return may_contain_(key) ? flat_.find(key) : flat_.end();
+        }
+
+        const_iterator find(const key_type& key) const {
+            return may_contain_(key) ? flat_.find(key) : flat_.end();
+        }
+
+        bool contains(const key_type& key) const {
+            return may_contain_(key) && flat_.contains(key);
+        }
+
+        filter_stats stats() const {
+            filter_stats stats;
+            stats.memory_usage = filter_.memory_usage();
+            stats.key_count = filter_.key_count();
+            stats.stale_count = stale_count_;
+            stats.hash_count = filter_.hash_count();
+            stats.bits_per_key = filter_.key_count() > 0
+                ? static_cast<double>(filter_.memory_usage() * 8) / static_cast<double>(filter_.key_count())
+                : 0.0;
+            stats.false_positive_rate = filter_.false_positive_rate();
+            return stats;
+        }
+
+        hasher hash_function() const {
+            return hash_;
+        }
+    private:
+        static const key_type& key_of_(const value_type& value) noexcept {
+            if constexpr ( std::is_same_v<key_type, value_type> ) {
+                return value;
+            } else {
+                return value.first;
+            }
+        }
+
+        std::uint64_t hash_key_(const key_type& key) const {
+            return detail::mix64(static_cast<std::uint64_t>(hash_(key)));
+        }
+
+        bool may_contain_(const key_type& key) const {
+            return filter_.may_contain(hash_key_(key));
+        }
+
+        void add_(std::uint64_t hash) {
+            // a filter filled over its capacity loses precision quickly,
+            // so it is rebuilt with twice the room, amortized O(1) per key
+            if ( filter_.key_count() >= filter_.capacity() ) {
+                rebuild_(flat_.size() * 2);
+            } else {
+                filter_.add(hash);
+            }
+        }
+
+        void rebuild_(size_type capacity) {
+            detail::blocked_bloom filter(std::max<size_type>(capacity, 64), bits_per_key_);
+            for ( const value_type& value : flat_ ) {
+                filter.add(hash_key_(key_of_(value)));
+            }
+            filter_ = std::move(filter);
+            stale_count_ = 0;
+        }
+    private:
+        Flat flat_;
+        Hash hash_;
+        size_type bits_per_key_ = default_bits_per_key;
+        size_type stale_count_ = 0;
+        detail::blocked_bloom filter_;
+    };
+}
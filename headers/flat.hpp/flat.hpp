@@ -4,7 +4,26 @@
  * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
  ******************************************************************************/
 
+#include "chunked_flat_map.hpp"
+#include "compressed_flat_set.hpp"
+#include "elias_fano_set.hpp"
+#include "filtered_flat.hpp"
+#include "flat_cursor.hpp"
+#include "flat_diff.hpp"
+#include "flat_image.hpp"
+#include "flat_join.hpp"
 #include "flat_map.hpp"
+#include "flat_map_builder.hpp"
+#include "flat_map_view.hpp"
+#include "flat_merge.hpp"
 #include "flat_multimap.hpp"
 #include "flat_multiset.hpp"
+#include "flat_serialize.hpp"
 #include "flat_set.hpp"
+#include "flat_set_view.hpp"
+#include "gap_vector.hpp"
+#include "learned_index.hpp"
+#include "merged_view.hpp"
+#include "packed_memory_array.hpp"
+#include "persistent_flat_map.hpp"
+#include "radix_flat.hpp"
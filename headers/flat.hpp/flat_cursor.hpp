@@ -0,0 +1,65 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "flat_fwd.hpp"
+
+namespace flat_hpp
+{
+    template < typename Flat >
+    class flat_cursor {
+    public:
+        using flat_type = Flat;
+        using size_type = typename Flat::size_type;
+        using iterator = decltype(std::declval<Flat&>().begin());
+    public:
+        explicit flat_cursor(Flat& flat) noexcept
+        : flat_(&flat) {}
+
+        template < typename K >
+        iterator lower_bound(const K& key) {
+            const iterator iter = flat_->lower_bound(hint_(), key);
+            index_ = static_cast<size_type>(iter - flat_->begin());
+            return iter;
+        }
+
+        template < typename K >
+        iterator find(const K& key) {
+            const iterator iter = flat_->find(hint_(), key);
+            if ( iter != flat_->end() ) {
+                index_ = static_cast<size_type>(iter - flat_->begin());
+            }
+            return iter;
+        }
+
+        template < typename K >
+        bool contains(const K& key) {
+            return find(key) != flat_->end();
+        }
+
+        iterator position() const {
+            return flat_->begin() + static_cast<typename Flat::difference_type>(clamped_index_());
+        }
+
+        void reset() noexcept {
+            index_ = 0;
+        }
+    private:
+        // the container may shrink between lookups, so the remembered
+        // position is kept as an index and clamped on every use
+        size_type clamped_index_() const noexcept {
+            return std::min(index_, flat_->size());
+        }
+
+        typename Flat::const_iterator hint_() const noexcept {
+            return flat_->cbegin() + static_cast<typename Flat::difference_type>(clamped_index_());
+        }
+    private:
+        Flat* flat_ = nullptr;
+        size_type index_ = 0;
+    };
+}
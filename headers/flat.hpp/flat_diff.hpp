@@ -0,0 +1,189 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "flat_fwd.hpp"
+
+#include "detail/container_traits.hpp"
+#include "detail/is_multi.hpp"
+
+namespace flat_hpp::detail
+{
+    template < typename Flat >
+    const typename Flat::key_type& flat_key_of(const typename Flat::value_type& value) noexcept {
+        if constexpr ( std::is_same_v<typename Flat::key_type, typename Flat::value_type> ) {
+            return value;
+        } else {
+            return value.first;
+        }
+    }
+}
+
+namespace flat_hpp
+{
+    // reports the elements only in the old container, the elements only in
+    // the new one and the equivalent elements which differ, in key order
+    template < typename Flat
+             , typename OnAdded
+             , typename OnRemoved
+             , typename OnChanged >
+    void diff(
+        const Flat& from,
+        const Flat& to,
+        OnAdded&& on_added,
+        OnRemoved&& on_removed,
+        OnChanged&& on_changed)
+    {
+        static_assert(
+            !detail::is_multi_v<Flat>,
+            "flat_hpp::diff: keys must be unique");
+
+        const auto comp = from.value_comp();
+        auto from_iter = from.begin();
+        auto to_iter = to.begin();
+
+        // runs of elements only on one side are skipped by galloping,
+        // so a small diff of big containers costs O(k log(n/k)) comparisons
+        while ( from_iter != from.end() && to_iter != to.end() ) {
+            if ( comp(*from_iter, *to_iter) ) {
+                const auto last = detail::gallop_lower_bound(
+                    from_iter, from.end(), from_iter, *to_iter, comp);
+                for ( ; from_iter != last; ++from_iter ) {
+                    on_removed(*from_iter);
+                }
+            } else if ( comp(*to_iter, *from_iter) ) {
+                const auto last = detail::gallop_lower_bound(
+                    to_iter, to.end(), to_iter, *from_iter, comp);
+                for ( ; to_iter != last; ++to_iter ) {
+                    on_added(*to_iter);
+                }
+            } else {
+                if ( !(*from_iter == *to_iter) ) {
+                    on_changed(*from_iter, *to_iter);
+                }
+                ++from_iter;
+                ++to_iter;
+            }
+        }
+
+        for ( ; from_iter != from.end(); ++from_iter ) {
+            on_removed(*from_iter);
+        }
+
+        for ( ; to_iter != to.end(); ++to_iter ) {
+            on_added(*to_iter);
+        }
+    }
+
+    template < typename Flat >
+    class flat_patch {
+    public:
+        using flat_type = Flat;
+
+        using key_type = typename Flat::key_type;
+        using value_type = typename Flat::value_type;
+        using size_type = typename Flat::size_type;
+
+        static_assert(
+            !detail::is_multi_v<Flat>,
+            "flat_hpp::flat_patch: keys must be unique");
+    public:
+        flat_patch() = default;
+
+        // both ranges must be sorted by the key order of the container
+        flat_patch(std::vector<value_type> upserts, std::vector<key_type> erasures)
+        : upserts_(std::move(upserts))
+        , erasures_(std::move(erasures)) {}
+
+        const std::vector<value_type>& upserts() const
+        noexcept {
+            return upserts_;
+        }
+
+        const std::vector<key_type>& erasures() const
+        noexcept {
+            return erasures_;
+        }
+
+        bool empty() const
+        noexcept {
+            return upserts_.empty() && erasures_.empty();
+        }
+
+        size_type size() const
+        noexcept {
+            return upserts_.size() + erasures_.size();
+        }
+
+        // inserts or replaces the upserted elements and erases the erased keys
+        // in a single pass, untouched runs are found by galloping and copied,
+        // the container is replaced only when the result is fully built
+        void apply(Flat& flat) const {
+            const auto key_comp = flat.key_comp();
+            const auto comp = [&key_comp](const value_type& l, const key_type& r){
+                return key_comp(detail::flat_key_of<Flat>(l), r);
+            };
+
+            typename Flat::container_type result = detail::empty_container_like(flat);
+            detail::reserve_if_possible(result, flat.size() + upserts_.size());
+
+            auto iter = flat.cbegin();
+            auto upsert_iter = upserts_.begin();
+            auto erasure_iter = erasures_.begin();
+
+            while ( upsert_iter != upserts_.end() || erasure_iter != erasures_.end() ) {
+                const bool upsert = erasure_iter == erasures_.end()
+                    || (upsert_iter != upserts_.end()
+                        && !key_comp(*erasure_iter, detail::flat_key_of<Flat>(*upsert_iter)));
+                const key_type& key = upsert
+                    ? detail::flat_key_of<Flat>(*upsert_iter)
+                    : *erasure_iter;
+
+                const auto last = detail::gallop_lower_bound(iter, flat.cend(), iter, key, comp);
+                result.insert(result.end(), iter, last);
+                iter = last;
+
+                if ( iter != flat.cend() && !key_comp(key, detail::flat_key_of<Flat>(*iter)) ) {
+                    ++iter;
+                }
+
+                if ( upsert ) {
+                    result.push_back(*upsert_iter++);
+                } else {
+                    ++erasure_iter;
+                }
+            }
+
+            result.insert(result.end(), iter, flat.cend());
+            flat.replace(std::move(result));
+        }
+    private:
+        std::vector<value_type> upserts_;
+        std::vector<key_type> erasures_;
+    };
+
+    // builds a patch which turns the old container into the new one
+    template < typename Flat >
+    flat_patch<Flat> make_patch(const Flat& from, const Flat& to) {
+        using key_type = typename Flat::key_type;
+        using value_type = typename Flat::value_type;
+
+        std::vector<value_type> upserts;
+        std::vector<key_type> erasures;
+        diff(from, to,
+            [&upserts](const value_type& value){
+                upserts.push_back(value);
+            },
+            [&erasures](const value_type& value){
+                erasures.push_back(detail::flat_key_of<Flat>(value));
+            },
+            [&upserts](const value_type&, const value_type& value){
+                upserts.push_back(value);
+            });
+        return flat_patch<Flat>(std::move(upserts), std::move(erasures));
+    }
+}
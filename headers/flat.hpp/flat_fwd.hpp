@@ -11,16 +11,29 @@
 #include <functional>
 #include <initializer_list>
 #include <stdexcept>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
+#if __has_include(<memory_resource>)
+#  include <memory_resource>
+#  define FLAT_HPP_HAS_MEMORY_RESOURCE
+#endif
+
+#include "detail/container_traits.hpp"
+#include "detail/emplace_key.hpp"
 #include "detail/eq_compare.hpp"
+#include "detail/gallop.hpp"
+#include "detail/interpolation_search.hpp"
 #include "detail/is_allocator.hpp"
 #include "detail/is_sorted.hpp"
 #include "detail/is_transparent.hpp"
 #include "detail/iter_traits.hpp"
+#include "detail/loser_tree.hpp"
 #include "detail/pair_compare.hpp"
+#include "detail/projection_iterator.hpp"
+#include "detail/range_view.hpp"
 
 namespace flat_hpp
 {
@@ -30,6 +43,34 @@ namespace flat_hpp
     struct sorted_unique_range_t : public sorted_range_t {};
     inline constexpr sorted_unique_range_t sorted_unique_range = sorted_unique_range_t();
 
+    struct keep_first_t {};
+    inline constexpr keep_first_t keep_first = keep_first_t();
+
+    struct keep_last_t {};
+    inline constexpr keep_last_t keep_last = keep_last_t();
+
+    template < typename Combiner >
+    struct combine_t {
+        Combiner combiner;
+    };
+
+    template < typename Combiner >
+    combine_t<Combiner> combine(Combiner combiner) {
+        return {std::move(combiner)};
+    }
+
+    struct no_tombstone {
+        template < typename T >
+        bool operator()(const T&) const noexcept {
+            return false;
+        }
+    };
+
+    template < typename Key = void >
+    struct interpolation_less : std::less<Key> {
+        using is_interpolating = void;
+    };
+
     template < typename Key
              , typename Compare = std::less<Key>
              , typename Container = std::vector<Key> >
@@ -51,4 +92,95 @@ namespace flat_hpp
              , typename Compare = std::less<Key>
              , typename Container = std::vector<std::pair<Key, Value>> >
     class flat_multimap;
+
+    template < typename Key
+             , typename Compare = std::less<Key> >
+    class flat_set_view;
+
+    template < typename Key
+             , typename Value
+             , typename Compare = std::less<Key> >
+    class flat_map_view;
+
+    template < typename Key
+             , std::size_t BlockSize = 128 >
+    class compressed_flat_set;
+
+    template < typename Key >
+    class elias_fano_set;
+
+    template < typename Key
+             , typename Value
+             , typename Compare = std::less<Key>
+             , std::size_t ChunkSize = 1024 >
+    class chunked_flat_map;
+
+    template < typename Key
+             , typename Value
+             , typename Compare = std::less<Key>
+             , std::size_t ChunkSize = 256 >
+    class persistent_flat_map;
+
+    template < typename Flat >
+    class flat_cursor;
+
+    template < typename Flat >
+    class flat_patch;
+
+    template < typename Flat
+             , typename Tombstone = no_tombstone >
+    class merged_view;
+
+    template < typename Flat
+             , typename Hash = std::hash<typename Flat::key_type> >
+    class filtered_flat;
+
+    template < typename Flat >
+    class learned_index;
+
+    template < typename Flat
+             , unsigned Bits = 8 >
+    class radix_flat;
+
+    template < typename Key
+             , typename Value
+             , typename Compare = std::less<Key>
+             , typename Container = std::vector<std::pair<Key, Value>> >
+    class flat_map_builder;
+
+    template < typename T
+             , typename Allocator = std::allocator<T> >
+    class gap_vector;
+
+    template < typename T
+             , typename Allocator = std::allocator<T>
+             , std::size_t SegmentSize = 64 >
+    class packed_memory_array;
+}
+
+#ifdef FLAT_HPP_HAS_MEMORY_RESOURCE
+namespace flat_hpp::pmr
+{
+    template < typename Key
+             , typename Compare = std::less<Key> >
+    using flat_set = flat_hpp::flat_set<Key, Compare,
+        std::pmr::vector<Key>>;
+
+    template < typename Key
+             , typename Compare = std::less<Key> >
+    using flat_multiset = flat_hpp::flat_multiset<Key, Compare,
+        std::pmr::vector<Key>>;
+
+    template < typename Key
+             , typename Value
+             , typename Compare = std::less<Key> >
+    using flat_map = flat_hpp::flat_map<Key, Value, Compare,
+        std::pmr::vector<std::pair<Key, Value>>>;
+
+    template < typename Key
+             , typename Value
+             , typename Compare = std::less<Key> >
+    using flat_multimap = flat_hpp::flat_multimap<Key, Value, Compare,
+        std::pmr::vector<std::pair<Key, Value>>>;
 }
+#endif
@@ -0,0 +1,203 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "flat_fwd.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+
+#include "detail/byte_chunks.hpp"
+#include "detail/fnv1a.hpp"
+#include "detail/is_bitwise_serializable.hpp"
+#include "detail/is_multi.hpp"
+
+namespace flat_hpp
+{
+    // 0 means an unknown order, images are written and read only with
+    // a known one, so a custom comparator has to specialize this trait
+    template < typename Compare >
+    struct image_compare_tag
+    : std::integral_constant<std::uint64_t, 0> {};
+
+    template < typename T >
+    struct image_compare_tag<std::less<T>>
+    : std::integral_constant<std::uint64_t, 1> {};
+
+    template < typename Key >
+    struct image_compare_tag<interpolation_less<Key>>
+    : std::integral_constant<std::uint64_t, 1> {};
+
+    template < typename T >
+    struct image_compare_tag<std::greater<T>>
+    : std::integral_constant<std::uint64_t, 2> {};
+
+    struct image_header {
+        std::array<char, 8> magic;
+        std::uint32_t version;
+        std::uint32_t flags;
+        std::uint64_t byte_order;
+        std::uint64_t element_size;
+        std::uint64_t element_count;
+        std::uint64_t compare_tag;
+        std::uint64_t checksum;
+        std::uint64_t key_kind;
+    };
+
+    static_assert(sizeof(image_header) == 64);
+    static_assert(std::is_trivially_copyable_v<image_header>);
+
+    inline constexpr std::array<char, 8> image_magic{{'f','l','a','t','.','h','p','p'}};
+    inline constexpr std::uint32_t image_version = 3;
+
+    // written in the native byte order, reads back
+    // byte-swapped on a machine with the other one
+    inline constexpr std::uint64_t image_byte_order = 0x0102030405060708;
+
+    inline constexpr std::uint32_t image_flag_unique = 1u << 0;
+    inline constexpr std::uint32_t image_flag_streamed = 1u << 1;
+}
+
+namespace flat_hpp::detail
+{
+    template < typename Compare >
+    constexpr std::uint64_t image_compare_tag_of() noexcept {
+        static_assert(
+            image_compare_tag<Compare>::value != 0,
+            "flat_hpp::image_compare_tag: the order of key_compare is unknown, specialize image_compare_tag for it");
+        return image_compare_tag<Compare>::value;
+    }
+
+    // the kind of the key type in the high half and its size in the low one,
+    // so an image of int32_t keys is not read as an image of float keys
+    template < typename Key >
+    constexpr std::uint64_t image_key_kind_of() noexcept {
+        const std::uint64_t kind =
+            std::is_floating_point_v<Key> ? 3 :
+            std::is_enum_v<Key> ? 4 :
+            std::is_signed_v<Key> ? 1 :
+            std::is_unsigned_v<Key> ? 2 : 5;
+        return (kind << 32) | sizeof(Key);
+    }
+
+    template < typename Flat >
+    image_header make_image_header(std::uint64_t element_count, std::uint32_t flags, std::uint64_t checksum) {
+        image_header header{};
+        header.magic = image_magic;
+        header.version = image_version;
+        header.byte_order = image_byte_order;
+        header.flags = flags | (is_multi_v<Flat> ? 0 : image_flag_unique);
+        header.element_size = sizeof(typename Flat::value_type);
+        header.element_count = element_count;
+        header.compare_tag = image_compare_tag_of<typename Flat::key_compare>();
+        header.checksum = checksum;
+        header.key_kind = image_key_kind_of<typename Flat::key_type>();
+        return header;
+    }
+
+    template < typename Flat >
+    image_header make_image_header(const Flat& flat, std::uint32_t flags, std::uint64_t checksum) {
+        return make_image_header<Flat>(flat.size(), flags, checksum);
+    }
+}
+
+namespace flat_hpp
+{
+    template < typename Flat >
+    void write_image(std::ostream& os, const Flat& flat) {
+        using value_type = typename Flat::value_type;
+
+        static_assert(
+            detail::is_bitwise_serializable_v<value_type>,
+            "flat_hpp::write_image: value_type must be bitwise serializable");
+
+        detail::fnv1a_64 checksum;
+        detail::for_each_byte_chunk(flat, [&checksum](const void* data, std::size_t size){
+            checksum.update(data, size);
+        });
+
+        const image_header header = detail::make_image_header(
+            flat, 0, checksum.value());
+
+        os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        detail::for_each_byte_chunk(flat, [&os](const void* data, std::size_t size){
+            os.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        });
+    }
+
+    template < typename View >
+    View image_view(const void* image, std::size_t size, bool verify_checksum = false) {
+        using value_type = typename View::value_type;
+        using key_compare = typename View::key_compare;
+
+        static_assert(
+            detail::is_bitwise_serializable_v<value_type>,
+            "flat_hpp::image_view: value_type must be bitwise serializable");
+
+        if ( size < sizeof(image_header) ) {
+            throw std::invalid_argument("flat_hpp::image_view: image is too small");
+        }
+
+        image_header header{};
+        std::memcpy(&header, image, sizeof(header));
+
+        if ( header.magic != image_magic ) {
+            throw std::invalid_argument("flat_hpp::image_view: unknown image format");
+        }
+
+        if ( header.byte_order != image_byte_order ) {
+            throw std::invalid_argument("flat_hpp::image_view: byte order mismatch");
+        }
+
+        if ( header.version != image_version ) {
+            throw std::invalid_argument("flat_hpp::image_view: unknown image format");
+        }
+
+        if ( (header.flags & image_flag_streamed) != 0 ) {
+            throw std::invalid_argument("flat_hpp::image_view: image is not bitwise");
+        }
+
+        if ( (header.flags & image_flag_unique) == 0 ) {
+            throw std::invalid_argument("flat_hpp::image_view: image is not sorted unique");
+        }
+
+        if ( header.element_size != sizeof(value_type) ) {
+            throw std::invalid_argument("flat_hpp::image_view: element size mismatch");
+        }
+
+        if ( header.compare_tag != detail::image_compare_tag_of<key_compare>() ) {
+            throw std::invalid_argument("flat_hpp::image_view: compare tag mismatch");
+        }
+
+        if ( header.key_kind != detail::image_key_kind_of<typename View::key_type>() ) {
+            throw std::invalid_argument("flat_hpp::image_view: key type mismatch");
+        }
+
+        const std::size_t payload_size = size - sizeof(image_header);
+        if ( header.element_count > payload_size / sizeof(value_type) ) {
+            throw std::invalid_argument("flat_hpp::image_view: image is truncated");
+        }
+
+        const void* payload = static_cast<const char*>(image) + sizeof(image_header);
+        if ( reinterpret_cast<std::uintptr_t>(payload) % alignof(value_type) != 0 ) {
+            throw std::invalid_argument("flat_hpp::image_view: image is misaligned");
+        }
+
+        const std::size_t count = static_cast<std::size_t>(header.element_count);
+        if ( verify_checksum ) {
+            detail::fnv1a_64 checksum;
+            checksum.update(payload, count * sizeof(value_type));
+            if ( checksum.value() != header.checksum ) {
+                throw std::invalid_argument("flat_hpp::image_view: checksum mismatch");
+            }
+        }
+
+        return View(sorted_unique_range, static_cast<const value_type*>(payload), count);
+    }
+}
@@ -0,0 +1,212 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "flat_fwd.hpp"
+
+#include "detail/is_multi.hpp"
+
+namespace flat_hpp::detail
+{
+    template < typename Key, typename T >
+    const Key& join_key_of(const T& value) noexcept {
+        if constexpr ( std::is_same_v<T, Key> ) {
+            return value;
+        } else {
+            return value.first;
+        }
+    }
+
+    // compares keys, set elements and map elements of
+    // containers with the same key type by their keys
+    template < typename Key, typename Compare >
+    class join_compare {
+    public:
+        explicit join_compare(Compare compare)
+        : compare_(std::move(compare)) {}
+
+        template < typename L, typename R >
+        bool operator()(const L& l, const R& r) const {
+            return compare_(join_key_of<Key>(l), join_key_of<Key>(r));
+        }
+    private:
+        Compare compare_;
+    };
+
+    template < typename FlatA, typename FlatB >
+    auto make_join_compare(const FlatA& a, const FlatB&) {
+        static_assert(
+            std::is_same_v<typename FlatA::key_type, typename FlatB::key_type> &&
+            std::is_same_v<typename FlatA::key_compare, typename FlatB::key_compare>,
+            "flat_hpp::join: containers must have the same key_type and key_compare");
+        using key_type = typename FlatA::key_type;
+        using key_compare = typename FlatA::key_compare;
+        return join_compare<key_type, key_compare>(a.key_comp());
+    }
+
+    // a leapfrog merge over two sorted ranges, every side gallops to the
+    // current key of the other one, so skewed sizes cost O(k log(n/k));
+    // on_left and on_right get the unmatched runs, on_match the equal ones
+    template < typename IterA, typename IterB, typename Compare
+             , typename OnLeft, typename OnRight, typename OnMatch >
+    void leapfrog_join(
+        IterA a_first, IterA a_last,
+        IterB b_first, IterB b_last,
+        const Compare& comp,
+        OnLeft&& on_left, OnRight&& on_right, OnMatch&& on_match)
+    {
+        while ( a_first != a_last && b_first != b_last ) {
+            if ( comp(*a_first, *b_first) ) {
+                const IterA next = gallop_lower_bound(a_first, a_last, a_first, *b_first, comp);
+                on_left(a_first, next);
+                a_first = next;
+            } else if ( comp(*b_first, *a_first) ) {
+                const IterB next = gallop_lower_bound(b_first, b_last, b_first, *a_first, comp);
+                on_right(b_first, next);
+                b_first = next;
+            } else {
+                const IterA a_next = gallop_upper_bound(a_first, a_last, a_first, *b_first, comp);
+                const IterB b_next = gallop_upper_bound(b_first, b_last, b_first, *a_first, comp);
+                on_match(a_first, a_next, b_first, b_next);
+                a_first = a_next;
+                b_first = b_next;
+            }
+        }
+        if ( a_first != a_last ) {
+            on_left(a_first, a_last);
+        }
+        if ( b_first != b_last ) {
+            on_right(b_first, b_last);
+        }
+    }
+
+    // the multi-way leapfrog: the largest current key is the next candidate
+    // and every container gallops to it, until all of them agree on a key
+    template < typename Key, typename Callback, typename Compare, std::size_t... Is, typename... Flats >
+    void multi_join_impl(
+        Callback& callback,
+        const Compare& comp,
+        std::index_sequence<Is...>,
+        const Flats&... flats)
+    {
+        auto iters = std::make_tuple(flats.begin()...);
+        while ( ((std::get<Is>(iters) != flats.end()) && ...) ) {
+            const Key* key = &join_key_of<Key>(*std::get<0>(iters));
+            ((key = comp(*key, *std::get<Is>(iters))
+                ? &join_key_of<Key>(*std::get<Is>(iters))
+                : key), ...);
+
+            ((std::get<Is>(iters) = gallop_lower_bound(
+                std::get<Is>(iters), flats.end(), std::get<Is>(iters), *key, comp)), ...);
+
+            if ( ((std::get<Is>(iters) == flats.end()) || ...) ) {
+                return;
+            }
+
+            if ( (!comp(*key, *std::get<Is>(iters)) && ...) ) {
+                callback(*std::get<Is>(iters)...);
+                (++std::get<Is>(iters), ...);
+            }
+        }
+    }
+}
+
+namespace flat_hpp
+{
+    // calls callback(a_value, b_value) for every pair of elements with
+    // equivalent keys, multi containers produce all the pairs of their runs
+    template < typename FlatA, typename FlatB, typename Callback >
+    void join(const FlatA& a, const FlatB& b, Callback&& callback) {
+        detail::leapfrog_join(
+            a.begin(), a.end(), b.begin(), b.end(),
+            detail::make_join_compare(a, b),
+            [](auto, auto){},
+            [](auto, auto){},
+            [&callback](auto a_first, auto a_last, auto b_first, auto b_last){
+                for ( ; a_first != a_last; ++a_first ) {
+                    for ( auto iter = b_first; iter != b_last; ++iter ) {
+                        callback(*a_first, *iter);
+                    }
+                }
+            });
+    }
+
+    // like join, and calls callback(a_value, nullptr) for
+    // the elements of the left container without a match
+    template < typename FlatA, typename FlatB, typename Callback >
+    void left_join(const FlatA& a, const FlatB& b, Callback&& callback) {
+        using b_pointer = const typename FlatB::value_type*;
+        detail::leapfrog_join(
+            a.begin(), a.end(), b.begin(), b.end(),
+            detail::make_join_compare(a, b),
+            [&callback](auto first, auto last){
+                for ( ; first != last; ++first ) {
+                    callback(*first, b_pointer(nullptr));
+                }
+            },
+            [](auto, auto){},
+            [&callback](auto a_first, auto a_last, auto b_first, auto b_last){
+                for ( ; a_first != a_last; ++a_first ) {
+                    for ( auto iter = b_first; iter != b_last; ++iter ) {
+                        callback(*a_first, b_pointer(&*iter));
+                    }
+                }
+            });
+    }
+
+    // calls callback(a_value) for the elements of the left
+    // container which have a match in the right one
+    template < typename FlatA, typename FlatB, typename Callback >
+    void semi_join(const FlatA& a, const FlatB& b, Callback&& callback) {
+        detail::leapfrog_join(
+            a.begin(), a.end(), b.begin(), b.end(),
+            detail::make_join_compare(a, b),
+            [](auto, auto){},
+            [](auto, auto){},
+            [&callback](auto a_first, auto a_last, auto, auto){
+                for ( ; a_first != a_last; ++a_first ) {
+                    callback(*a_first);
+                }
+            });
+    }
+
+    // calls callback(a_value) for the elements of the left
+    // container which have no match in the right one
+    template < typename FlatA, typename FlatB, typename Callback >
+    void anti_join(const FlatA& a, const FlatB& b, Callback&& callback) {
+        detail::leapfrog_join(
+            a.begin(), a.end(), b.begin(), b.end(),
+            detail::make_join_compare(a, b),
+            [&callback](auto first, auto last){
+                for ( ; first != last; ++first ) {
+                    callback(*first);
+                }
+            },
+            [](auto, auto){},
+            [](auto, auto, auto, auto){});
+    }
+
+    // calls callback(value_1, value_2, ...) for every key which is in all
+    // of the containers, the containers must have unique keys
+    template < typename Callback, typename Flat, typename... Flats >
+    void multi_join(Callback&& callback, const Flat& first, const Flats&... flats) {
+        static_assert(
+            sizeof...(Flats) > 0,
+            "flat_hpp::multi_join: at least two containers are required");
+
+        static_assert(
+            !detail::is_multi_v<Flat> && (!detail::is_multi_v<Flats> && ...),
+            "flat_hpp::multi_join: keys must be unique");
+
+        ((void)detail::make_join_compare(first, flats), ...);
+        detail::multi_join_impl<typename Flat::key_type>(
+            callback,
+            detail::join_compare<typename Flat::key_type, typename Flat::key_compare>(first.key_comp()),
+            std::index_sequence_for<Flat, Flats...>(),
+            first, flats...);
+    }
+}
@@ -8,6 +8,8 @@
 
 #include "flat_fwd.hpp"
 
+#include "detail/duplicate_policy.hpp"
+
 namespace flat_hpp
 {
     template < typename Key
@@ -43,6 +45,10 @@ namespace flat_hpp
         using reverse_iterator = typename Container::reverse_iterator;
         using const_reverse_iterator = typename Container::const_reverse_iterator;
 
+        using key_iterator = detail::projection_iterator<const_iterator, detail::pair_first_projection>;
+        using value_iterator = detail::projection_iterator<iterator, detail::pair_second_projection>;
+        using const_value_iterator = detail::projection_iterator<const_iterator, detail::pair_second_projection>;
+
         class value_compare : private key_compare {
         public:
             bool operator()(const value_type& l, const value_type& r) const {
@@ -102,6 +108,70 @@ namespace flat_hpp
             from_range_(sorted_unique_range, first, last);
         }
 
+        template < typename Policy
+                 , typename InputIter
+                 , typename = std::enable_if_t<detail::is_duplicate_policy_v<Policy>> >
+        flat_map(Policy policy, InputIter first, InputIter last) {
+            from_range_(policy, first, last);
+        }
+
+        template < typename Policy
+                 , typename InputIter
+                 , typename = std::enable_if_t<detail::is_duplicate_policy_v<Policy>> >
+        flat_map(Policy policy, InputIter first, InputIter last, const Compare& c)
+        : base_type(c) {
+            from_range_(policy, first, last);
+        }
+
+        template < typename Policy
+                 , typename = std::enable_if_t<detail::is_duplicate_policy_v<Policy>> >
+        flat_map(Policy policy, std::initializer_list<value_type> ilist) {
+            from_range_(policy, ilist.begin(), ilist.end());
+        }
+
+        template < typename Policy
+                 , typename = std::enable_if_t<detail::is_duplicate_policy_v<Policy>> >
+        flat_map(Policy policy, std::initializer_list<value_type> ilist, const Compare& c)
+        : base_type(c) {
+            from_range_(policy, ilist.begin(), ilist.end());
+        }
+
+        template < typename Policy
+                 , typename InputIter
+                 , typename Allocator
+                 , typename = std::enable_if_t<detail::is_duplicate_policy_v<Policy>> >
+        flat_map(Policy policy, InputIter first, InputIter last, const Allocator& a)
+        : data_(a) {
+            from_range_(policy, first, last);
+        }
+
+        template < typename Policy
+                 , typename InputIter
+                 , typename Allocator
+                 , typename = std::enable_if_t<detail::is_duplicate_policy_v<Policy>> >
+        flat_map(Policy policy, InputIter first, InputIter last, const Compare& c, const Allocator& a)
+        : base_type(c)
+        , data_(a) {
+            from_range_(policy, first, last);
+        }
+
+        template < typename Policy
+                 , typename Allocator
+                 , typename = std::enable_if_t<detail::is_duplicate_policy_v<Policy>> >
+        flat_map(Policy policy, std::initializer_list<value_type> ilist, const Allocator& a)
+        : data_(a) {
+            from_range_(policy, ilist.begin(), ilist.end());
+        }
+
+        template < typename Policy
+                 , typename Allocator
+                 , typename = std::enable_if_t<detail::is_duplicate_policy_v<Policy>> >
+        flat_map(Policy policy, std::initializer_list<value_type> ilist, const Compare& c, const Allocator& a)
+        : base_type(c)
+        , data_(a) {
+            from_range_(policy, ilist.begin(), ilist.end());
+        }
+
         template < typename InputIter, typename Allocator >
         flat_map(InputIter first, InputIter last, const Allocator& a)
         : data_(a) {
@@ -225,8 +295,17 @@ namespace flat_hpp
         flat_map& operator=(flat_map&& other) = default;
         flat_map& operator=(const flat_map& other) = default;
 
+        // the old elements are swapped aside with an empty container of the
+        // same allocator, so a throwing insert puts them back untouched
         flat_map& operator=(std::initializer_list<value_type> ilist) {
-            flat_map(ilist).swap(*this);
+            container_type data = detail::empty_container_like(*this);
+            data_.swap(data);
+            try {
+                from_range_(ilist.begin(), ilist.end());
+            } catch (...) {
+                data_.swap(data);
+                throw;
+            }
             return *this;
         }
 
@@ -319,17 +398,11 @@ namespace flat_hpp
         }
 
         mapped_type& operator[](key_type&& key) {
-            const iterator iter = find(key);
-            return iter != end()
-                ? iter->second
-                : emplace(std::move(key), mapped_type()).first->second;
+            return try_emplace(std::move(key)).first->second;
         }
 
         mapped_type& operator[](const key_type& key) {
-            const iterator iter = find(key);
-            return iter != end()
-                ? iter->second
-                : emplace(key, mapped_type()).first->second;
+            return try_emplace(key).first->second;
         }
 
         mapped_type& at(const key_type& key) {
@@ -373,38 +446,38 @@ namespace flat_hpp
         }
 
         std::pair<iterator, bool> insert(value_type&& value) {
-            const iterator iter = lower_bound(value.first);
+            const iterator iter = back_lower_bound_(value.first);
             return iter == end() || this->operator()(value, *iter)
                 ? std::make_pair(data_.insert(iter, std::move(value)), true)
                 : std::make_pair(iter, false);
         }
 
         std::pair<iterator, bool> insert(const value_type& value) {
-            const iterator iter = lower_bound(value.first);
+            const iterator iter = back_lower_bound_(value.first);
             return iter == end() || this->operator()(value, *iter)
                 ? std::make_pair(data_.insert(iter, value), true)
                 : std::make_pair(iter, false);
         }
 
         iterator insert(const_iterator hint, value_type&& value) {
-            return (hint == begin() || this->operator()(*(hint - 1), value))
-                && (hint == end() || this->operator()(value, *hint))
-                ? data_.insert(hint, std::move(value))
-                : insert(std::move(value)).first;
+            const iterator iter = lower_bound(hint, value.first);
+            return iter == end() || this->operator()(value, *iter)
+                ? data_.insert(iter, std::move(value))
+                : iter;
         }
 
         iterator insert(const_iterator hint, const value_type& value) {
-            return (hint == begin() || this->operator()(*(hint - 1), value))
-                && (hint == end() || this->operator()(value, *hint))
-                ? data_.insert(hint, value)
-                : insert(value).first;
+            const iterator iter = lower_bound(hint, value.first);
+            return iter == end() || this->operator()(value, *iter)
+                ? data_.insert(iter, value)
+                : iter;
         }
 
         template < typename TT >
         std::pair<iterator, bool> insert_or_assign(key_type&& key, TT&& value) {
-            iterator iter = lower_bound(key);
+            iterator iter = back_lower_bound_(key);
             if ( iter == end() || this->operator()(key, *iter) ) {
-                iter = emplace_hint(iter, std::move(key), std::forward<TT>(value));
+                iter = data_.emplace(iter, std::move(key), std::forward<TT>(value));
                 return {iter, true};
             }
             (*iter).second = std::forward<TT>(value);
@@ -413,15 +486,47 @@ namespace flat_hpp
 
         template < typename TT >
         std::pair<iterator, bool> insert_or_assign(const key_type& key, TT&& value) {
-            iterator iter = lower_bound(key);
+            iterator iter = back_lower_bound_(key);
             if ( iter == end() || this->operator()(key, *iter) ) {
-                iter = emplace_hint(iter, key, std::forward<TT>(value));
+                iter = data_.emplace(iter, key, std::forward<TT>(value));
                 return {iter, true};
             }
             (*iter).second = std::forward<TT>(value);
             return {iter, false};
         }
 
+        template < typename TT, typename Combiner >
+        std::pair<iterator, bool> upsert(key_type&& key, TT&& value, Combiner combiner) {
+            iterator iter = back_lower_bound_(key);
+            if ( iter == end() || this->operator()(key, *iter) ) {
+                iter = data_.emplace(iter, std::move(key), std::forward<TT>(value));
+                return {iter, true};
+            }
+            (*iter).second = combiner(std::move((*iter).second), std::forward<TT>(value));
+            return {iter, false};
+        }
+
+        template < typename TT, typename Combiner >
+        std::pair<iterator, bool> upsert(const key_type& key, TT&& value, Combiner combiner) {
+            iterator iter = back_lower_bound_(key);
+            if ( iter == end() || this->operator()(key, *iter) ) {
+                iter = data_.emplace(iter, key, std::forward<TT>(value));
+                return {iter, true};
+            }
+            (*iter).second = combiner(std::move((*iter).second), std::forward<TT>(value));
+            return {iter, false};
+        }
+
+        template < typename InputIter, typename Combiner >
+        void insert_or_combine(InputIter first, InputIter last, Combiner combiner) {
+            insert(combine(std::move(combiner)), first, last);
+        }
+
+        template < typename Combiner >
+        void insert_or_combine(std::initializer_list<value_type> ilist, Combiner combiner) {
+            insert(combine(std::move(combiner)), ilist);
+        }
+
         template < typename InputIter >
         void insert(InputIter first, InputIter last) {
             insert_range_(first, last);
@@ -440,21 +545,67 @@ namespace flat_hpp
             insert_range_(sorted_range, ilist.begin(), ilist.end());
         }
 
+        template < typename Policy, typename InputIter >
+        std::enable_if_t<detail::is_duplicate_policy_v<Policy>>
+        insert(Policy policy, InputIter first, InputIter last) {
+            insert_range_(policy, first, last);
+        }
+
+        template < typename Policy >
+        std::enable_if_t<detail::is_duplicate_policy_v<Policy>>
+        insert(Policy policy, std::initializer_list<value_type> ilist) {
+            insert_range_(policy, ilist.begin(), ilist.end());
+        }
+
         template < typename... Args >
         std::pair<iterator, bool> emplace(Args&&... args) {
-            return insert(value_type(std::forward<Args>(args)...));
+            if constexpr ( detail::is_map_emplace_key_v<key_type, Args...> ) {
+                const key_type& key = detail::map_emplace_key(args...);
+                const iterator iter = back_lower_bound_(key);
+                return iter == end() || this->operator()(key, *iter)
+                    ? std::make_pair(data_.emplace(iter, std::forward<Args>(args)...), true)
+                    : std::make_pair(iter, false);
+            } else {
+                return insert(value_type(std::forward<Args>(args)...));
+            }
         }
 
         template < typename... Args >
         iterator emplace_hint(const_iterator hint, Args&&... args) {
-            return insert(hint, value_type(std::forward<Args>(args)...));
+            if constexpr ( detail::is_map_emplace_key_v<key_type, Args...> ) {
+                const key_type& key = detail::map_emplace_key(args...);
+                const iterator iter = lower_bound(hint, key);
+                return iter == end() || this->operator()(key, *iter)
+                    ? data_.emplace(iter, std::forward<Args>(args)...)
+                    : iter;
+            } else {
+                return insert(hint, value_type(std::forward<Args>(args)...));
+            }
+        }
+
+        template < typename... Args >
+        iterator emplace_back_unchecked(Args&&... args) {
+            data_.emplace_back(std::forward<Args>(args)...);
+            assert(size() < 2 || this->operator()(*(end() - 2), data_.back()));
+            return end() - 1;
+        }
+
+        iterator append(value_type&& value) {
+            return emplace_back_unchecked(std::move(value));
+        }
+
+        iterator append(const value_type& value) {
+            return emplace_back_unchecked(value);
         }
 
         template < typename... Args >
         std::pair<iterator, bool> try_emplace(key_type&& key, Args&&... args) {
-            iterator iter = lower_bound(key);
+            iterator iter = back_lower_bound_(key);
             if ( iter == end() || this->operator()(key, *iter) ) {
-                iter = emplace_hint(iter, std::move(key), std::forward<Args>(args)...);
+                iter = data_.emplace(iter,
+                    std::piecewise_construct,
+                    std::forward_as_tuple(std::move(key)),
+                    std::forward_as_tuple(std::forward<Args>(args)...));
                 return {iter, true};
             }
             return {iter, false};
@@ -462,9 +613,12 @@ namespace flat_hpp
 
         template < typename... Args >
         std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args) {
-            iterator iter = lower_bound(key);
+            iterator iter = back_lower_bound_(key);
             if ( iter == end() || this->operator()(key, *iter) ) {
-                iter = emplace_hint(iter, key, std::forward<Args>(args)...);
+                iter = data_.emplace(iter,
+                    std::piecewise_construct,
+                    std::forward_as_tuple(key),
+                    std::forward_as_tuple(std::forward<Args>(args)...));
                 return {iter, true};
             }
             return {iter, false};
@@ -490,6 +644,29 @@ namespace flat_hpp
                 : 0;
         }
 
+        template < typename Runs >
+        void assign_merged(const Runs& runs) {
+            data_.clear();
+            detail::kway_merge(detail::collect_runs(runs), value_comp(), true, data_);
+        }
+
+        container_type extract() && {
+            container_type data = std::move(data_);
+            data_.clear();
+            return data;
+        }
+
+        void replace(container_type&& data) {
+            assert(detail::is_sorted_unique(data.begin(), data.end(), value_comp()));
+            data_ = std::move(data);
+        }
+
+        template < typename C = container_type >
+        auto get_allocator() const
+        -> decltype(std::declval<const C&>().get_allocator()) {
+            return data_.get_allocator();
+        }
+
         void swap(flat_map& other)
             noexcept(std::is_nothrow_swappable_v<base_type>
                 && std::is_nothrow_swappable_v<container_type>)
@@ -565,12 +742,12 @@ namespace flat_hpp
 
         std::pair<iterator, iterator> equal_range(const key_type& key) {
             const base_type& comp = *this;
-            return std::equal_range(begin(), end(), key, comp);
+            return detail::search_equal_range(begin(), end(), key, comp);
         }
 
         std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const {
             const base_type& comp = *this;
-            return std::equal_range(begin(), end(), key, comp);
+            return detail::search_equal_range(begin(), end(), key, comp);
         }
 
         template < typename K >
@@ -579,7 +756,7 @@ namespace flat_hpp
             std::pair<iterator, iterator>>
         equal_range(const K& key) {
             const base_type& comp = *this;
-            return std::equal_range(begin(), end(), key, comp);
+            return detail::search_equal_range(begin(), end(), key, comp);
         }
 
         template < typename K >
@@ -588,17 +765,17 @@ namespace flat_hpp
             std::pair<const_iterator, const_iterator>>
         equal_range(const K& key) const {
             const base_type& comp = *this;
-            return std::equal_range(begin(), end(), key, comp);
+            return detail::search_equal_range(begin(), end(), key, comp);
         }
 
         iterator lower_bound(const key_type& key) {
             const base_type& comp = *this;
-            return std::lower_bound(begin(), end(), key, comp);
+            return detail::search_lower_bound(begin(), end(), key, comp);
         }
 
         const_iterator lower_bound(const key_type& key) const {
             const base_type& comp = *this;
-            return std::lower_bound(begin(), end(), key, comp);
+            return detail::search_lower_bound(begin(), end(), key, comp);
         }
 
         template < typename K >
@@ -607,7 +784,7 @@ namespace flat_hpp
             iterator>
         lower_bound(const K& key) {
             const base_type& comp = *this;
-            return std::lower_bound(begin(), end(), key, comp);
+            return detail::search_lower_bound(begin(), end(), key, comp);
         }
 
         template < typename K >
@@ -616,17 +793,17 @@ namespace flat_hpp
             const_iterator>
         lower_bound(const K& key) const {
             const base_type& comp = *this;
-            return std::lower_bound(begin(), end(), key, comp);
+            return detail::search_lower_bound(begin(), end(), key, comp);
         }
 
         iterator upper_bound(const key_type& key) {
             const base_type& comp = *this;
-            return std::upper_bound(begin(), end(), key, comp);
+            return detail::search_upper_bound(begin(), end(), key, comp);
         }
 
         const_iterator upper_bound(const key_type& key) const {
             const base_type& comp = *this;
-            return std::upper_bound(begin(), end(), key, comp);
+            return detail::search_upper_bound(begin(), end(), key, comp);
         }
 
         template < typename K >
@@ -635,7 +812,7 @@ namespace flat_hpp
             iterator>
         upper_bound(const K& key) {
             const base_type& comp = *this;
-            return std::upper_bound(begin(), end(), key, comp);
+            return detail::search_upper_bound(begin(), end(), key, comp);
         }
 
         template < typename K >
@@ -644,7 +821,184 @@ namespace flat_hpp
             const_iterator>
         upper_bound(const K& key) const {
             const base_type& comp = *this;
-            return std::upper_bound(begin(), end(), key, comp);
+            return detail::search_upper_bound(begin(), end(), key, comp);
+        }
+
+        iterator find(const_iterator hint, const key_type& key) {
+            const iterator iter = lower_bound(hint, key);
+            return iter != end() && !this->operator()(key, *iter)
+                ? iter
+                : end();
+        }
+
+        const_iterator find(const_iterator hint, const key_type& key) const {
+            const const_iterator iter = lower_bound(hint, key);
+            return iter != end() && !this->operator()(key, *iter)
+                ? iter
+                : end();
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            iterator>
+        find(const_iterator hint, const K& key) {
+            const iterator iter = lower_bound(hint, key);
+            return iter != end() && !this->operator()(key, *iter)
+                ? iter
+                : end();
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            const_iterator>
+        find(const_iterator hint, const K& key) const {
+            const const_iterator iter = lower_bound(hint, key);
+            return iter != end() && !this->operator()(key, *iter)
+                ? iter
+                : end();
+        }
+
+        iterator lower_bound(const_iterator hint, const key_type& key) {
+            const base_type& comp = *this;
+            return detail::gallop_lower_bound(begin(), end(), begin() + (hint - cbegin()), key, comp);
+        }
+
+        const_iterator lower_bound(const_iterator hint, const key_type& key) const {
+            const base_type& comp = *this;
+            return detail::gallop_lower_bound(begin(), end(), hint, key, comp);
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            iterator>
+        lower_bound(const_iterator hint, const K& key) {
+            const base_type& comp = *this;
+            return detail::gallop_lower_bound(begin(), end(), begin() + (hint - cbegin()), key, comp);
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            const_iterator>
+        lower_bound(const_iterator hint, const K& key) const {
+            const base_type& comp = *this;
+            return detail::gallop_lower_bound(begin(), end(), hint, key, comp);
+        }
+
+        detail::range_view<iterator> range(const key_type& lo, const key_type& hi) {
+            const iterator first = lower_bound(lo);
+            return {first, std::max(first, lower_bound(hi))};
+        }
+
+        detail::range_view<const_iterator> range(const key_type& lo, const key_type& hi) const {
+            const const_iterator first = lower_bound(lo);
+            return {first, std::max(first, lower_bound(hi))};
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            detail::range_view<iterator>>
+        range(const K& lo, const K& hi) {
+            const iterator first = lower_bound(lo);
+            return {first, std::max(first, lower_bound(hi))};
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            detail::range_view<const_iterator>>
+        range(const K& lo, const K& hi) const {
+            const const_iterator first = lower_bound(lo);
+            return {first, std::max(first, lower_bound(hi))};
+        }
+
+        detail::range_view<iterator> range_from(const key_type& lo) {
+            return {lower_bound(lo), end()};
+        }
+
+        detail::range_view<const_iterator> range_from(const key_type& lo) const {
+            return {lower_bound(lo), end()};
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            detail::range_view<iterator>>
+        range_from(const K& lo) {
+            return {lower_bound(lo), end()};
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            detail::range_view<const_iterator>>
+        range_from(const K& lo) const {
+            return {lower_bound(lo), end()};
+        }
+
+        detail::range_view<key_iterator> keys() const
+        noexcept {
+            return {key_iterator(begin()), key_iterator(end())};
+        }
+
+        detail::range_view<value_iterator> values()
+        noexcept {
+            return {value_iterator(begin()), value_iterator(end())};
+        }
+
+        detail::range_view<const_value_iterator> values() const
+        noexcept {
+            return {const_value_iterator(begin()), const_value_iterator(end())};
+        }
+
+        iterator nth(size_type index)
+        noexcept {
+            assert(index <= size());
+            return begin() + static_cast<difference_type>(index);
+        }
+
+        const_iterator nth(size_type index) const
+        noexcept {
+            assert(index <= size());
+            return begin() + static_cast<difference_type>(index);
+        }
+
+        size_type index_of(const_iterator iter) const
+        noexcept {
+            assert(iter >= begin() && iter <= end());
+            return static_cast<size_type>(iter - begin());
+        }
+
+        size_type rank(const key_type& key) const {
+            return index_of(lower_bound(key));
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            size_type>
+        rank(const K& key) const {
+            return index_of(lower_bound(key));
+        }
+
+        size_type count_range(const key_type& lo, const key_type& hi) const {
+            const size_type first = rank(lo);
+            const size_type last = rank(hi);
+            return first < last ? last - first : 0;
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            size_type>
+        count_range(const K& lo, const K& hi) const {
+            const size_type first = rank(lo);
+            const size_type last = rank(hi);
+            return first < last ? last - first : 0;
         }
 
         key_compare key_comp() const {
@@ -655,6 +1009,13 @@ namespace flat_hpp
             return value_compare(key_comp());
         }
     private:
+        template < typename K >
+        iterator back_lower_bound_(const K& key) {
+            return data_.empty() || this->operator()(data_.back(), key)
+                ? end()
+                : lower_bound(key);
+        }
+
         template < typename Iter >
         void from_range_(Iter first, Iter last) {
             assert(data_.empty());
@@ -705,6 +1066,47 @@ namespace flat_hpp
                     detail::eq_compare<value_compare>(value_comp())),
                 data_.end());
         }
+
+        template < typename Policy, typename Iter >
+        void from_range_(Policy& policy, Iter first, Iter last) {
+            assert(data_.empty());
+            insert_range_(policy, first, last);
+        }
+
+        template < typename Policy, typename Iter >
+        void insert_range_(Policy& policy, Iter first, Iter last) {
+            const base_type& comp = *this;
+            const auto mid = data_.insert(data_.end(), first, last);
+            std::stable_sort(mid, data_.end(), value_comp());
+
+            // one pass over the sorted tail: each run of equal keys is resolved
+            // in input order into the existing element or into the first element
+            // of the run, which is then compacted towards mid
+            auto existing = data_.begin();
+            auto out = mid;
+            for ( auto iter = mid; iter != data_.end(); ) {
+                existing = detail::gallop_lower_bound(existing, mid, existing, *iter, comp);
+                const bool found = existing != mid && !comp(*iter, *existing);
+                const auto target = found ? existing : iter;
+
+                auto next = found ? iter : iter + 1;
+                for ( ; next != data_.end() && !comp(*target, *next); ++next ) {
+                    detail::resolve_duplicate(policy, (*target).second, std::move((*next).second));
+                }
+
+                if ( !found ) {
+                    if ( out != iter ) {
+                        *out = std::move(*iter);
+                    }
+                    ++out;
+                }
+
+                iter = next;
+            }
+
+            data_.erase(out, data_.end());
+            std::inplace_merge(data_.begin(), mid, data_.end(), value_comp());
+        }
     private:
         container_type data_;
     };
@@ -0,0 +1,338 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "flat_map.hpp"
+#include "flat_serialize.hpp"
+
+#include <cstdio>
+#include <iterator>
+#include <optional>
+#include <ostream>
+
+#include "detail/temp_file.hpp"
+
+namespace flat_hpp
+{
+    struct builder_stats {
+        std::size_t inserted_count = 0;
+        std::size_t spilled_count = 0;
+        std::size_t merged_count = 0;
+        std::size_t run_count = 0;
+        std::size_t peak_memory = 0;
+    };
+}
+
+namespace flat_hpp::detail
+{
+    template < typename T >
+    class spill_run_reader {
+    public:
+        spill_run_reader(temp_file& file, std::size_t count)
+        : file_(&file)
+        , left_(count) {
+            file_->rewind();
+            next();
+        }
+
+        T* current() noexcept {
+            return value_ ? &*value_ : nullptr;
+        }
+
+        void next() {
+            if ( left_ == 0 ) {
+                value_.reset();
+                return;
+            }
+            --left_;
+            value_.emplace(serializer<T>::read(*file_));
+        }
+    private:
+        temp_file* file_ = nullptr;
+        std::size_t left_ = 0;
+        std::optional<T> value_;
+    };
+
+    template < typename T >
+    class spill_run_iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+    public:
+        spill_run_iterator() = default;
+
+        explicit spill_run_iterator(spill_run_reader<T>& reader) noexcept
+        : reader_(&reader) {}
+
+        reference operator*() const
+        noexcept {
+            return *reader_->current();
+        }
+
+        spill_run_iterator& operator++() {
+            reader_->next();
+            return *this;
+        }
+
+        friend bool operator==(const spill_run_iterator& l, const spill_run_iterator& r) noexcept {
+            return l.done_() == r.done_();
+        }
+
+        friend bool operator!=(const spill_run_iterator& l, const spill_run_iterator& r) noexcept {
+            return !(l == r);
+        }
+    private:
+        bool done_() const noexcept {
+            return !reader_ || !reader_->current();
+        }
+    private:
+        spill_run_reader<T>* reader_ = nullptr;
+    };
+}
+
+namespace flat_hpp
+{
+    template < typename Key
+             , typename Value
+             , typename Compare
+             , typename Container >
+    class flat_map_builder {
+    public:
+        using map_type = flat_map<Key, Value, Compare, Container>;
+
+        using key_type = Key;
+        using mapped_type = Value;
+        using value_type = typename map_type::value_type;
+
+        using size_type = std::size_t;
+        using key_compare = Compare;
+        using container_type = Container;
+
+        using progress_callback = std::function<void(const builder_stats&)>;
+
+        static constexpr size_type progress_step = size_type{1} << 16u;
+    public:
+        explicit flat_map_builder(size_type memory_budget)
+        : run_capacity_(std::max<size_type>(1, memory_budget / sizeof(value_type))) {}
+
+        flat_map_builder(size_type memory_budget, const Compare& c)
+        : map_(c)
+        , run_capacity_(std::max<size_type>(1, memory_budget / sizeof(value_type))) {}
+
+        flat_map_builder(flat_map_builder&& other) = default;
+        flat_map_builder& operator=(flat_map_builder&& other) = default;
+
+        void on_progress(progress_callback callback) {
+            progress_ = std::move(callback);
+        }
+
+        const builder_stats& stats() const
+        noexcept {
+            return stats_;
+        }
+
+        void insert(value_type&& value) {
+            if ( buffer_.capacity() < run_capacity_ ) {
+                buffer_.reserve(run_capacity_);
+                note_memory_(buffer_.capacity() * sizeof(value_type));
+            }
+            buffer_.push_back(std::move(value));
+            ++stats_.inserted_count;
+            if ( buffer_.size() == run_capacity_ ) {
+                spill_();
+            }
+        }
+
+        void insert(const value_type& value) {
+            insert(value_type(value));
+        }
+
+        template < typename InputIter >
+        void insert(InputIter first, InputIter last) {
+            for ( ; first != last; ++first ) {
+                insert(*first);
+            }
+        }
+
+        template < typename... Args >
+        void emplace(Args&&... args) {
+            insert(value_type(std::forward<Args>(args)...));
+        }
+
+        map_type build() {
+            container_type data;
+            if ( runs_.empty() ) {
+                sort_buffer_();
+                stats_.merged_count += buffer_.size();
+                if constexpr ( std::is_same_v<container_type, std::vector<value_type>> ) {
+                    data = std::move(buffer_);
+                } else {
+                    data.insert(data.end(),
+                        std::make_move_iterator(buffer_.begin()),
+                        std::make_move_iterator(buffer_.end()));
+                }
+                report_();
+            } else {
+                merge_([&data](value_type&& value){
+                    data.push_back(std::move(value));
+                });
+            }
+            clear_();
+
+            map_type result(map_.key_comp());
+            result.replace(std::move(data));
+            return result;
+        }
+
+        void build(std::ostream& os) {
+            constexpr bool bitwise = detail::is_bitwise_serializable_v<value_type>;
+
+            const std::ostream::pos_type header_pos = os.tellp();
+            if ( header_pos == std::ostream::pos_type(-1) ) {
+                throw std::invalid_argument("flat_hpp::flat_map_builder: output stream is not seekable");
+            }
+
+            image_header header{};
+            os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+            // the element count is known only after the merge,
+            // so the header is written again when it is done
+            std::uint64_t count = 0;
+            detail::stream_writer writer(os);
+            merge_([&writer, &count](value_type&& value){
+                serializer<value_type>::write(writer, value);
+                ++count;
+            });
+            clear_();
+
+            if constexpr ( !bitwise ) {
+                const std::uint64_t checksum = writer.checksum();
+                os.write(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+            }
+
+            header = detail::make_image_header<map_type>(
+                count,
+                bitwise ? 0 : image_flag_streamed,
+                bitwise ? writer.checksum() : 0);
+
+            const std::ostream::pos_type end_pos = os.tellp();
+            os.seekp(header_pos);
+            os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            os.seekp(end_pos);
+
+            if ( !os ) {
+                throw std::runtime_error("flat_hpp::flat_map_builder: failed to write the image");
+            }
+        }
+    private:
+        struct run_info {
+            detail::temp_file file;
+            size_type size = 0;
+        };
+
+        using run_reader = detail::spill_run_reader<value_type>;
+        using run_iterator = detail::spill_run_iterator<value_type>;
+
+        void sort_buffer_() {
+            const auto comp = map_.value_comp();
+            std::stable_sort(buffer_.begin(), buffer_.end(), comp);
+            buffer_.erase(
+                std::unique(buffer_.begin(), buffer_.end(),
+                    detail::eq_compare<decltype(comp)>(comp)),
+                buffer_.end());
+        }
+
+        void spill_() {
+            if ( buffer_.empty() ) {
+                return;
+            }
+
+            sort_buffer_();
+
+            run_info run;
+            for ( const value_type& value : buffer_ ) {
+                serializer<value_type>::write(run.file, value);
+            }
+            run.size = buffer_.size();
+            runs_.push_back(std::move(run));
+
+            stats_.spilled_count += buffer_.size();
+            ++stats_.run_count;
+            buffer_.clear();
+            report_();
+        }
+
+        template < typename Consumer >
+        void merge_(Consumer consumer) {
+            if ( runs_.empty() ) {
+                sort_buffer_();
+                for ( value_type& value : buffer_ ) {
+                    consumer(std::move(value));
+                }
+                stats_.merged_count += buffer_.size();
+                report_();
+                return;
+            }
+
+            spill_();
+            std::vector<value_type>().swap(buffer_);
+
+            std::vector<run_reader> readers;
+            std::vector<std::pair<run_iterator, run_iterator>> ranges;
+            readers.reserve(runs_.size());
+            ranges.reserve(runs_.size());
+            for ( run_info& run : runs_ ) {
+                readers.emplace_back(run.file, run.size);
+                ranges.emplace_back(run_iterator(readers.back()), run_iterator());
+            }
+            note_memory_(runs_.size() * (sizeof(value_type) + BUFSIZ));
+
+            // every run is already unique and the tree is stable,
+            // so only the first of equal keys from different runs is kept
+            const auto comp = map_.value_comp();
+            detail::loser_tree<run_iterator, decltype(comp)> tree(std::move(ranges), comp);
+
+            std::optional<key_type> last_key;
+            for ( ; !tree.empty(); tree.pop() ) {
+                value_type& value = tree.top();
+                if ( !last_key || map_.key_comp()(*last_key, value.first) ) {
+                    last_key.emplace(value.first);
+                    consumer(std::move(value));
+                }
+                if ( ++stats_.merged_count % progress_step == 0 ) {
+                    report_();
+                }
+            }
+            report_();
+        }
+
+        void clear_() {
+            std::vector<value_type>().swap(buffer_);
+            runs_.clear();
+        }
+
+        void note_memory_(size_type bytes) noexcept {
+            stats_.peak_memory = std::max(stats_.peak_memory, bytes);
+        }
+
+        void report_() {
+            if ( progress_ ) {
+                progress_(stats_);
+            }
+        }
+    private:
+        map_type map_;
+        size_type run_capacity_ = 1;
+        std::vector<value_type> buffer_;
+        std::vector<run_info> runs_;
+        builder_stats stats_;
+        progress_callback progress_;
+    };
+}
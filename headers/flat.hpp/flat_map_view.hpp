@@ -0,0 +1,370 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "flat_fwd.hpp"
+
+namespace flat_hpp
+{
+    template < typename Key
+             , typename Value
+             , typename Compare >
+    class flat_map_view
+        : private detail::pair_compare<
+            std::pair<Key, Value>,
+            Compare>
+    {
+        using base_type = detail::pair_compare<
+            std::pair<Key, Value>,
+            Compare>;
+    public:
+        using key_type = Key;
+        using mapped_type = Value;
+        using value_type = std::pair<Key, Value>;
+
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        using key_compare = Compare;
+
+        using reference = const value_type&;
+        using const_reference = const value_type&;
+        using pointer = const value_type*;
+        using const_pointer = const value_type*;
+
+        using iterator = const value_type*;
+        using const_iterator = const value_type*;
+        using reverse_iterator = std::reverse_iterator<const_iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        class value_compare : private key_compare {
+        public:
+            bool operator()(const value_type& l, const value_type& r) const {
+                return key_compare::operator()(l.first, r.first);
+            }
+        protected:
+            friend class flat_map_view;
+            explicit value_compare(key_compare compare)
+            : key_compare(std::move(compare)) {}
+        };
+    public:
+        flat_map_view() = default;
+        ~flat_map_view() = default;
+
+        explicit flat_map_view(const Compare& c)
+        : base_type(c) {}
+
+        flat_map_view(sorted_unique_range_t, const_pointer first, const_pointer last)
+        : first_(first)
+        , last_(last) {
+            assert(detail::is_sorted_unique(first_, last_, value_comp()));
+        }
+
+        flat_map_view(sorted_unique_range_t, const_pointer first, const_pointer last, const Compare& c)
+        : base_type(c)
+        , first_(first)
+        , last_(last) {
+            assert(detail::is_sorted_unique(first_, last_, value_comp()));
+        }
+
+        flat_map_view(sorted_unique_range_t, const_pointer first, size_type count)
+        : flat_map_view(sorted_unique_range, first, first + count) {}
+
+        flat_map_view(sorted_unique_range_t, const_pointer first, size_type count, const Compare& c)
+        : flat_map_view(sorted_unique_range, first, first + count, c) {}
+
+        flat_map_view(flat_map_view&& other) = default;
+        flat_map_view(const flat_map_view& other) = default;
+
+        flat_map_view& operator=(flat_map_view&& other) = default;
+        flat_map_view& operator=(const flat_map_view& other) = default;
+
+        const_iterator begin() const
+        noexcept {
+            return first_;
+        }
+
+        const_iterator cbegin() const
+        noexcept {
+            return first_;
+        }
+
+        const_iterator end() const
+        noexcept {
+            return last_;
+        }
+
+        const_iterator cend() const
+        noexcept {
+            return last_;
+        }
+
+        const_reverse_iterator rbegin() const
+        noexcept {
+            return const_reverse_iterator(last_);
+        }
+
+        const_reverse_iterator crbegin() const
+        noexcept {
+            return const_reverse_iterator(last_);
+        }
+
+        const_reverse_iterator rend() const
+        noexcept {
+            return const_reverse_iterator(first_);
+        }
+
+        const_reverse_iterator crend() const
+        noexcept {
+            return const_reverse_iterator(first_);
+        }
+
+        const_pointer data() const
+        noexcept {
+            return first_;
+        }
+
+        bool empty() const
+        noexcept {
+            return first_ == last_;
+        }
+
+        size_type size() const
+        noexcept {
+            return static_cast<size_type>(last_ - first_);
+        }
+
+        void swap(flat_map_view& other)
+            noexcept(std::is_nothrow_swappable_v<base_type>)
+        {
+            using std::swap;
+            swap(
+                static_cast<base_type&>(*this),
+                static_cast<base_type&>(other));
+            swap(first_, other.first_);
+            swap(last_, other.last_);
+        }
+
+        const mapped_type& at(const key_type& key) const {
+            const const_iterator iter = find(key);
+            if ( iter != end() ) {
+                return iter->second;
+            }
+            throw std::out_of_range("flat_map_view::at: key not found");
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            const mapped_type&>
+        at(const K& key) const {
+            const const_iterator iter = find(key);
+            if ( iter != end() ) {
+                return iter->second;
+            }
+            throw std::out_of_range("flat_map_view::at: key not found");
+        }
+
+        size_type count(const key_type& key) const {
+            const const_iterator iter = find(key);
+            return iter != end() ? 1 : 0;
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            size_type>
+        count(const K& key) const {
+            const const_iterator iter = find(key);
+            return iter != end() ? 1 : 0;
+        }
+
+        const_iterator find(const key_type& key) const {
+            const const_iterator iter = lower_bound(key);
+            return iter != end() && !this->operator()(key, *iter)
+                ? iter
+                : end();
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            const_iterator>
+        find(const K& key) const {
+            const const_iterator iter = lower_bound(key);
+            return iter != end() && !this->operator()(key, *iter)
+                ? iter
+                : end();
+        }
+
+        bool contains(const key_type& key) const {
+            return find(key) != end();
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            bool>
+        contains(const K& key) const {
+            return find(key) != end();
+        }
+
+        std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const {
+            const base_type& comp = *this;
+            return detail::search_equal_range(begin(), end(), key, comp);
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            std::pair<const_iterator, const_iterator>>
+        equal_range(const K& key) const {
+            const base_type& comp = *this;
+            return detail::search_equal_range(begin(), end(), key, comp);
+        }
+
+        const_iterator lower_bound(const key_type& key) const {
+            const base_type& comp = *this;
+            return detail::search_lower_bound(begin(), end(), key, comp);
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            const_iterator>
+        lower_bound(const K& key) const {
+            const base_type& comp = *this;
+            return detail::search_lower_bound(begin(), end(), key, comp);
+        }
+
+        const_iterator upper_bound(const key_type& key) const {
+            const base_type& comp = *this;
+            return detail::search_upper_bound(begin(), end(), key, comp);
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            const_iterator>
+        upper_bound(const K& key) const {
+            const base_type& comp = *this;
+            return detail::search_upper_bound(begin(), end(), key, comp);
+        }
+
+        detail::range_view<const_iterator> range(const key_type& lo, const key_type& hi) const {
+            const const_iterator first = lower_bound(lo);
+            return {first, std::max(first, lower_bound(hi))};
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            detail::range_view<const_iterator>>
+        range(const K& lo, const K& hi) const {
+            const const_iterator first = lower_bound(lo);
+            return {first, std::max(first, lower_bound(hi))};
+        }
+
+        detail::range_view<const_iterator> range_from(const key_type& lo) const {
+            return {lower_bound(lo), end()};
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            detail::range_view<const_iterator>>
+        range_from(const K& lo) const {
+            return {lower_bound(lo), end()};
+        }
+
+        const_iterator nth(size_type index) const
+        noexcept {
+            assert(index <= size());
+            return begin() + static_cast<difference_type>(index);
+        }
+
+        size_type index_of(const_iterator iter) const
+        noexcept {
+            assert(iter >= begin() && iter <= end());
+            return static_cast<size_type>(iter - begin());
+        }
+
+        size_type rank(const key_type& key) const {
+            return index_of(lower_bound(key));
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            size_type>
+        rank(const K& key) const {
+            return index_of(lower_bound(key));
+        }
+
+        size_type count_range(const key_type& lo, const key_type& hi) const {
+            const size_type first = rank(lo);
+            const size_type last = rank(hi);
+            return first < last ? last - first : 0;
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            size_type>
+        count_range(const K& lo, const K& hi) const {
+            const size_type first = rank(lo);
+            const size_type last = rank(hi);
+            return first < last ? last - first : 0;
+        }
+
+        key_compare key_comp() const {
+            return *this;
+        }
+
+        value_compare value_comp() const {
+            return value_compare(key_comp());
+        }
+    private:
+        const_pointer first_ = nullptr;
+        const_pointer last_ = nullptr;
+    };
+}
+
+namespace flat_hpp
+{
+    template < typename Key
+             , typename Value
+             , typename Compare >
+    void swap(
+        flat_map_view<Key, Value, Compare>& l,
+        flat_map_view<Key, Value, Compare>& r)
+        noexcept(noexcept(l.swap(r)))
+    {
+        l.swap(r);
+    }
+
+    template < typename Key
+             , typename Value
+             , typename Compare >
+    bool operator==(
+        const flat_map_view<Key, Value, Compare>& l,
+        const flat_map_view<Key, Value, Compare>& r)
+    {
+        return l.size() == r.size()
+            && std::equal(l.begin(), l.end(), r.begin());
+    }
+
+    template < typename Key
+             , typename Value
+             , typename Compare >
+    bool operator!=(
+        const flat_map_view<Key, Value, Compare>& l,
+        const flat_map_view<Key, Value, Compare>& r)
+    {
+        return !(l == r);
+    }
+}
@@ -0,0 +1,97 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "flat_fwd.hpp"
+
+#include <exception>
+#include <iterator>
+#include <thread>
+
+#include "detail/is_multi.hpp"
+
+namespace flat_hpp
+{
+    template < typename Flat, typename Runs >
+    void parallel_assign_merged(Flat& flat, const Runs& runs, std::size_t thread_count) {
+        using value_type = typename Flat::value_type;
+
+        const auto comp = flat.value_comp();
+        const auto all_runs = detail::collect_runs(runs);
+        using run_t = typename decltype(all_runs)::value_type;
+        assert(detail::runs_sorted(all_runs, comp));
+
+        // splitters are taken from the longest run and every run is cut at
+        // their lower bounds, so equal elements always end up in one part
+        const std::size_t part_count = std::max<std::size_t>(thread_count, 1);
+        std::vector<typename run_t::first_type> splitters;
+        if ( !all_runs.empty() ) {
+            const run_t& longest = *std::max_element(all_runs.begin(), all_runs.end(),
+                [](const run_t& l, const run_t& r){
+                    return std::distance(l.first, l.second) < std::distance(r.first, r.second);
+                });
+            const std::size_t count = static_cast<std::size_t>(std::distance(longest.first, longest.second));
+            for ( std::size_t i = 1; i < part_count && count > 0; ++i ) {
+                splitters.push_back(std::next(longest.first,
+                    static_cast<std::ptrdiff_t>(count * i / part_count)));
+            }
+        }
+
+        std::vector<std::vector<run_t>> parts(splitters.size() + 1);
+        for ( const run_t& run : all_runs ) {
+            auto first = run.first;
+            for ( std::size_t i = 0; i < splitters.size(); ++i ) {
+                const auto last = std::lower_bound(first, run.second, *splitters[i], comp);
+                parts[i].emplace_back(first, last);
+                first = last;
+            }
+            parts.back().emplace_back(first, run.second);
+        }
+
+        std::vector<std::vector<value_type>> outputs(parts.size());
+        std::vector<std::exception_ptr> errors(parts.size());
+        {
+            // a failed thread start unwinds through the joiner, so the
+            // started threads are joined instead of calling terminate
+            struct joiner {
+                std::vector<std::thread>& threads;
+                ~joiner() {
+                    for ( std::thread& thread : threads ) {
+                        thread.join();
+                    }
+                }
+            };
+            std::vector<std::thread> threads;
+            threads.reserve(parts.size());
+            const joiner join{threads};
+            for ( std::size_t i = 0; i < parts.size(); ++i ) {
+                threads.emplace_back([&parts, &outputs, &errors, &comp, i](){
+                    try {
+                        detail::kway_merge(std::move(parts[i]), comp, !detail::is_multi_v<Flat>, outputs[i]);
+                    } catch (...) {
+                        errors[i] = std::current_exception();
+                    }
+                });
+            }
+        }
+
+        for ( const std::exception_ptr& error : errors ) {
+            if ( error ) {
+                std::rethrow_exception(error);
+            }
+        }
+
+        typename Flat::container_type data = std::move(flat).extract();
+        data.clear();
+        for ( std::vector<value_type>& output : outputs ) {
+            data.insert(data.end(),
+                std::make_move_iterator(output.begin()),
+                std::make_move_iterator(output.end()));
+        }
+        flat.replace(std::move(data));
+    }
+}
@@ -43,6 +43,10 @@ namespace flat_hpp
         using reverse_iterator = typename Container::reverse_iterator;
         using const_reverse_iterator = typename Container::const_reverse_iterator;
 
+        using key_iterator = detail::projection_iterator<const_iterator, detail::pair_first_projection>;
+        using value_iterator = detail::projection_iterator<iterator, detail::pair_second_projection>;
+        using const_value_iterator = detail::projection_iterator<const_iterator, detail::pair_second_projection>;
+
         class value_compare : private key_compare {
         public:
             bool operator()(const value_type& l, const value_type& r) const {
@@ -179,8 +183,17 @@ namespace flat_hpp
         flat_multimap& operator=(flat_multimap&& other) = default;
         flat_multimap& operator=(const flat_multimap& other) = default;
 
+        // the old elements are swapped aside with an empty container of the
+        // same allocator, so a throwing insert puts them back untouched
         flat_multimap& operator=(std::initializer_list<value_type> ilist) {
-            flat_multimap(ilist).swap(*this);
+            container_type data = detail::empty_container_like(*this);
+            data_.swap(data);
+            try {
+                from_range_(ilist.begin(), ilist.end());
+            } catch (...) {
+                data_.swap(data);
+                throw;
+            }
             return *this;
         }
 
@@ -327,12 +340,12 @@ namespace flat_hpp
         }
 
         iterator insert(value_type&& value) {
-            const iterator iter = upper_bound(value.first);
+            const iterator iter = back_upper_bound_(value.first);
             return data_.insert(iter, std::move(value));
         }
 
         iterator insert(const value_type& value) {
-            const iterator iter = upper_bound(value.first);
+            const iterator iter = back_upper_bound_(value.first);
             return data_.insert(iter, value);
         }
 
@@ -340,14 +353,14 @@ namespace flat_hpp
             return (hint == begin() || !this->operator()(value, *(hint - 1)))
                 && (hint == end() || !this->operator()(*hint, value))
                 ? data_.insert(hint, std::move(value))
-                : insert(std::move(value));
+                : data_.insert(hinted_upper_bound_(hint, value), std::move(value));
         }
 
         iterator insert(const_iterator hint, const value_type& value) {
             return (hint == begin() || !this->operator()(value, *(hint - 1)))
                 && (hint == end() || !this->operator()(*hint, value))
                 ? data_.insert(hint, value)
-                : insert(value);
+                : data_.insert(hinted_upper_bound_(hint, value), value);
         }
 
         template < typename InputIter >
@@ -370,12 +383,40 @@ namespace flat_hpp
 
         template < typename... Args >
         iterator emplace(Args&&... args) {
-            return insert(value_type(std::forward<Args>(args)...));
+            if constexpr ( detail::is_map_emplace_key_v<key_type, Args...> ) {
+                const key_type& key = detail::map_emplace_key(args...);
+                return data_.emplace(back_upper_bound_(key), std::forward<Args>(args)...);
+            } else {
+                return insert(value_type(std::forward<Args>(args)...));
+            }
         }
 
         template < typename... Args >
         iterator emplace_hint(const_iterator hint, Args&&... args) {
-            return insert(hint, value_type(std::forward<Args>(args)...));
+            if constexpr ( detail::is_map_emplace_key_v<key_type, Args...> ) {
+                const key_type& key = detail::map_emplace_key(args...);
+                return (hint == begin() || !this->operator()(key, *(hint - 1)))
+                    && (hint == end() || !this->operator()(*hint, key))
+                    ? data_.emplace(hint, std::forward<Args>(args)...)
+                    : data_.emplace(hinted_upper_bound_(hint, key), std::forward<Args>(args)...);
+            } else {
+                return insert(hint, value_type(std::forward<Args>(args)...));
+            }
+        }
+
+        template < typename... Args >
+        iterator emplace_back_unchecked(Args&&... args) {
+            data_.emplace_back(std::forward<Args>(args)...);
+            assert(size() < 2 || !this->operator()(data_.back(), *(end() - 2)));
+            return end() - 1;
+        }
+
+        iterator append(value_type&& value) {
+            return emplace_back_unchecked(std::move(value));
+        }
+
+        iterator append(const value_type& value) {
+            return emplace_back_unchecked(value);
         }
 
         void clear()
@@ -398,6 +439,29 @@ namespace flat_hpp
             return r;
         }
 
+        template < typename Runs >
+        void assign_merged(const Runs& runs) {
+            data_.clear();
+            detail::kway_merge(detail::collect_runs(runs), value_comp(), false, data_);
+        }
+
+        container_type extract() && {
+            container_type data = std::move(data_);
+            data_.clear();
+            return data;
+        }
+
+        void replace(container_type&& data) {
+            assert(detail::is_sorted(data.begin(), data.end(), value_comp()));
+            data_ = std::move(data);
+        }
+
+        template < typename C = container_type >
+        auto get_allocator() const
+        -> decltype(std::declval<const C&>().get_allocator()) {
+            return data_.get_allocator();
+        }
+
         void swap(flat_multimap& other)
             noexcept(std::is_nothrow_swappable_v<base_type>
                 && std::is_nothrow_swappable_v<container_type>)
@@ -473,12 +537,12 @@ namespace flat_hpp
 
         std::pair<iterator, iterator> equal_range(const key_type& key) {
             const base_type& comp = *this;
-            return std::equal_range(begin(), end(), key, comp);
+            return detail::search_equal_range(begin(), end(), key, comp);
         }
 
         std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const {
             const base_type& comp = *this;
-            return std::equal_range(begin(), end(), key, comp);
+            return detail::search_equal_range(begin(), end(), key, comp);
         }
 
         template < typename K >
@@ -487,7 +551,7 @@ namespace flat_hpp
             std::pair<iterator, iterator>>
         equal_range(const K& key) {
             const base_type& comp = *this;
-            return std::equal_range(begin(), end(), key, comp);
+            return detail::search_equal_range(begin(), end(), key, comp);
         }
 
         template < typename K >
@@ -496,17 +560,17 @@ namespace flat_hpp
             std::pair<const_iterator, const_iterator>>
         equal_range(const K& key) const {
             const base_type& comp = *this;
-            return std::equal_range(begin(), end(), key, comp);
+            return detail::search_equal_range(begin(), end(), key, comp);
         }
 
         iterator lower_bound(const key_type& key) {
             const base_type& comp = *this;
-            return std::lower_bound(begin(), end(), key, comp);
+            return detail::search_lower_bound(begin(), end(), key, comp);
         }
 
         const_iterator lower_bound(const key_type& key) const {
             const base_type& comp = *this;
-            return std::lower_bound(begin(), end(), key, comp);
+            return detail::search_lower_bound(begin(), end(), key, comp);
         }
 
         template < typename K >
@@ -515,7 +579,7 @@ namespace flat_hpp
             iterator>
         lower_bound(const K& key) {
             const base_type& comp = *this;
-            return std::lower_bound(begin(), end(), key, comp);
+            return detail::search_lower_bound(begin(), end(), key, comp);
         }
 
         template < typename K >
@@ -524,17 +588,17 @@ namespace flat_hpp
             const_iterator>
         lower_bound(const K& key) const {
             const base_type& comp = *this;
-            return std::lower_bound(begin(), end(), key, comp);
+            return detail::search_lower_bound(begin(), end(), key, comp);
         }
 
         iterator upper_bound(const key_type& key) {
             const base_type& comp = *this;
-            return std::upper_bound(begin(), end(), key, comp);
+            return detail::search_upper_bound(begin(), end(), key, comp);
         }
 
         const_iterator upper_bound(const key_type& key) const {
             const base_type& comp = *this;
-            return std::upper_bound(begin(), end(), key, comp);
+            return detail::search_upper_bound(begin(), end(), key, comp);
         }
 
         template < typename K >
@@ -543,7 +607,7 @@ namespace flat_hpp
             iterator>
         upper_bound(const K& key) {
             const base_type& comp = *this;
-            return std::upper_bound(begin(), end(), key, comp);
+            return detail::search_upper_bound(begin(), end(), key, comp);
         }
 
         template < typename K >
@@ -552,7 +616,184 @@ namespace flat_hpp
             const_iterator>
         upper_bound(const K& key) const {
             const base_type& comp = *this;
-            return std::upper_bound(begin(), end(), key, comp);
+            return detail::search_upper_bound(begin(), end(), key, comp);
+        }
+
+        iterator find(const_iterator hint, const key_type& key) {
+            const iterator iter = lower_bound(hint, key);
+            return iter != end() && !this->operator()(key, *iter)
+                ? iter
+                : end();
+        }
+
+        const_iterator find(const_iterator hint, const key_type& key) const {
+            const const_iterator iter = lower_bound(hint, key);
+            return iter != end() && !this->operator()(key, *iter)
+                ? iter
+                : end();
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            iterator>
+        find(const_iterator hint, const K& key) {
+            const iterator iter = lower_bound(hint, key);
+            return iter != end() && !this->operator()(key, *iter)
+                ? iter
+                : end();
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            const_iterator>
+        find(const_iterator hint, const K& key) const {
+            const const_iterator iter = lower_bound(hint, key);
+            return iter != end() && !this->operator()(key, *iter)
+                ? iter
+                : end();
+        }
+
+        iterator lower_bound(const_iterator hint, const key_type& key) {
+            const base_type& comp = *this;
+            return detail::gallop_lower_bound(begin(), end(), begin() + (hint - cbegin()), key, comp);
+        }
+
+        const_iterator lower_bound(const_iterator hint, const key_type& key) const {
+            const base_type& comp = *this;
+            return detail::gallop_lower_bound(begin(), end(), hint, key, comp);
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            iterator>
+        lower_bound(const_iterator hint, const K& key) {
+            const base_type& comp = *this;
+            return detail::gallop_lower_bound(begin(), end(), begin() + (hint - cbegin()), key, comp);
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            const_iterator>
+        lower_bound(const_iterator hint, const K& key) const {
+            const base_type& comp = *this;
+            return detail::gallop_lower_bound(begin(), end(), hint, key, comp);
+        }
+
+        detail::range_view<iterator> range(const key_type& lo, const key_type& hi) {
+            const iterator first = lower_bound(lo);
+            return {first, std::max(first, lower_bound(hi))};
+        }
+
+        detail::range_view<const_iterator> range(const key_type& lo, const key_type& hi) const {
+            const const_iterator first = lower_bound(lo);
+            return {first, std::max(first, lower_bound(hi))};
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            detail::range_view<iterator>>
+        range(const K& lo, const K& hi) {
+            const iterator first = lower_bound(lo);
+            return {first, std::max(first, lower_bound(hi))};
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            detail::range_view<const_iterator>>
+        range(const K& lo, const K& hi) const {
+            const const_iterator first = lower_bound(lo);
+            return {first, std::max(first, lower_bound(hi))};
+        }
+
+        detail::range_view<iterator> range_from(const key_type& lo) {
+            return {lower_bound(lo), end()};
+        }
+
+        detail::range_view<const_iterator> range_from(const key_type& lo) const {
+            return {lower_bound(lo), end()};
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            detail::range_view<iterator>>
+        range_from(const K& lo) {
+            return {lower_bound(lo), end()};
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            detail::range_view<const_iterator>>
+        range_from(const K& lo) const {
+            return {lower_bound(lo), end()};
+        }
+
+        detail::range_view<key_iterator> keys() const
+        noexcept {
+            return {key_iterator(begin()), key_iterator(end())};
+        }
+
+        detail::range_view<value_iterator> values()
+        noexcept {
+            return {value_iterator(begin()), value_iterator(end())};
+        }
+
+        detail::range_view<const_value_iterator> values() const
+        noexcept {
+            return {const_value_iterator(begin()), const_value_iterator(end())};
+        }
+
+        iterator nth(size_type index)
+        noexcept {
+            assert(index <= size());
+            return begin() + static_cast<difference_type>(index);
+        }
+
+        const_iterator nth(size_type index) const
+        noexcept {
+            assert(index <= size());
+            return begin() + static_cast<difference_type>(index);
+        }
+
+        size_type index_of(const_iterator iter) const
+        noexcept {
+            assert(iter >= begin() && iter <= end());
+            return static_cast<size_type>(iter - begin());
+        }
+
+        size_type rank(const key_type& key) const {
+            return index_of(lower_bound(key));
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            size_type>
+        rank(const K& key) const {
+            return index_of(lower_bound(key));
+        }
+
+        size_type count_range(const key_type& lo, const key_type& hi) const {
+            const size_type first = rank(lo);
+            const size_type last = rank(hi);
+            return first < last ? last - first : 0;
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            size_type>
+        count_range(const K& lo, const K& hi) const {
+            const size_type first = rank(lo);
+            const size_type last = rank(hi);
+            return first < last ? last - first : 0;
         }
 
         key_compare key_comp() const {
@@ -563,6 +804,19 @@ namespace flat_hpp
             return value_compare(key_comp());
         }
     private:
+        template < typename K >
+        iterator back_upper_bound_(const K& key) {
+            return data_.empty() || !this->operator()(key, data_.back())
+                ? end()
+                : upper_bound(key);
+        }
+
+        template < typename K >
+        const_iterator hinted_upper_bound_(const_iterator hint, const K& key) const {
+            const base_type& comp = *this;
+            return detail::gallop_upper_bound(begin(), end(), hint, key, comp);
+        }
+
         template < typename Iter >
         void from_range_(Iter first, Iter last) {
             assert(data_.empty());
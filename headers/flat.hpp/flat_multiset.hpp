@@ -161,8 +161,17 @@ namespace flat_hpp
         flat_multiset& operator=(flat_multiset&& other) = default;
         flat_multiset& operator=(const flat_multiset& other) = default;
 
+        // the old elements are swapped aside with an empty container of the
+        // same allocator, so a throwing insert puts them back untouched
         flat_multiset& operator=(std::initializer_list<value_type> ilist) {
-            flat_multiset(ilist).swap(*this);
+            container_type data = detail::empty_container_like(*this);
+            data_.swap(data);
+            try {
+                from_range_(ilist.begin(), ilist.end());
+            } catch (...) {
+                data_.swap(data);
+                throw;
+            }
             return *this;
         }
 
@@ -255,12 +264,12 @@ namespace flat_hpp
         }
 
         iterator insert(value_type&& value) {
-            const iterator iter = upper_bound(value);
+            const iterator iter = back_upper_bound_(value);
             return data_.insert(iter, std::move(value));
         }
 
         iterator insert(const value_type& value) {
-            const iterator iter = upper_bound(value);
+            const iterator iter = back_upper_bound_(value);
             return data_.insert(iter, value);
         }
 
@@ -268,14 +277,14 @@ namespace flat_hpp
             return (hint == begin() || !this->operator()(value, *(hint - 1)))
                 && (hint == end() || !this->operator()(*hint, value))
                 ? data_.insert(hint, std::move(value))
-                : insert(std::move(value));
+                : data_.insert(hinted_upper_bound_(hint, value), std::move(value));
         }
 
         iterator insert(const_iterator hint, const value_type& value) {
             return (hint == begin() || !this->operator()(value, *(hint - 1)))
                 && (hint == end() || !this->operator()(*hint, value))
                 ? data_.insert(hint, value)
-                : insert(value);
+                : data_.insert(hinted_upper_bound_(hint, value), value);
         }
 
         template < typename InputIter >
@@ -298,12 +307,35 @@ namespace flat_hpp
 
         template < typename... Args >
         iterator emplace(Args&&... args) {
-            return insert(value_type(std::forward<Args>(args)...));
+            if constexpr ( detail::is_set_emplace_key_v<key_type, Args...> ) {
+                return insert(std::forward<Args>(args)...);
+            } else {
+                return insert(value_type(std::forward<Args>(args)...));
+            }
         }
 
         template < typename... Args >
         iterator emplace_hint(const_iterator hint, Args&&... args) {
-            return insert(hint, value_type(std::forward<Args>(args)...));
+            if constexpr ( detail::is_set_emplace_key_v<key_type, Args...> ) {
+                return insert(hint, std::forward<Args>(args)...);
+            } else {
+                return insert(hint, value_type(std::forward<Args>(args)...));
+            }
+        }
+
+        template < typename... Args >
+        iterator emplace_back_unchecked(Args&&... args) {
+            data_.emplace_back(std::forward<Args>(args)...);
+            assert(size() < 2 || !this->operator()(data_.back(), *(end() - 2)));
+            return end() - 1;
+        }
+
+        iterator append(value_type&& value) {
+            return emplace_back_unchecked(std::move(value));
+        }
+
+        iterator append(const value_type& value) {
+            return emplace_back_unchecked(value);
         }
 
         void clear()
@@ -326,6 +358,29 @@ namespace flat_hpp
             return r;
         }
 
+        template < typename Runs >
+        void assign_merged(const Runs& runs) {
+            data_.clear();
+            detail::kway_merge(detail::collect_runs(runs), value_comp(), false, data_);
+        }
+
+        container_type extract() && {
+            container_type data = std::move(data_);
+            data_.clear();
+            return data;
+        }
+
+        void replace(container_type&& data) {
+            assert(detail::is_sorted(data.begin(), data.end(), key_comp()));
+            data_ = std::move(data);
+        }
+
+        template < typename C = container_type >
+        auto get_allocator() const
+        -> decltype(std::declval<const C&>().get_allocator()) {
+            return data_.get_allocator();
+        }
+
         void swap(flat_multiset& other)
             noexcept(std::is_nothrow_swappable_v<base_type>
                 && std::is_nothrow_swappable_v<container_type>)
@@ -400,11 +455,11 @@ namespace flat_hpp
         }
 
         std::pair<iterator, iterator> equal_range(const key_type& key) {
-            return std::equal_range(begin(), end(), key, key_comp());
+            return detail::search_equal_range(begin(), end(), key, key_comp());
         }
 
         std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const {
-            return std::equal_range(begin(), end(), key, key_comp());
+            return detail::search_equal_range(begin(), end(), key, key_comp());
         }
 
         template < typename K >
@@ -412,7 +467,7 @@ namespace flat_hpp
             detail::is_transparent_v<Compare, K>,
             std::pair<iterator, iterator>>
         equal_range(const K& key) {
-            return std::equal_range(begin(), end(), key, key_comp());
+            return detail::search_equal_range(begin(), end(), key, key_comp());
         }
 
         template < typename K >
@@ -420,15 +475,15 @@ namespace flat_hpp
             detail::is_transparent_v<Compare, K>,
             std::pair<const_iterator, const_iterator>>
         equal_range(const K& key) const {
-            return std::equal_range(begin(), end(), key, key_comp());
+            return detail::search_equal_range(begin(), end(), key, key_comp());
         }
 
         iterator lower_bound(const key_type& key) {
-            return std::lower_bound(begin(), end(), key, key_comp());
+            return detail::search_lower_bound(begin(), end(), key, key_comp());
         }
 
         const_iterator lower_bound(const key_type& key) const {
-            return std::lower_bound(begin(), end(), key, key_comp());
+            return detail::search_lower_bound(begin(), end(), key, key_comp());
         }
 
         template < typename K >
@@ -436,7 +491,7 @@ namespace flat_hpp
             detail::is_transparent_v<Compare, K>,
             iterator>
         lower_bound(const K& key) {
-            return std::lower_bound(begin(), end(), key, key_comp());
+            return detail::search_lower_bound(begin(), end(), key, key_comp());
         }
 
         template < typename K >
@@ -444,15 +499,15 @@ namespace flat_hpp
             detail::is_transparent_v<Compare, K>,
             const_iterator>
         lower_bound(const K& key) const {
-            return std::lower_bound(begin(), end(), key, key_comp());
+            return detail::search_lower_bound(begin(), end(), key, key_comp());
         }
 
         iterator upper_bound(const key_type& key) {
-            return std::upper_bound(begin(), end(), key, key_comp());
+            return detail::search_upper_bound(begin(), end(), key, key_comp());
         }
 
         const_iterator upper_bound(const key_type& key) const {
-            return std::upper_bound(begin(), end(), key, key_comp());
+            return detail::search_upper_bound(begin(), end(), key, key_comp());
         }
 
         template < typename K >
@@ -460,7 +515,7 @@ namespace flat_hpp
             detail::is_transparent_v<Compare, K>,
             iterator>
         upper_bound(const K& key) {
-            return std::upper_bound(begin(), end(), key, key_comp());
+            return detail::search_upper_bound(begin(), end(), key, key_comp());
         }
 
         template < typename K >
@@ -468,7 +523,169 @@ namespace flat_hpp
             detail::is_transparent_v<Compare, K>,
             const_iterator>
         upper_bound(const K& key) const {
-            return std::upper_bound(begin(), end(), key, key_comp());
+            return detail::search_upper_bound(begin(), end(), key, key_comp());
+        }
+
+        iterator find(const_iterator hint, const key_type& key) {
+            const iterator iter = lower_bound(hint, key);
+            return iter != end() && !this->operator()(key, *iter)
+                ? iter
+                : end();
+        }
+
+        const_iterator find(const_iterator hint, const key_type& key) const {
+            const const_iterator iter = lower_bound(hint, key);
+            return iter != end() && !this->operator()(key, *iter)
+                ? iter
+                : end();
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            iterator>
+        find(const_iterator hint, const K& key) {
+            const iterator iter = lower_bound(hint, key);
+            return iter != end() && !this->operator()(key, *iter)
+                ? iter
+                : end();
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            const_iterator>
+        find(const_iterator hint, const K& key) const {
+            const const_iterator iter = lower_bound(hint, key);
+            return iter != end() && !this->operator()(key, *iter)
+                ? iter
+                : end();
+        }
+
+        iterator lower_bound(const_iterator hint, const key_type& key) {
+            const base_type& comp = *this;
+            return detail::gallop_lower_bound(begin(), end(), begin() + (hint - cbegin()), key, comp);
+        }
+
+        const_iterator lower_bound(const_iterator hint, const key_type& key) const {
+            const base_type& comp = *this;
+            return detail::gallop_lower_bound(begin(), end(), hint, key, comp);
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            iterator>
+        lower_bound(const_iterator hint, const K& key) {
+            const base_type& comp = *this;
+            return detail::gallop_lower_bound(begin(), end(), begin() + (hint - cbegin()), key, comp);
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            const_iterator>
+        lower_bound(const_iterator hint, const K& key) const {
+            const base_type& comp = *this;
+            return detail::gallop_lower_bound(begin(), end(), hint, key, comp);
+        }
+
+        detail::range_view<iterator> range(const key_type& lo, const key_type& hi) {
+            const iterator first = lower_bound(lo);
+            return {first, std::max(first, lower_bound(hi))};
+        }
+
+        detail::range_view<const_iterator> range(const key_type& lo, const key_type& hi) const {
+            const const_iterator first = lower_bound(lo);
+            return {first, std::max(first, lower_bound(hi))};
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            detail::range_view<iterator>>
+        range(const K& lo, const K& hi) {
+            const iterator first = lower_bound(lo);
+            return {first, std::max(first, lower_bound(hi))};
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            detail::range_view<const_iterator>>
+        range(const K& lo, const K& hi) const {
+            const const_iterator first = lower_bound(lo);
+            return {first, std::max(first, lower_bound(hi))};
+        }
+
+        detail::range_view<iterator> range_from(const key_type& lo) {
+            return {lower_bound(lo), end()};
+        }
+
+        detail::range_view<const_iterator> range_from(const key_type& lo) const {
+            return {lower_bound(lo), end()};
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            detail::range_view<iterator>>
+        range_from(const K& lo) {
+            return {lower_bound(lo), end()};
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            detail::range_view<const_iterator>>
+        range_from(const K& lo) const {
+            return {lower_bound(lo), end()};
+        }
+
+        iterator nth(size_type index)
+        noexcept {
+            assert(index <= size());
+            return begin() + static_cast<difference_type>(index);
+        }
+
+        const_iterator nth(size_type index) const
+        noexcept {
+            assert(index <= size());
+            return begin() + static_cast<difference_type>(index);
+        }
+
+        size_type index_of(const_iterator iter) const
+        noexcept {
+            assert(iter >= begin() && iter <= end());
+            return static_cast<size_type>(iter - begin());
+        }
+
+        size_type rank(const key_type& key) const {
+            return index_of(lower_bound(key));
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            size_type>
+        rank(const K& key) const {
+            return index_of(lower_bound(key));
+        }
+
+        size_type count_range(const key_type& lo, const key_type& hi) const {
+            const size_type first = rank(lo);
+            const size_type last = rank(hi);
+            return first < last ? last - first : 0;
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            size_type>
+        count_range(const K& lo, const K& hi) const {
+            const size_type first = rank(lo);
+            const size_type last = rank(hi);
+            return first < last ? last - first : 0;
         }
 
         key_compare key_comp() const {
@@ -479,6 +696,19 @@ namespace flat_hpp
             return value_compare(key_comp());
         }
     private:
+        template < typename K >
+        iterator back_upper_bound_(const K& key) {
+            return data_.empty() || !this->operator()(key, data_.back())
+                ? end()
+                : upper_bound(key);
+        }
+
+        template < typename K >
+        const_iterator hinted_upper_bound_(const_iterator hint, const K& key) const {
+            const base_type& comp = *this;
+            return detail::gallop_upper_bound(begin(), end(), hint, key, comp);
+        }
+
         template < typename Iter >
         void from_range_(Iter first, Iter last) {
             assert(data_.empty());
@@ -0,0 +1,200 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "flat_image.hpp"
+
+#include <istream>
+#include <string>
+
+#include "detail/container_traits.hpp"
+#include "detail/stream_io.hpp"
+
+namespace flat_hpp
+{
+    template < typename T, typename = void >
+    struct serializer;
+
+    template < typename T >
+    struct serializer<T, std::enable_if_t<detail::is_bitwise_serializable_v<T>>> {
+        template < typename Writer >
+        static void write(Writer& w, const T& value) {
+            w.write(&value, sizeof(T));
+        }
+
+        template < typename Reader >
+        static T read(Reader& r) {
+            T value{};
+            r.read(&value, sizeof(T));
+            return value;
+        }
+    };
+
+    template < typename T, typename U >
+    struct serializer<std::pair<T, U>, std::enable_if_t<!detail::is_bitwise_serializable_v<std::pair<T, U>>>> {
+        template < typename Writer >
+        static void write(Writer& w, const std::pair<T, U>& value) {
+            serializer<std::remove_const_t<T>>::write(w, value.first);
+            serializer<std::remove_const_t<U>>::write(w, value.second);
+        }
+
+        template < typename Reader >
+        static std::pair<T, U> read(Reader& r) {
+            auto first = serializer<std::remove_const_t<T>>::read(r);
+            auto second = serializer<std::remove_const_t<U>>::read(r);
+            return {std::move(first), std::move(second)};
+        }
+    };
+
+    template < typename Char, typename Traits, typename Allocator >
+    struct serializer<std::basic_string<Char, Traits, Allocator>> {
+        using string_type = std::basic_string<Char, Traits, Allocator>;
+
+        template < typename Writer >
+        static void write(Writer& w, const string_type& value) {
+            const std::uint64_t size = value.size();
+            w.write(&size, sizeof(size));
+            w.write(value.data(), value.size() * sizeof(Char));
+        }
+
+        template < typename Reader >
+        static string_type read(Reader& r) {
+            std::uint64_t size = 0;
+            r.read(&size, sizeof(size));
+
+            // read by chunks so that a corrupted size hits the end
+            // of the stream before allocating a huge buffer
+            string_type value;
+            while ( value.size() < size ) {
+                const std::size_t offset = value.size();
+                const std::size_t chunk = static_cast<std::size_t>(
+                    std::min<std::uint64_t>(size - offset, 4096));
+                value.resize(offset + chunk);
+                r.read(&value[offset], chunk * sizeof(Char));
+            }
+            return value;
+        }
+    };
+}
+
+namespace flat_hpp
+{
+    template < typename Flat >
+    void save(std::ostream& os, const Flat& flat) {
+        using value_type = typename Flat::value_type;
+
+        if constexpr ( detail::is_bitwise_serializable_v<value_type> ) {
+            write_image(os, flat);
+        } else {
+            const image_header header = detail::make_image_header(
+                flat, image_flag_streamed, 0);
+            os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+            detail::stream_writer writer(os);
+            for ( const value_type& value : flat ) {
+                serializer<value_type>::write(writer, value);
+            }
+
+            const std::uint64_t checksum = writer.checksum();
+            os.write(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+        }
+    }
+
+    template < typename Flat >
+    void load(std::istream& is, Flat& flat, bool verify = false) {
+        using value_type = typename Flat::value_type;
+        using container_type = typename Flat::container_type;
+
+        image_header header{};
+        detail::stream_reader(is, false).read(&header, sizeof(header));
+
+        if ( header.magic != image_magic ) {
+            throw std::runtime_error("flat_hpp::load: unknown image format");
+        }
+
+        if ( header.byte_order != image_byte_order ) {
+            throw std::runtime_error("flat_hpp::load: byte order mismatch");
+        }
+
+        if ( header.version != image_version ) {
+            throw std::runtime_error("flat_hpp::load: unknown image format");
+        }
+
+        // streamed elements are read through the serializer, only
+        // the raw elements of bitwise images must match in size
+        if ( (header.flags & image_flag_streamed) == 0 && header.element_size != sizeof(value_type) ) {
+            throw std::runtime_error("flat_hpp::load: element size mismatch");
+        }
+
+        if ( header.compare_tag != detail::image_compare_tag_of<typename Flat::key_compare>() ) {
+            throw std::runtime_error("flat_hpp::load: compare tag mismatch");
+        }
+
+        if ( header.key_kind != detail::image_key_kind_of<typename Flat::key_type>() ) {
+            throw std::runtime_error("flat_hpp::load: key type mismatch");
+        }
+
+        // the image is read and checked aside, so a broken one
+        // throws before the container is touched
+        container_type data = detail::empty_container_like(flat);
+
+        const std::uint64_t count = header.element_count;
+        detail::stream_reader reader(is, verify);
+
+        if ( (header.flags & image_flag_streamed) != 0 ) {
+            for ( std::uint64_t i = 0; i < count; ++i ) {
+                data.insert(data.end(), serializer<value_type>::read(reader));
+            }
+            detail::stream_reader(is, false).read(&header.checksum, sizeof(header.checksum));
+        } else if constexpr ( detail::is_bitwise_serializable_v<value_type> ) {
+            if constexpr ( detail::is_contiguous_v<Flat> ) {
+                const std::size_t chunk = std::max<std::size_t>(1, (std::size_t{1} << 20u) / sizeof(value_type));
+                for ( std::size_t loaded = 0; loaded < count; ) {
+                    const std::size_t n = static_cast<std::size_t>(
+                        std::min<std::uint64_t>(count - loaded, chunk));
+                    data.resize(loaded + n);
+                    reader.read(data.data() + loaded, n * sizeof(value_type));
+                    loaded += n;
+                }
+            } else {
+                for ( std::uint64_t i = 0; i < count; ++i ) {
+                    value_type value{};
+                    reader.read(&value, sizeof(value));
+                    data.insert(data.end(), value);
+                }
+            }
+        } else {
+            throw std::runtime_error("flat_hpp::load: value_type is not bitwise serializable");
+        }
+
+        const bool unique_image = (header.flags & image_flag_unique) != 0;
+
+        if ( verify ) {
+            if ( header.checksum != reader.checksum() ) {
+                throw std::runtime_error("flat_hpp::load: checksum mismatch");
+            }
+
+            const bool sorted = unique_image
+                ? detail::is_sorted_unique(data.begin(), data.end(), flat.value_comp())
+                : detail::is_sorted(data.begin(), data.end(), flat.value_comp());
+
+            if ( !sorted ) {
+                throw std::runtime_error("flat_hpp::load: image is not sorted");
+            }
+        }
+
+        if ( !detail::is_multi_v<Flat> && !unique_image ) {
+            using value_compare = decltype(flat.value_comp());
+            data.erase(
+                std::unique(data.begin(), data.end(),
+                    detail::eq_compare<value_compare>(flat.value_comp())),
+                data.end());
+        }
+
+        flat.replace(std::move(data));
+    }
+}
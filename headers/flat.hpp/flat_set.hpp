@@ -8,6 +8,8 @@
 
 #include "flat_fwd.hpp"
 
+#include "detail/duplicate_policy.hpp"
+
 namespace flat_hpp
 {
     template < typename Key
@@ -84,6 +86,70 @@ namespace flat_hpp
             from_range_(sorted_unique_range, first, last);
         }
 
+        template < typename Policy
+                 , typename InputIter
+                 , typename = std::enable_if_t<detail::is_duplicate_policy_v<Policy>> >
+        flat_set(Policy policy, InputIter first, InputIter last) {
+            from_range_(policy, first, last);
+        }
+
+        template < typename Policy
+                 , typename InputIter
+                 , typename = std::enable_if_t<detail::is_duplicate_policy_v<Policy>> >
+        flat_set(Policy policy, InputIter first, InputIter last, const Compare& c)
+        : base_type(c) {
+            from_range_(policy, first, last);
+        }
+
+        template < typename Policy
+                 , typename = std::enable_if_t<detail::is_duplicate_policy_v<Policy>> >
+        flat_set(Policy policy, std::initializer_list<value_type> ilist) {
+            from_range_(policy, ilist.begin(), ilist.end());
+        }
+
+        template < typename Policy
+                 , typename = std::enable_if_t<detail::is_duplicate_policy_v<Policy>> >
+        flat_set(Policy policy, std::initializer_list<value_type> ilist, const Compare& c)
+        : base_type(c) {
+            from_range_(policy, ilist.begin(), ilist.end());
+        }
+
+        template < typename Policy
+                 , typename InputIter
+                 , typename Allocator
+                 , typename = std::enable_if_t<detail::is_duplicate_policy_v<Policy>> >
+        flat_set(Policy policy, InputIter first, InputIter last, const Allocator& a)
+        : data_(a) {
+            from_range_(policy, first, last);
+        }
+
+        template < typename Policy
+                 , typename InputIter
+                 , typename Allocator
+                 , typename = std::enable_if_t<detail::is_duplicate_policy_v<Policy>> >
+        flat_set(Policy policy, InputIter first, InputIter last, const Compare& c, const Allocator& a)
+        : base_type(c)
+        , data_(a) {
+            from_range_(policy, first, last);
+        }
+
+        template < typename Policy
+                 , typename Allocator
+                 , typename = std::enable_if_t<detail::is_duplicate_policy_v<Policy>> >
+        flat_set(Policy policy, std::initializer_list<value_type> ilist, const Allocator& a)
+        : data_(a) {
+            from_range_(policy, ilist.begin(), ilist.end());
+        }
+
+        template < typename Policy
+                 , typename Allocator
+                 , typename = std::enable_if_t<detail::is_duplicate_policy_v<Policy>> >
+        flat_set(Policy policy, std::initializer_list<value_type> ilist, const Compare& c, const Allocator& a)
+        : base_type(c)
+        , data_(a) {
+            from_range_(policy, ilist.begin(), ilist.end());
+        }
+
         template < typename InputIter, typename Allocator >
         flat_set(InputIter first, InputIter last, const Allocator& a)
         : data_(a) {
@@ -207,8 +273,17 @@ namespace flat_hpp
         flat_set& operator=(flat_set&& other) = default;
         flat_set& operator=(const flat_set& other) = default;
 
+        // the old elements are swapped aside with an empty container of the
+        // same allocator, so a throwing insert puts them back untouched
         flat_set& operator=(std::initializer_list<value_type> ilist) {
-            flat_set(ilist).swap(*this);
+            container_type data = detail::empty_container_like(*this);
+            data_.swap(data);
+            try {
+                from_range_(ilist.begin(), ilist.end());
+            } catch (...) {
+                data_.swap(data);
+                throw;
+            }
             return *this;
         }
 
@@ -301,31 +376,31 @@ namespace flat_hpp
         }
 
         std::pair<iterator, bool> insert(value_type&& value) {
-            const iterator iter = lower_bound(value);
+            const iterator iter = back_lower_bound_(value);
             return iter == end() || this->operator()(value, *iter)
                 ? std::make_pair(data_.insert(iter, std::move(value)), true)
                 : std::make_pair(iter, false);
         }
 
         std::pair<iterator, bool> insert(const value_type& value) {
-            const iterator iter = lower_bound(value);
+            const iterator iter = back_lower_bound_(value);
             return iter == end() || this->operator()(value, *iter)
                 ? std::make_pair(data_.insert(iter, value), true)
                 : std::make_pair(iter, false);
         }
 
         iterator insert(const_iterator hint, value_type&& value) {
-            return (hint == begin() || this->operator()(*(hint - 1), value))
-                && (hint == end() || this->operator()(value, *hint))
-                ? data_.insert(hint, std::move(value))
-                : insert(std::move(value)).first;
+            const iterator iter = lower_bound(hint, value);
+            return iter == end() || this->operator()(value, *iter)
+                ? data_.insert(iter, std::move(value))
+                : iter;
         }
 
         iterator insert(const_iterator hint, const value_type& value) {
-            return (hint == begin() || this->operator()(*(hint - 1), value))
-                && (hint == end() || this->operator()(value, *hint))
-                ? data_.insert(hint, value)
-                : insert(value).first;
+            const iterator iter = lower_bound(hint, value);
+            return iter == end() || this->operator()(value, *iter)
+                ? data_.insert(iter, value)
+                : iter;
         }
 
         template < typename InputIter >
@@ -346,14 +421,49 @@ namespace flat_hpp
             insert_range_(sorted_range, ilist.begin(), ilist.end());
         }
 
+        template < typename Policy, typename InputIter >
+        std::enable_if_t<detail::is_duplicate_policy_v<Policy>>
+        insert(Policy policy, InputIter first, InputIter last) {
+            insert_range_(policy, first, last);
+        }
+
+        template < typename Policy >
+        std::enable_if_t<detail::is_duplicate_policy_v<Policy>>
+        insert(Policy policy, std::initializer_list<value_type> ilist) {
+            insert_range_(policy, ilist.begin(), ilist.end());
+        }
+
         template < typename... Args >
         std::pair<iterator, bool> emplace(Args&&... args) {
-            return insert(value_type(std::forward<Args>(args)...));
+            if constexpr ( detail::is_set_emplace_key_v<key_type, Args...> ) {
+                return insert(std::forward<Args>(args)...);
+            } else {
+                return insert(value_type(std::forward<Args>(args)...));
+            }
         }
 
         template < typename... Args >
         iterator emplace_hint(const_iterator hint, Args&&... args) {
-            return insert(hint, value_type(std::forward<Args>(args)...));
+            if constexpr ( detail::is_set_emplace_key_v<key_type, Args...> ) {
+                return insert(hint, std::forward<Args>(args)...);
+            } else {
+                return insert(hint, value_type(std::forward<Args>(args)...));
+            }
+        }
+
+        template < typename... Args >
+        iterator emplace_back_unchecked(Args&&... args) {
+            data_.emplace_back(std::forward<Args>(args)...);
+            assert(size() < 2 || this->operator()(*(end() - 2), data_.back()));
+            return end() - 1;
+        }
+
+        iterator append(value_type&& value) {
+            return emplace_back_unchecked(std::move(value));
+        }
+
+        iterator append(const value_type& value) {
+            return emplace_back_unchecked(value);
         }
 
         void clear()
@@ -376,6 +486,29 @@ namespace flat_hpp
                 : 0;
         }
 
+        template < typename Runs >
+        void assign_merged(const Runs& runs) {
+            data_.clear();
+            detail::kway_merge(detail::collect_runs(runs), value_comp(), true, data_);
+        }
+
+        container_type extract() && {
+            container_type data = std::move(data_);
+            data_.clear();
+            return data;
+        }
+
+        void replace(container_type&& data) {
+            assert(detail::is_sorted_unique(data.begin(), data.end(), key_comp()));
+            data_ = std::move(data);
+        }
+
+        template < typename C = container_type >
+        auto get_allocator() const
+        -> decltype(std::declval<const C&>().get_allocator()) {
+            return data_.get_allocator();
+        }
+
         void swap(flat_set& other)
             noexcept(std::is_nothrow_swappable_v<base_type>
                 && std::is_nothrow_swappable_v<container_type>)
@@ -450,11 +583,11 @@ namespace flat_hpp
         }
 
         std::pair<iterator, iterator> equal_range(const key_type& key) {
-            return std::equal_range(begin(), end(), key, key_comp());
+            return detail::search_equal_range(begin(), end(), key, key_comp());
         }
 
         std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const {
-            return std::equal_range(begin(), end(), key, key_comp());
+            return detail::search_equal_range(begin(), end(), key, key_comp());
         }
 
         template < typename K >
@@ -462,7 +595,7 @@ namespace flat_hpp
             detail::is_transparent_v<Compare, K>,
             std::pair<iterator, iterator>>
         equal_range(const K& key) {
-            return std::equal_range(begin(), end(), key, key_comp());
+            return detail::search_equal_range(begin(), end(), key, key_comp());
         }
 
         template < typename K >
@@ -470,15 +603,15 @@ namespace flat_hpp
             detail::is_transparent_v<Compare, K>,
             std::pair<const_iterator, const_iterator>>
         equal_range(const K& key) const {
-            return std::equal_range(begin(), end(), key, key_comp());
+            return detail::search_equal_range(begin(), end(), key, key_comp());
         }
 
         iterator lower_bound(const key_type& key) {
-            return std::lower_bound(begin(), end(), key, key_comp());
+            return detail::search_lower_bound(begin(), end(), key, key_comp());
         }
 
         const_iterator lower_bound(const key_type& key) const {
-            return std::lower_bound(begin(), end(), key, key_comp());
+            return detail::search_lower_bound(begin(), end(), key, key_comp());
         }
 
         template < typename K >
@@ -486,7 +619,7 @@ namespace flat_hpp
             detail::is_transparent_v<Compare, K>,
             iterator>
         lower_bound(const K& key) {
-            return std::lower_bound(begin(), end(), key, key_comp());
+            return detail::search_lower_bound(begin(), end(), key, key_comp());
         }
 
         template < typename K >
@@ -494,15 +627,15 @@ namespace flat_hpp
             detail::is_transparent_v<Compare, K>,
             const_iterator>
         lower_bound(const K& key) const {
-            return std::lower_bound(begin(), end(), key, key_comp());
+            return detail::search_lower_bound(begin(), end(), key, key_comp());
         }
 
         iterator upper_bound(const key_type& key) {
-            return std::upper_bound(begin(), end(), key, key_comp());
+            return detail::search_upper_bound(begin(), end(), key, key_comp());
         }
 
         const_iterator upper_bound(const key_type& key) const {
-            return std::upper_bound(begin(), end(), key, key_comp());
+            return detail::search_upper_bound(begin(), end(), key, key_comp());
         }
 
         template < typename K >
@@ -510,7 +643,7 @@ namespace flat_hpp
             detail::is_transparent_v<Compare, K>,
             iterator>
         upper_bound(const K& key) {
-            return std::upper_bound(begin(), end(), key, key_comp());
+            return detail::search_upper_bound(begin(), end(), key, key_comp());
         }
 
         template < typename K >
@@ -518,7 +651,169 @@ namespace flat_hpp
             detail::is_transparent_v<Compare, K>,
             const_iterator>
         upper_bound(const K& key) const {
-            return std::upper_bound(begin(), end(), key, key_comp());
+            return detail::search_upper_bound(begin(), end(), key, key_comp());
+        }
+
+        iterator find(const_iterator hint, const key_type& key) {
+            const iterator iter = lower_bound(hint, key);
+            return iter != end() && !this->operator()(key, *iter)
+                ? iter
+                : end();
+        }
+
+        const_iterator find(const_iterator hint, const key_type& key) const {
+            const const_iterator iter = lower_bound(hint, key);
+            return iter != end() && !this->operator()(key, *iter)
+                ? iter
+                : end();
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            iterator>
+        find(const_iterator hint, const K& key) {
+            const iterator iter = lower_bound(hint, key);
+            return iter != end() && !this->operator()(key, *iter)
+                ? iter
+                : end();
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            const_iterator>
+        find(const_iterator hint, const K& key) const {
+            const const_iterator iter = lower_bound(hint, key);
+            return iter != end() && !this->operator()(key, *iter)
+                ? iter
+                : end();
+        }
+
+        iterator lower_bound(const_iterator hint, const key_type& key) {
+            const base_type& comp = *this;
+            return detail::gallop_lower_bound(begin(), end(), begin() + (hint - cbegin()), key, comp);
+        }
+
+        const_iterator lower_bound(const_iterator hint, const key_type& key) const {
+            const base_type& comp = *this;
+            return detail::gallop_lower_bound(begin(), end(), hint, key, comp);
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            iterator>
+        lower_bound(const_iterator hint, const K& key) {
+            const base_type& comp = *this;
+            return detail::gallop_lower_bound(begin(), end(), begin() + (hint - cbegin()), key, comp);
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            const_iterator>
+        lower_bound(const_iterator hint, const K& key) const {
+            const base_type& comp = *this;
+            return detail::gallop_lower_bound(begin(), end(), hint, key, comp);
+        }
+
+        detail::range_view<iterator> range(const key_type& lo, const key_type& hi) {
+            const iterator first = lower_bound(lo);
+            return {first, std::max(first, lower_bound(hi))};
+        }
+
+        detail::range_view<const_iterator> range(const key_type& lo, const key_type& hi) const {
+            const const_iterator first = lower_bound(lo);
+            return {first, std::max(first, lower_bound(hi))};
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            detail::range_view<iterator>>
+        range(const K& lo, const K& hi) {
+            const iterator first = lower_bound(lo);
+            return {first, std::max(first, lower_bound(hi))};
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            detail::range_view<const_iterator>>
+        range(const K& lo, const K& hi) const {
+            const const_iterator first = lower_bound(lo);
+            return {first, std::max(first, lower_bound(hi))};
+        }
+
+        detail::range_view<iterator> range_from(const key_type& lo) {
+            return {lower_bound(lo), end()};
+        }
+
+        detail::range_view<const_iterator> range_from(const key_type& lo) const {
+            return {lower_bound(lo), end()};
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            detail::range_view<iterator>>
+        range_from(const K& lo) {
+            return {lower_bound(lo), end()};
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            detail::range_view<const_iterator>>
+        range_from(const K& lo) const {
+            return {lower_bound(lo), end()};
+        }
+
+        iterator nth(size_type index)
+        noexcept {
+            assert(index <= size());
+            return begin() + static_cast<difference_type>(index);
+        }
+
+        const_iterator nth(size_type index) const
+        noexcept {
+            assert(index <= size());
+            return begin() + static_cast<difference_type>(index);
+        }
+
+        size_type index_of(const_iterator iter) const
+        noexcept {
+            assert(iter >= begin() && iter <= end());
+            return static_cast<size_type>(iter - begin());
+        }
+
+        size_type rank(const key_type& key) const {
+            return index_of(lower_bound(key));
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            size_type>
+        rank(const K& key) const {
+            return index_of(lower_bound(key));
+        }
+
+        size_type count_range(const key_type& lo, const key_type& hi) const {
+            const size_type first = rank(lo);
+            const size_type last = rank(hi);
+            return first < last ? last - first : 0;
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            size_type>
+        count_range(const K& lo, const K& hi) const {
+            const size_type first = rank(lo);
+            const size_type last = rank(hi);
+            return first < last ? last - first : 0;
         }
 
         key_compare key_comp() const {
@@ -529,6 +824,13 @@ namespace flat_hpp
             return value_compare(key_comp());
         }
     private:
+        template < typename K >
+        iterator back_lower_bound_(const K& key) {
+            return data_.empty() || this->operator()(data_.back(), key)
+                ? end()
+                : lower_bound(key);
+        }
+
         template < typename Iter >
         void from_range_(Iter first, Iter last) {
             assert(data_.empty());
@@ -579,6 +881,51 @@ namespace flat_hpp
                     detail::eq_compare<key_compare>(key_comp())),
                 data_.end());
         }
+
+        template < typename Policy, typename Iter >
+        void from_range_(Policy& policy, Iter first, Iter last) {
+            assert(data_.empty());
+            insert_range_(policy, first, last);
+        }
+
+        template < typename Policy, typename Iter >
+        void insert_range_(Policy& policy, Iter first, Iter last) {
+            static_assert(
+                !detail::is_combine_policy_v<Policy>,
+                "flat_hpp::flat_set: combine can change the keys, it is for the map containers only");
+
+            const base_type& comp = *this;
+            const auto mid = data_.insert(data_.end(), first, last);
+            std::stable_sort(mid, data_.end(), value_comp());
+
+            // one pass over the sorted tail: each run of equal keys is resolved
+            // in input order into the existing element or into the first element
+            // of the run, which is then compacted towards mid
+            auto existing = data_.begin();
+            auto out = mid;
+            for ( auto iter = mid; iter != data_.end(); ) {
+                existing = detail::gallop_lower_bound(existing, mid, existing, *iter, comp);
+                const bool found = existing != mid && !comp(*iter, *existing);
+                const auto target = found ? existing : iter;
+
+                auto next = found ? iter : iter + 1;
+                for ( ; next != data_.end() && !comp(*target, *next); ++next ) {
+                    detail::resolve_duplicate(policy, *target, std::move(*next));
+                }
+
+                if ( !found ) {
+                    if ( out != iter ) {
+                        *out = std::move(*iter);
+                    }
+                    ++out;
+                }
+
+                iter = next;
+            }
+
+            data_.erase(out, data_.end());
+            std::inplace_merge(data_.begin(), mid, data_.end(), value_comp());
+        }
     private:
         container_type data_;
     };
@@ -0,0 +1,497 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "flat_fwd.hpp"
+
+#include <iterator>
+#include <limits>
+#include <memory>
+
+namespace flat_hpp
+{
+    template < typename T
+             , typename Allocator >
+    class gap_vector {
+        using alloc_traits = std::allocator_traits<Allocator>;
+
+        template < bool Const >
+        class basic_iterator;
+    public:
+        using value_type = T;
+        using allocator_type = Allocator;
+
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using pointer = typename alloc_traits::pointer;
+        using const_pointer = typename alloc_traits::const_pointer;
+
+        using iterator = basic_iterator<false>;
+        using const_iterator = basic_iterator<true>;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    public:
+        gap_vector() = default;
+
+        explicit gap_vector(const Allocator& a)
+        : alloc_(a) {}
+
+        template < typename InputIter >
+        gap_vector(InputIter first, InputIter last, const Allocator& a = Allocator())
+        : alloc_(a) {
+            insert(end(), first, last);
+        }
+
+        gap_vector(std::initializer_list<T> ilist, const Allocator& a = Allocator())
+        : alloc_(a) {
+            insert(end(), ilist.begin(), ilist.end());
+        }
+
+        gap_vector(gap_vector&& other) noexcept
+        : alloc_(std::move(other.alloc_)) {
+            steal_(other);
+        }
+
+        gap_vector(const gap_vector& other)
+        : alloc_(alloc_traits::select_on_container_copy_construction(other.alloc_)) {
+            insert(end(), other.begin(), other.end());
+        }
+
+        ~gap_vector() {
+            deallocate_();
+        }
+
+        gap_vector& operator=(gap_vector&& other)
+            noexcept(alloc_traits::propagate_on_container_move_assignment::value
+                || alloc_traits::is_always_equal::value)
+        {
+            if ( this == &other ) {
+                return *this;
+            }
+            if constexpr ( alloc_traits::propagate_on_container_move_assignment::value ) {
+                deallocate_();
+                alloc_ = std::move(other.alloc_);
+                steal_(other);
+            } else {
+                if ( alloc_ == other.alloc_ ) {
+                    deallocate_();
+                    steal_(other);
+                } else {
+                    clear();
+                    insert(end(),
+                        std::make_move_iterator(other.begin()),
+                        std::make_move_iterator(other.end()));
+                    other.clear();
+                }
+            }
+            return *this;
+        }
+
+        gap_vector& operator=(const gap_vector& other) {
+            if ( this == &other ) {
+                return *this;
+            }
+            if constexpr ( alloc_traits::propagate_on_container_copy_assignment::value ) {
+                if ( alloc_ != other.alloc_ ) {
+                    deallocate_();
+                }
+                alloc_ = other.alloc_;
+            }
+            clear();
+            insert(end(), other.begin(), other.end());
+            return *this;
+        }
+
+        gap_vector& operator=(std::initializer_list<T> ilist) {
+            clear();
+            insert(end(), ilist.begin(), ilist.end());
+            return *this;
+        }
+
+        allocator_type get_allocator() const {
+            return alloc_;
+        }
+
+        iterator begin() noexcept { return iterator(this, 0); }
+        const_iterator begin() const noexcept { return const_iterator(this, 0); }
+        const_iterator cbegin() const noexcept { return const_iterator(this, 0); }
+
+        iterator end() noexcept { return iterator(this, size()); }
+        const_iterator end() const noexcept { return const_iterator(this, size()); }
+        const_iterator cend() const noexcept { return const_iterator(this, size()); }
+
+        reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+        const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+        const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(end()); }
+
+        reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+        const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+        const_reverse_iterator crend() const noexcept { return const_reverse_iterator(begin()); }
+
+        bool empty() const
+        noexcept {
+            return size() == 0;
+        }
+
+        size_type size() const
+        noexcept {
+            return capacity_ - (gap_last_ - gap_first_);
+        }
+
+        size_type max_size() const
+        noexcept {
+            return std::min<size_type>(
+                alloc_traits::max_size(alloc_),
+                static_cast<size_type>(std::numeric_limits<difference_type>::max()));
+        }
+
+        size_type capacity() const
+        noexcept {
+            return capacity_;
+        }
+
+        size_type gap_position() const
+        noexcept {
+            return gap_first_;
+        }
+
+        void reserve(size_type ncapacity) {
+            if ( ncapacity > capacity_ ) {
+                reallocate_(ncapacity, gap_first_);
+            }
+        }
+
+        void shrink_to_fit() {
+            if ( capacity_ > size() ) {
+                reallocate_(size(), size());
+            }
+        }
+
+        reference operator[](size_type index) noexcept {
+            return at_(index);
+        }
+
+        const_reference operator[](size_type index) const noexcept {
+            return at_(index);
+        }
+
+        reference front() noexcept {
+            return at_(0);
+        }
+
+        const_reference front() const noexcept {
+            return at_(0);
+        }
+
+        reference back() noexcept {
+            return at_(size() - 1);
+        }
+
+        const_reference back() const noexcept {
+            return at_(size() - 1);
+        }
+
+        template < typename... Args >
+        iterator emplace(const_iterator pos, Args&&... args) {
+            // the arguments may refer to elements which
+            // are moved by the gap, so the value is built first
+            T value(std::forward<Args>(args)...);
+            const size_type index = pos.index_;
+            open_gap_(index, 1);
+            alloc_traits::construct(alloc_, buffer_ + gap_first_, std::move(value));
+            ++gap_first_;
+            return iterator(this, index);
+        }
+
+        iterator insert(const_iterator pos, T&& value) {
+            return emplace(pos, std::move(value));
+        }
+
+        iterator insert(const_iterator pos, const T& value) {
+            return emplace(pos, value);
+        }
+
+        template < typename InputIter >
+        iterator insert(const_iterator pos, InputIter first, InputIter last) {
+            using category = typename std::iterator_traits<InputIter>::iterator_category;
+            const size_type index = pos.index_;
+            if constexpr ( std::is_base_of_v<std::forward_iterator_tag, category> ) {
+                const size_type count = static_cast<size_type>(std::distance(first, last));
+                open_gap_(index, count);
+                for ( ; first != last; ++first ) {
+                    alloc_traits::construct(alloc_, buffer_ + gap_first_, *first);
+                    ++gap_first_;
+                }
+            } else {
+                for ( size_type i = index; first != last; ++first, ++i ) {
+                    emplace(const_iterator(this, i), *first);
+                }
+            }
+            return iterator(this, index);
+        }
+
+        iterator insert(const_iterator pos, std::initializer_list<T> ilist) {
+            return insert(pos, ilist.begin(), ilist.end());
+        }
+
+        template < typename... Args >
+        reference emplace_back(Args&&... args) {
+            return *emplace(cend(), std::forward<Args>(args)...);
+        }
+
+        void push_back(T&& value) {
+            emplace(cend(), std::move(value));
+        }
+
+        void push_back(const T& value) {
+            emplace(cend(), value);
+        }
+
+        void pop_back() {
+            erase(cend() - 1);
+        }
+
+        iterator erase(const_iterator pos) {
+            return erase(pos, pos + 1);
+        }
+
+        iterator erase(const_iterator first, const_iterator last) {
+            const size_type index = first.index_;
+            const size_type count = last.index_ - first.index_;
+            move_gap_(index);
+            for ( size_type i = 0; i < count; ++i ) {
+                alloc_traits::destroy(alloc_, buffer_ + gap_last_);
+                ++gap_last_;
+            }
+            return iterator(this, index);
+        }
+
+        // destroys the elements on both sides of the gap in place
+        void clear() noexcept {
+            for ( size_type i = 0; i < gap_first_; ++i ) {
+                alloc_traits::destroy(alloc_, buffer_ + i);
+            }
+            for ( size_type i = gap_last_; i < capacity_; ++i ) {
+                alloc_traits::destroy(alloc_, buffer_ + i);
+            }
+            gap_first_ = 0;
+            gap_last_ = capacity_;
+        }
+
+        void swap(gap_vector& other) noexcept {
+            using std::swap;
+            if constexpr ( alloc_traits::propagate_on_container_swap::value ) {
+                swap(alloc_, other.alloc_);
+            }
+            swap(buffer_, other.buffer_);
+            swap(capacity_, other.capacity_);
+            swap(gap_first_, other.gap_first_);
+            swap(gap_last_, other.gap_last_);
+        }
+    private:
+        T& at_(size_type index) const noexcept {
+            assert(index < size());
+            return buffer_[index < gap_first_ ? index : index + (gap_last_ - gap_first_)];
+        }
+
+        // moves the gap so that it starts at the given logical position,
+        // costs O(d) where d is the distance from the previous position,
+        // a throwing move leaves the gap between the two positions
+        void move_gap_(size_type index) {
+            const size_type gap = gap_last_ - gap_first_;
+            while ( gap_first_ > index ) {
+                --gap_first_;
+                --gap_last_;
+                alloc_traits::construct(alloc_, buffer_ + gap_last_, std::move(buffer_[gap_first_]));
+                alloc_traits::destroy(alloc_, buffer_ + gap_first_);
+            }
+            while ( gap_first_ < index ) {
+                alloc_traits::construct(alloc_, buffer_ + gap_first_, std::move(buffer_[gap_last_]));
+                alloc_traits::destroy(alloc_, buffer_ + gap_last_);
+                ++gap_first_;
+                ++gap_last_;
+            }
+            assert(gap_last_ - gap_first_ == gap);
+            (void)gap;
+        }
+
+        void open_gap_(size_type index, size_type count) {
+            if ( gap_last_ - gap_first_ < count ) {
+                reallocate_(std::max(capacity_ * 2, std::max<size_type>(size() + count, 16)), index);
+            } else {
+                move_gap_(index);
+            }
+        }
+
+        void reallocate_(size_type ncapacity, size_type gap_index) {
+            const size_type count = size();
+            T* nbuffer = alloc_traits::allocate(alloc_, ncapacity);
+            const size_type tail = count - gap_index;
+            const auto to = [ncapacity, gap_index, tail](size_type i) noexcept {
+                return i < gap_index ? i : ncapacity - tail + (i - gap_index);
+            };
+            size_type constructed = 0;
+            try {
+                for ( ; constructed < count; ++constructed ) {
+                    alloc_traits::construct(alloc_,
+                        nbuffer + to(constructed),
+                        std::move_if_noexcept(at_(constructed)));
+                }
+            } catch (...) {
+                for ( size_type i = 0; i < constructed; ++i ) {
+                    alloc_traits::destroy(alloc_, nbuffer + to(i));
+                }
+                alloc_traits::deallocate(alloc_, nbuffer, ncapacity);
+                throw;
+            }
+            deallocate_();
+            buffer_ = nbuffer;
+            capacity_ = ncapacity;
+            gap_first_ = gap_index;
+            gap_last_ = ncapacity - tail;
+        }
+
+        void deallocate_() noexcept {
+            if ( buffer_ ) {
+                clear();
+                alloc_traits::deallocate(alloc_, buffer_, capacity_);
+                buffer_ = nullptr;
+                capacity_ = 0;
+                gap_first_ = 0;
+                gap_last_ = 0;
+            }
+        }
+
+        void steal_(gap_vector& other) noexcept {
+            buffer_ = std::exchange(other.buffer_, nullptr);
+            capacity_ = std::exchange(other.capacity_, 0);
+            gap_first_ = std::exchange(other.gap_first_, 0);
+            gap_last_ = std::exchange(other.gap_last_, 0);
+        }
+    private:
+        Allocator alloc_;
+        T* buffer_ = nullptr;
+        size_type capacity_ = 0;
+        size_type gap_first_ = 0;
+        size_type gap_last_ = 0;
+    };
+
+    template < typename T
+             , typename Allocator >
+    template < bool Const >
+    class gap_vector<T, Allocator>::basic_iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const T*, T*>;
+        using reference = std::conditional_t<Const, const T&, T&>;
+    public:
+        basic_iterator() = default;
+
+        template < bool C = Const, typename = std::enable_if_t<C> >
+        basic_iterator(const basic_iterator<false>& other) noexcept
+        : vector_(other.vector_)
+        , index_(other.index_) {}
+
+        reference operator*() const noexcept {
+            return vector_->at_(index_);
+        }
+
+        pointer operator->() const noexcept {
+            return &vector_->at_(index_);
+        }
+
+        reference operator[](difference_type n) const noexcept {
+            return *(*this + n);
+        }
+
+        basic_iterator& operator++() noexcept { ++index_; return *this; }
+        basic_iterator& operator--() noexcept { --index_; return *this; }
+        basic_iterator operator++(int) noexcept { basic_iterator iter = *this; ++index_; return iter; }
+        basic_iterator operator--(int) noexcept { basic_iterator iter = *this; --index_; return iter; }
+
+        basic_iterator& operator+=(difference_type n) noexcept {
+            index_ = static_cast<size_type>(static_cast<difference_type>(index_) + n);
+            return *this;
+        }
+
+        basic_iterator& operator-=(difference_type n) noexcept {
+            return *this += -n;
+        }
+
+        friend basic_iterator operator+(basic_iterator iter, difference_type n) noexcept { return iter += n; }
+        friend basic_iterator operator+(difference_type n, basic_iterator iter) noexcept { return iter += n; }
+        friend basic_iterator operator-(basic_iterator iter, difference_type n) noexcept { return iter -= n; }
+
+        friend difference_type operator-(const basic_iterator& l, const basic_iterator& r) noexcept {
+            return static_cast<difference_type>(l.index_) - static_cast<difference_type>(r.index_);
+        }
+
+        friend bool operator==(const basic_iterator& l, const basic_iterator& r) noexcept { return l.index_ == r.index_; }
+        friend bool operator!=(const basic_iterator& l, const basic_iterator& r) noexcept { return l.index_ != r.index_; }
+        friend bool operator<(const basic_iterator& l, const basic_iterator& r) noexcept { return l.index_ < r.index_; }
+        friend bool operator>(const basic_iterator& l, const basic_iterator& r) noexcept { return l.index_ > r.index_; }
+        friend bool operator<=(const basic_iterator& l, const basic_iterator& r) noexcept { return l.index_ <= r.index_; }
+        friend bool operator>=(const basic_iterator& l, const basic_iterator& r) noexcept { return l.index_ >= r.index_; }
+    private:
+        friend class gap_vector;
+        template < bool > friend class basic_iterator;
+
+        using vector_pointer = std::conditional_t<Const, const gap_vector*, gap_vector*>;
+
+        basic_iterator(vector_pointer vector, size_type index) noexcept
+        : vector_(vector)
+        , index_(index) {}
+    private:
+        vector_pointer vector_ = nullptr;
+        size_type index_ = 0;
+    };
+}
+
+namespace flat_hpp
+{
+    template < typename T
+             , typename Allocator >
+    void swap(
+        gap_vector<T, Allocator>& l,
+        gap_vector<T, Allocator>& r) noexcept
+    {
+        l.swap(r);
+    }
+
+    template < typename T
+             , typename Allocator >
+    bool operator==(
+        const gap_vector<T, Allocator>& l,
+        const gap_vector<T, Allocator>& r)
+    {
+        return l.size() == r.size()
+            && std::equal(l.begin(), l.end(), r.begin());
+    }
+
+    template < typename T
+             , typename Allocator >
+    bool operator!=(
+        const gap_vector<T, Allocator>& l,
+        const gap_vector<T, Allocator>& r)
+    {
+        return !(l == r);
+    }
+
+    template < typename T
+             , typename Allocator >
+    bool operator<(
+        const gap_vector<T, Allocator>& l,
+        const gap_vector<T, Allocator>& r)
+    {
+        return std::lexicographical_compare(l.begin(), l.end(), r.begin(), r.end());
+    }
+}
@@ -0,0 +1,187 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "flat_fwd.hpp"
+
+#include <cstdint>
+#include <limits>
+
+#include "detail/is_multi.hpp"
+
+namespace flat_hpp
+{
+    template < typename Flat >
+    class learned_index {
+    public:
+        using flat_type = Flat;
+
+        using key_type = typename Flat::key_type;
+        using value_type = typename Flat::value_type;
+        using size_type = typename Flat::size_type;
+        using difference_type = typename Flat::difference_type;
+        using const_iterator = typename Flat::const_iterator;
+
+        static constexpr size_type default_epsilon = 32;
+
+        static_assert(
+            std::is_arithmetic_v<key_type>,
+            "flat_hpp::learned_index: key_type must be an arithmetic type");
+
+        static_assert(
+            std::is_same_v<typename Flat::key_compare, std::less<key_type>> ||
+            std::is_same_v<typename Flat::key_compare, std::less<>>,
+            "flat_hpp::learned_index: key_compare must be std::less");
+
+        static_assert(
+            !detail::is_multi_v<Flat>,
+            "flat_hpp::learned_index: keys must be unique");
+    public:
+        explicit learned_index(const Flat& flat, size_type epsilon = default_epsilon)
+        : flat_(&flat)
+        , epsilon_(epsilon) {
+            rebuild();
+        }
+
+        void rebuild() {
+            segments_.clear();
+            build_();
+        }
+
+        const_iterator lower_bound(const key_type& key) const {
+            if ( segments_.empty() || key < segments_.front().key ) {
+                return flat_->begin();
+            }
+
+            const auto segment_iter = std::upper_bound(
+                segments_.begin(), segments_.end(), key,
+                [](const key_type& l, const segment& r){ return l < r.key; }) - 1;
+
+            const size_type first = segment_iter->first;
+            const size_type last = segment_iter + 1 != segments_.end()
+                ? (segment_iter + 1)->first
+                : flat_->size();
+
+            // the model is exact up to epsilon for every key of the
+            // segment, one more position on each side covers rounding
+            // and keys which fall between the indexed ones
+            const double predicted = static_cast<double>(first)
+                + segment_iter->slope * distance_(segment_iter->key, key);
+            const size_type position = predicted < static_cast<double>(last)
+                ? std::max(first, static_cast<size_type>(predicted))
+                : last;
+
+            const size_type lo = position > first + epsilon_ + 1
+                ? position - epsilon_ - 1
+                : first;
+            const size_type hi = std::min(last, position + epsilon_ + 2);
+
+            return std::lower_bound(
+                flat_->begin() + static_cast<difference_type>(lo),
+                flat_->begin() + static_cast<difference_type>(hi),
+                key,
+                [](const value_type& l, const key_type& r){ return key_of_(l) < r; });
+        }
+
+        const_iterator find(const key_type& key) const {
+            const const_iterator iter = lower_bound(key);
+            return iter != flat_->end() && !(key < key_of_(*iter))
+                ? iter
+                : flat_->end();
+        }
+
+        bool contains(const key_type& key) const {
+            return find(key) != flat_->end();
+        }
+
+        size_type epsilon() const
+        noexcept {
+            return epsilon_;
+        }
+
+        size_type segment_count() const
+        noexcept {
+            return segments_.size();
+        }
+
+        size_type memory_usage() const
+        noexcept {
+            return segments_.size() * sizeof(segment);
+        }
+    private:
+        struct segment {
+            key_type key;
+            double slope;
+            size_type first;
+        };
+
+        static const key_type& key_of_(const value_type& value) noexcept {
+            if constexpr ( std::is_same_v<key_type, value_type> ) {
+                return value;
+            } else {
+                return value.first;
+            }
+        }
+
+        static double distance_(const key_type& from, const key_type& to) noexcept {
+            if constexpr ( std::is_integral_v<key_type> ) {
+                // the difference is taken in uint64_t, so it never overflows
+                return static_cast<double>(
+                    static_cast<std::uint64_t>(to) - static_cast<std::uint64_t>(from));
+            } else {
+                return static_cast<double>(to) - static_cast<double>(from);
+            }
+        }
+
+        void build_() {
+            // greedy shrinking cone: a segment grows while some slope keeps
+            // every position within epsilon of the line from its first key
+            const double epsilon = static_cast<double>(epsilon_);
+            const auto first = flat_->begin();
+
+            double lo_slope = 0.0;
+            double hi_slope = std::numeric_limits<double>::infinity();
+
+            for ( size_type i = 0; i < flat_->size(); ++i ) {
+                const key_type& key = key_of_(first[static_cast<difference_type>(i)]);
+                if ( i > 0 ) {
+                    const segment& back = segments_.back();
+                    const double dx = distance_(back.key, key);
+                    const double dy = static_cast<double>(i - back.first);
+                    const double lo = (dy - epsilon) / dx;
+                    const double hi = (dy + epsilon) / dx;
+
+                    if ( lo <= hi_slope && hi >= lo_slope ) {
+                        lo_slope = std::max(lo_slope, lo);
+                        hi_slope = std::min(hi_slope, hi);
+                        continue;
+                    }
+
+                    close_segment_(lo_slope, hi_slope);
+                }
+
+                segments_.push_back(segment{key, 0.0, i});
+                lo_slope = 0.0;
+                hi_slope = std::numeric_limits<double>::infinity();
+            }
+
+            if ( !segments_.empty() ) {
+                close_segment_(lo_slope, hi_slope);
+            }
+        }
+
+        void close_segment_(double lo_slope, double hi_slope) noexcept {
+            segments_.back().slope = hi_slope < std::numeric_limits<double>::infinity()
+                ? (lo_slope + hi_slope) * 0.5
+                : lo_slope;
+        }
+    private:
+        const Flat* flat_ = nullptr;
+        size_type epsilon_ = default_epsilon;
+        std::vector<segment> segments_;
+    };
+}
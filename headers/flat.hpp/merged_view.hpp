@@ -0,0 +1,271 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "flat_fwd.hpp"
+
+#include <iterator>
+#include <optional>
+
+#include "detail/container_traits.hpp"
+#include "detail/is_multi.hpp"
+
+namespace flat_hpp
+{
+    template < typename Flat
+             , typename Tombstone >
+    class merged_view {
+        class const_iterator_impl;
+    public:
+        using flat_type = Flat;
+
+        using key_type = typename Flat::key_type;
+        using value_type = typename Flat::value_type;
+        using size_type = typename Flat::size_type;
+
+        using key_compare = typename Flat::key_compare;
+        using value_compare = typename Flat::value_compare;
+        using tombstone_predicate = Tombstone;
+
+        using const_iterator = const_iterator_impl;
+
+        static_assert(
+            !detail::is_multi_v<Flat>,
+            "flat_hpp::merged_view: keys must be unique");
+    public:
+        // the levels go from the newest to the oldest one, an element
+        // of a newer level hides the equivalent ones of the older levels
+        explicit merged_view(std::vector<const Flat*> levels, const Tombstone& tombstone = Tombstone())
+        : levels_(std::move(levels))
+        , tombstone_(tombstone)
+        , comp_(levels_.empty()
+            ? Flat().value_comp()
+            : levels_.front()->value_comp()) {}
+
+        size_type level_count() const
+        noexcept {
+            return levels_.size();
+        }
+
+        const Flat& level(size_type index) const
+        noexcept {
+            assert(index < levels_.size());
+            return *levels_[index];
+        }
+
+        const_iterator begin() const {
+            std::vector<run_type> runs;
+            runs.reserve(levels_.size());
+            for ( const Flat* level : levels_ ) {
+                runs.emplace_back(level->begin(), level->end());
+            }
+            return const_iterator(this, std::move(runs));
+        }
+
+        const_iterator cbegin() const {
+            return begin();
+        }
+
+        const_iterator end() const
+        noexcept {
+            return const_iterator();
+        }
+
+        const_iterator cend() const
+        noexcept {
+            return const_iterator();
+        }
+
+        bool empty() const {
+            return begin() == end();
+        }
+
+        // probes the levels from the newest one, the first level
+        // with the key decides, a tombstone there means no element
+        const value_type* find(const key_type& key) const {
+            for ( const Flat* level : levels_ ) {
+                const auto iter = level->find(key);
+                if ( iter != level->end() ) {
+                    return tombstone_(*iter) ? nullptr : &*iter;
+                }
+            }
+            return nullptr;
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<key_compare, K>,
+            const value_type*>
+        find(const K& key) const {
+            for ( const Flat* level : levels_ ) {
+                const auto iter = level->find(key);
+                if ( iter != level->end() ) {
+                    return tombstone_(*iter) ? nullptr : &*iter;
+                }
+            }
+            return nullptr;
+        }
+
+        bool contains(const key_type& key) const {
+            return find(key) != nullptr;
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<key_compare, K>,
+            bool>
+        contains(const K& key) const {
+            return find(key) != nullptr;
+        }
+
+        const_iterator lower_bound(const key_type& key) const {
+            std::vector<run_type> runs;
+            runs.reserve(levels_.size());
+            for ( const Flat* level : levels_ ) {
+                runs.emplace_back(level->lower_bound(key), level->end());
+            }
+            return const_iterator(this, std::move(runs));
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<key_compare, K>,
+            const_iterator>
+        lower_bound(const K& key) const {
+            std::vector<run_type> runs;
+            runs.reserve(levels_.size());
+            for ( const Flat* level : levels_ ) {
+                runs.emplace_back(level->lower_bound(key), level->end());
+            }
+            return const_iterator(this, std::move(runs));
+        }
+
+        // merges all the levels into a single container without tombstones,
+        // the result takes the allocator of the first level
+        Flat compact() const {
+            Flat flat = empty_flat_();
+            typename Flat::container_type data = detail::empty_container_like(flat);
+
+            size_type capacity = 0;
+            for ( const Flat* level : levels_ ) {
+                capacity += level->size();
+            }
+            detail::reserve_if_possible(data, capacity);
+
+            for ( const value_type& value : *this ) {
+                data.push_back(value);
+            }
+            flat.replace(std::move(data));
+            return flat;
+        }
+
+        key_compare key_comp() const {
+            return levels_.empty() ? key_compare() : levels_.front()->key_comp();
+        }
+
+        value_compare value_comp() const {
+            return comp_;
+        }
+    private:
+        Flat empty_flat_() const {
+            if constexpr ( detail::has_get_allocator_v<Flat> ) {
+                if ( !levels_.empty() ) {
+                    return Flat(key_comp(), levels_.front()->get_allocator());
+                }
+            }
+            return Flat(key_comp());
+        }
+    private:
+        using level_iterator = typename Flat::const_iterator;
+        using run_type = std::pair<level_iterator, level_iterator>;
+        using tree_type = detail::loser_tree<level_iterator, value_compare>;
+    private:
+        std::vector<const Flat*> levels_;
+        Tombstone tombstone_;
+        value_compare comp_;
+    };
+
+    // the iterator owns a loser tree over the levels, equal elements leave
+    // it from the newest level first, so the first one of every key is the
+    // visible version and the others are skipped
+    template < typename Flat
+             , typename Tombstone >
+    class merged_view<Flat, Tombstone>::const_iterator_impl {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = typename Flat::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+    public:
+        const_iterator_impl() = default;
+
+        reference operator*() const
+        noexcept {
+            return tree_->top();
+        }
+
+        pointer operator->() const
+        noexcept {
+            return &tree_->top();
+        }
+
+        const_iterator_impl& operator++() {
+            skip_key_();
+            settle_();
+            return *this;
+        }
+
+        const_iterator_impl operator++(int) {
+            const_iterator_impl iter = *this;
+            ++*this;
+            return iter;
+        }
+
+        friend bool operator==(const const_iterator_impl& l, const const_iterator_impl& r) noexcept {
+            const bool l_end = l.at_end_();
+            const bool r_end = r.at_end_();
+            return l_end || r_end
+                ? l_end == r_end
+                : &l.tree_->top() == &r.tree_->top();
+        }
+
+        friend bool operator!=(const const_iterator_impl& l, const const_iterator_impl& r) noexcept {
+            return !(l == r);
+        }
+    private:
+        friend class merged_view;
+
+        const_iterator_impl(const merged_view* view, std::vector<run_type> runs)
+        : view_(view) {
+            tree_.emplace(std::move(runs), view->comp_);
+            settle_();
+        }
+
+        bool at_end_() const noexcept {
+            return !tree_ || tree_->empty();
+        }
+
+        // pops the current element and its older versions
+        void skip_key_() {
+            const value_type& current = tree_->top();
+            do {
+                tree_->pop();
+            } while ( !tree_->empty() && !view_->comp_(current, tree_->top()) );
+        }
+
+        // moves to the first element which is not a tombstone
+        void settle_() {
+            while ( !tree_->empty() && view_->tombstone_(tree_->top()) ) {
+                skip_key_();
+            }
+        }
+    private:
+        const merged_view* view_ = nullptr;
+        std::optional<tree_type> tree_;
+    };
+}
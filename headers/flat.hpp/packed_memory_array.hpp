@@ -0,0 +1,809 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "flat_fwd.hpp"
+
+#include <iterator>
+#include <limits>
+#include <memory>
+
+#include "detail/fenwick_tree.hpp"
+
+namespace flat_hpp
+{
+    template < typename T
+             , typename Allocator
+             , std::size_t SegmentSize >
+    class packed_memory_array {
+        using alloc_traits = std::allocator_traits<Allocator>;
+        using buffer_type = std::vector<T, Allocator>;
+
+        template < bool Const >
+        class basic_iterator;
+
+        static_assert(
+            SegmentSize >= 8,
+            "flat_hpp::packed_memory_array: SegmentSize must be at least 8");
+    public:
+        using value_type = T;
+        using allocator_type = Allocator;
+
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using pointer = typename alloc_traits::pointer;
+        using const_pointer = typename alloc_traits::const_pointer;
+
+        using iterator = basic_iterator<false>;
+        using const_iterator = basic_iterator<true>;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        static constexpr size_type segment_size = SegmentSize;
+    public:
+        packed_memory_array() = default;
+
+        explicit packed_memory_array(const Allocator& a)
+        : alloc_(a) {}
+
+        template < typename InputIter >
+        packed_memory_array(InputIter first, InputIter last, const Allocator& a = Allocator())
+        : alloc_(a) {
+            insert(end(), first, last);
+        }
+
+        packed_memory_array(std::initializer_list<T> ilist, const Allocator& a = Allocator())
+        : alloc_(a) {
+            insert(end(), ilist.begin(), ilist.end());
+        }
+
+        packed_memory_array(packed_memory_array&& other) noexcept
+        : alloc_(std::move(other.alloc_)) {
+            steal_(other);
+        }
+
+        packed_memory_array(const packed_memory_array& other)
+        : alloc_(alloc_traits::select_on_container_copy_construction(other.alloc_)) {
+            insert(end(), other.begin(), other.end());
+        }
+
+        ~packed_memory_array() {
+            deallocate_();
+        }
+
+        packed_memory_array& operator=(packed_memory_array&& other)
+            noexcept(alloc_traits::propagate_on_container_move_assignment::value
+                || alloc_traits::is_always_equal::value)
+        {
+            if ( this == &other ) {
+                return *this;
+            }
+            if constexpr ( alloc_traits::propagate_on_container_move_assignment::value ) {
+                deallocate_();
+                alloc_ = std::move(other.alloc_);
+                steal_(other);
+            } else {
+                if ( alloc_ == other.alloc_ ) {
+                    deallocate_();
+                    steal_(other);
+                } else {
+                    clear();
+                    insert(end(),
+                        std::make_move_iterator(other.begin()),
+                        std::make_move_iterator(other.end()));
+                    other.clear();
+                }
+            }
+            return *this;
+        }
+
+        packed_memory_array& operator=(const packed_memory_array& other) {
+            if ( this == &other ) {
+                return *this;
+            }
+            if constexpr ( alloc_traits::propagate_on_container_copy_assignment::value ) {
+                if ( alloc_ != other.alloc_ ) {
+                    deallocate_();
+                }
+                alloc_ = other.alloc_;
+            }
+            clear();
+            insert(end(), other.begin(), other.end());
+            return *this;
+        }
+
+        packed_memory_array& operator=(std::initializer_list<T> ilist) {
+            clear();
+            insert(end(), ilist.begin(), ilist.end());
+            return *this;
+        }
+
+        allocator_type get_allocator() const {
+            return alloc_;
+        }
+
+        iterator begin() noexcept { return iterator(this, 0); }
+        const_iterator begin() const noexcept { return const_iterator(this, 0); }
+        const_iterator cbegin() const noexcept { return const_iterator(this, 0); }
+
+        iterator end() noexcept { return iterator(this, size_); }
+        const_iterator end() const noexcept { return const_iterator(this, size_); }
+        const_iterator cend() const noexcept { return const_iterator(this, size_); }
+
+        reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+        const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+        const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(end()); }
+
+        reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+        const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+        const_reverse_iterator crend() const noexcept { return const_reverse_iterator(begin()); }
+
+        bool empty() const
+        noexcept {
+            return size_ == 0;
+        }
+
+        size_type size() const
+        noexcept {
+            return size_;
+        }
+
+        size_type max_size() const
+        noexcept {
+            return std::min<size_type>(
+                alloc_traits::max_size(alloc_),
+                static_cast<size_type>(std::numeric_limits<difference_type>::max()));
+        }
+
+        size_type capacity() const
+        noexcept {
+            return segment_count_ * SegmentSize;
+        }
+
+        size_type segment_count() const
+        noexcept {
+            return segment_count_;
+        }
+
+        void reserve(size_type ncapacity) {
+            const size_type nsegment_count = segments_for_(ncapacity);
+            if ( nsegment_count > segment_count_ ) {
+                resize_(nsegment_count);
+            }
+        }
+
+        void shrink_to_fit() {
+            const size_type nsegment_count = size_ > 0 ? segments_for_(size_) : 0;
+            if ( nsegment_count < segment_count_ ) {
+                resize_(nsegment_count);
+            }
+        }
+
+        reference operator[](size_type index) noexcept {
+            return at_(index);
+        }
+
+        const_reference operator[](size_type index) const noexcept {
+            return at_(index);
+        }
+
+        reference front() noexcept {
+            return at_(0);
+        }
+
+        const_reference front() const noexcept {
+            return at_(0);
+        }
+
+        reference back() noexcept {
+            return at_(size_ - 1);
+        }
+
+        const_reference back() const noexcept {
+            return at_(size_ - 1);
+        }
+
+        template < typename... Args >
+        iterator emplace(const_iterator pos, Args&&... args) {
+            // the arguments may refer to elements which
+            // are moved by a rebalance, so the value is built first
+            T value(std::forward<Args>(args)...);
+            const size_type index = pos.index_;
+            insert_(index, std::move(value));
+            return iterator(this, index);
+        }
+
+        iterator insert(const_iterator pos, T&& value) {
+            return emplace(pos, std::move(value));
+        }
+
+        iterator insert(const_iterator pos, const T& value) {
+            return emplace(pos, value);
+        }
+
+        template < typename InputIter >
+        iterator insert(const_iterator pos, InputIter first, InputIter last) {
+            using category = typename std::iterator_traits<InputIter>::iterator_category;
+            const size_type index = pos.index_;
+            if constexpr ( std::is_base_of_v<std::forward_iterator_tag, category> ) {
+                // a range comparable to the array is cheaper to insert by
+                // rebuilding it in O(n) than by shifting a segment per element
+                const size_type count = static_cast<size_type>(std::distance(first, last));
+                if ( count >= SegmentSize && count * SegmentSize >= size_ ) {
+                    // the new elements are copied first, so a throwing copy changes nothing
+                    buffer_type values(first, last, alloc_);
+                    rebuild_(size_ + count, segments_for_(size_ + count), [this, index, &values](auto&& construct){
+                        auto iter = begin();
+                        for ( ; iter.index_ < index; ++iter ) {
+                            construct(std::move_if_noexcept(*iter));
+                        }
+                        for ( T& value : values ) {
+                            construct(std::move_if_noexcept(value));
+                        }
+                        for ( ; iter != end(); ++iter ) {
+                            construct(std::move_if_noexcept(*iter));
+                        }
+                    });
+                    return iterator(this, index);
+                }
+            }
+            for ( size_type i = index; first != last; ++first, ++i ) {
+                emplace(const_iterator(this, i), *first);
+            }
+            return iterator(this, index);
+        }
+
+        iterator insert(const_iterator pos, std::initializer_list<T> ilist) {
+            return insert(pos, ilist.begin(), ilist.end());
+        }
+
+        template < typename... Args >
+        reference emplace_back(Args&&... args) {
+            return *emplace(cend(), std::forward<Args>(args)...);
+        }
+
+        void push_back(T&& value) {
+            emplace(cend(), std::move(value));
+        }
+
+        void push_back(const T& value) {
+            emplace(cend(), value);
+        }
+
+        void pop_back() {
+            erase(cend() - 1);
+        }
+
+        iterator erase(const_iterator pos) {
+            const size_type index = pos.index_;
+            erase_(index, 1);
+            return iterator(this, index);
+        }
+
+        iterator erase(const_iterator first, const_iterator last) {
+            const size_type index = first.index_;
+            if ( last.index_ > index ) {
+                erase_(index, last.index_ - index);
+            }
+            return iterator(this, index);
+        }
+
+        void clear() noexcept {
+            for ( size_type segment = 0; segment < segment_count_; ++segment ) {
+                for ( size_type offset = 0; offset < counts_[segment]; ++offset ) {
+                    alloc_traits::destroy(alloc_, slot_(segment, offset));
+                }
+                counts_[segment] = 0;
+            }
+            ranks_.assign(counts_);
+            size_ = 0;
+            ++stamp_;
+        }
+
+        void swap(packed_memory_array& other) noexcept {
+            using std::swap;
+            if constexpr ( alloc_traits::propagate_on_container_swap::value ) {
+                swap(alloc_, other.alloc_);
+            }
+            swap(buffer_, other.buffer_);
+            swap(segment_count_, other.segment_count_);
+            swap(size_, other.size_);
+            swap(counts_, other.counts_);
+            swap(ranks_, other.ranks_);
+            ++stamp_;
+            ++other.stamp_;
+        }
+    private:
+        // the upper density bound falls from 1 at a segment to 3/4 at
+        // the root, and the lower one rises from 1/8 to 1/4, so any
+        // rebalanced window has room for a while in both directions
+        static constexpr double upper_leaf_density = 1.0;
+        static constexpr double upper_root_density = 0.75;
+        static constexpr double lower_leaf_density = 0.125;
+        static constexpr double lower_root_density = 0.25;
+
+        static constexpr size_type unlocated = std::numeric_limits<size_type>::max();
+
+        static size_type segments_for_(size_type count) noexcept {
+            size_type segment_count = 1;
+            while ( segment_count * SegmentSize < count * 2 ) {
+                segment_count *= 2;
+            }
+            return segment_count;
+        }
+
+        T* slot_(size_type segment, size_type offset) const noexcept {
+            return buffer_ + (segment * SegmentSize + offset);
+        }
+
+        T& at_(size_type index) const noexcept {
+            assert(index < size_);
+            const auto location = locate_(index);
+            return *slot_(location.first, location.second);
+        }
+
+        std::pair<size_type, size_type> locate_(size_type index) const noexcept {
+            return index < size_
+                ? ranks_.search(index)
+                : std::make_pair(segment_count_, size_type{0});
+        }
+
+        size_type next_(size_type segment) const noexcept {
+            do {
+                ++segment;
+            } while ( segment < segment_count_ && counts_[segment] == 0 );
+            return segment;
+        }
+
+        size_type prev_(size_type segment) const noexcept {
+            do {
+                --segment;
+            } while ( counts_[segment] == 0 );
+            return segment;
+        }
+
+        size_type height_() const noexcept {
+            size_type height = 0;
+            while ( (size_type{1} << height) < segment_count_ ) {
+                ++height;
+            }
+            return height;
+        }
+
+        size_type window_count_(size_type first, size_type last) const noexcept {
+            return ranks_.prefix(last) - ranks_.prefix(first);
+        }
+
+        void insert_(size_type index, T&& value) {
+            if ( segment_count_ == 0 ) {
+                resize_(1);
+            }
+
+            std::pair<size_type, size_type> location = insert_location_(index);
+            if ( counts_[location.first] == SegmentSize ) {
+                rebalance_for_insert_(location.first);
+                location = insert_location_(index);
+            }
+
+            const size_type segment = location.first;
+            const size_type offset = location.second;
+            const size_type count = counts_[segment];
+            assert(count < SegmentSize);
+
+            if ( offset == count ) {
+                alloc_traits::construct(alloc_, slot_(segment, count), std::move(value));
+            } else {
+                alloc_traits::construct(alloc_, slot_(segment, count), std::move(*slot_(segment, count - 1)));
+                std::move_backward(slot_(segment, offset), slot_(segment, count - 1), slot_(segment, count));
+                *slot_(segment, offset) = std::move(value);
+            }
+
+            ++counts_[segment];
+            ranks_.add(segment, 1);
+            ++size_;
+            ++stamp_;
+        }
+
+        std::pair<size_type, size_type> insert_location_(size_type index) const noexcept {
+            if ( index < size_ ) {
+                return locate_(index);
+            }
+            if ( size_ == 0 ) {
+                return {0, 0};
+            }
+            const size_type segment = locate_(size_ - 1).first;
+            return {segment, counts_[segment]};
+        }
+
+        // every touched segment is shifted once, and a single window
+        // covering all of them is rebalanced if any of them runs too empty
+        void erase_(size_type index, size_type count) {
+            assert(index + count <= size_);
+            const auto location = locate_(index);
+            const size_type first_segment = location.first;
+            size_type segment = location.first;
+            size_type offset = location.second;
+            bool underfull = false;
+
+            for ( size_type left = count; ; ) {
+                const size_type segment_count = counts_[segment];
+                const size_type erased = std::min(left, segment_count - offset);
+
+                std::move(slot_(segment, offset + erased), slot_(segment, segment_count), slot_(segment, offset));
+                for ( size_type i = segment_count - erased; i < segment_count; ++i ) {
+                    alloc_traits::destroy(alloc_, slot_(segment, i));
+                }
+
+                counts_[segment] -= erased;
+                ranks_.add(segment, -static_cast<difference_type>(erased));
+                underfull = underfull
+                    || static_cast<double>(counts_[segment]) < lower_leaf_density * SegmentSize;
+
+                left -= erased;
+                if ( left == 0 ) {
+                    break;
+                }
+                segment = next_(segment);
+                offset = 0;
+            }
+
+            size_ -= count;
+            ++stamp_;
+
+            if ( underfull ) {
+                rebalance_for_erase_(first_segment, segment);
+            }
+        }
+
+        // finds the smallest enclosing window of segments which is not
+        // too dense and spreads its elements evenly, or grows the array
+        void rebalance_for_insert_(size_type segment) {
+            const size_type height = height_();
+            for ( size_type level = 1; level <= height; ++level ) {
+                const size_type width = size_type{1} << level;
+                const size_type first = segment & ~(width - 1);
+                const double density = upper_leaf_density
+                    - (upper_leaf_density - upper_root_density) * static_cast<double>(level) / static_cast<double>(height);
+                // one free slot per segment leaves room for the new element
+                if ( static_cast<double>(window_count_(first, first + width) + width)
+                    <= density * static_cast<double>(width * SegmentSize) )
+                {
+                    redistribute_(first, first + width);
+                    return;
+                }
+            }
+            resize_(segment_count_ * 2);
+        }
+
+        // the window has to cover all the segments from first_segment to last_segment
+        void rebalance_for_erase_(size_type first_segment, size_type last_segment) {
+            if ( segment_count_ < 2 ) {
+                return;
+            }
+            const size_type height = height_();
+            for ( size_type level = 1; level <= height; ++level ) {
+                const size_type width = size_type{1} << level;
+                const size_type first = first_segment & ~(width - 1);
+                if ( first + width <= last_segment ) {
+                    continue;
+                }
+                const double density = lower_leaf_density
+                    + (lower_root_density - lower_leaf_density) * static_cast<double>(level) / static_cast<double>(height);
+                if ( static_cast<double>(window_count_(first, first + width))
+                    >= density * static_cast<double>(width * SegmentSize) )
+                {
+                    redistribute_(first, first + width);
+                    return;
+                }
+            }
+            resize_(segments_for_(size_));
+        }
+
+        void redistribute_(size_type first, size_type last) {
+            std::vector<size_type> old_counts(counts_.begin() + static_cast<difference_type>(first), counts_.begin() + static_cast<difference_type>(last));
+            buffer_type elements = take_(first, last);
+            place_(elements, first, last);
+            for ( size_type segment = first; segment < last; ++segment ) {
+                ranks_.add(segment, static_cast<difference_type>(counts_[segment]) - static_cast<difference_type>(old_counts[segment - first]));
+            }
+            ++stamp_;
+        }
+
+        void resize_(size_type nsegment_count) {
+            rebuild_(size_, nsegment_count, [this](auto&& construct){
+                for ( iterator iter = begin(); iter != end(); ++iter ) {
+                    construct(std::move_if_noexcept(*iter));
+                }
+            });
+        }
+
+        // moves the elements of the segments out in order
+        buffer_type take_(size_type first, size_type last) {
+            buffer_type elements(alloc_);
+            elements.reserve(window_count_(first, last));
+            for ( size_type segment = first; segment < last; ++segment ) {
+                for ( size_type offset = 0; offset < counts_[segment]; ++offset ) {
+                    elements.push_back(std::move(*slot_(segment, offset)));
+                    alloc_traits::destroy(alloc_, slot_(segment, offset));
+                }
+                counts_[segment] = 0;
+            }
+            return elements;
+        }
+
+        // spreads the elements evenly over the segments, which must be empty
+        void place_(buffer_type& elements, size_type first, size_type last) {
+            const size_type width = last - first;
+            const size_type base = elements.size() / width;
+            const size_type extra = elements.size() % width;
+            auto iter = elements.begin();
+            for ( size_type segment = first; segment < last; ++segment ) {
+                const size_type count = base + (segment - first < extra ? 1 : 0);
+                for ( size_type offset = 0; offset < count; ++offset, ++iter ) {
+                    alloc_traits::construct(alloc_, slot_(segment, offset), std::move(*iter));
+                }
+                counts_[segment] = count;
+            }
+        }
+
+        // fill(construct) passes the count elements in order to construct,
+        // which spreads them evenly over a new buffer; the old storage is
+        // released only when the new one is complete, so a throwing
+        // allocation or construction leaves the array unchanged
+        template < typename Fill >
+        void rebuild_(size_type count, size_type nsegment_count, Fill&& fill) {
+            assert(count <= nsegment_count * SegmentSize);
+            if ( nsegment_count == 0 ) {
+                deallocate_();
+                ++stamp_;
+                return;
+            }
+
+            std::vector<size_type> ncounts(nsegment_count);
+            for ( size_type segment = 0; segment < nsegment_count; ++segment ) {
+                ncounts[segment] = count / nsegment_count + (segment < count % nsegment_count ? 1 : 0);
+            }
+            detail::fenwick_tree nranks;
+            nranks.assign(ncounts);
+
+            T* nbuffer = alloc_traits::allocate(alloc_, nsegment_count * SegmentSize);
+            size_type segment = 0;
+            size_type offset = 0;
+            try {
+                fill([this, nbuffer, &ncounts, &segment, &offset](auto&& value){
+                    while ( offset == ncounts[segment] ) {
+                        ++segment;
+                        offset = 0;
+                    }
+                    alloc_traits::construct(alloc_,
+                        nbuffer + (segment * SegmentSize + offset),
+                        std::forward<decltype(value)>(value));
+                    ++offset;
+                });
+            } catch (...) {
+                for ( size_type s = 0; s <= segment && s < nsegment_count; ++s ) {
+                    const size_type constructed = s < segment ? ncounts[s] : offset;
+                    for ( size_type o = 0; o < constructed; ++o ) {
+                        alloc_traits::destroy(alloc_, nbuffer + (s * SegmentSize + o));
+                    }
+                }
+                alloc_traits::deallocate(alloc_, nbuffer, nsegment_count * SegmentSize);
+                throw;
+            }
+
+            deallocate_();
+            buffer_ = nbuffer;
+            segment_count_ = nsegment_count;
+            size_ = count;
+            counts_ = std::move(ncounts);
+            ranks_ = std::move(nranks);
+            ++stamp_;
+        }
+
+        void deallocate_() noexcept {
+            if ( buffer_ ) {
+                clear();
+                alloc_traits::deallocate(alloc_, buffer_, segment_count_ * SegmentSize);
+                buffer_ = nullptr;
+                segment_count_ = 0;
+                counts_.clear();
+                ranks_.assign(counts_);
+            }
+        }
+
+        void steal_(packed_memory_array& other) noexcept {
+            buffer_ = std::exchange(other.buffer_, nullptr);
+            segment_count_ = std::exchange(other.segment_count_, 0);
+            size_ = std::exchange(other.size_, 0);
+            counts_ = std::move(other.counts_);
+            ranks_ = std::move(other.ranks_);
+            other.counts_.clear();
+            other.ranks_ = detail::fenwick_tree();
+            ++other.stamp_;
+        }
+    private:
+        Allocator alloc_;
+        T* buffer_ = nullptr;
+        size_type segment_count_ = 0;
+        size_type size_ = 0;
+        size_type stamp_ = 0;
+        std::vector<size_type> counts_;
+        detail::fenwick_tree ranks_;
+    };
+
+    // the iterator is a logical position with a cached physical one,
+    // so stepping costs O(1) and jumping or a stale cache O(log n)
+    template < typename T
+             , typename Allocator
+             , std::size_t SegmentSize >
+    template < bool Const >
+    class packed_memory_array<T, Allocator, SegmentSize>::basic_iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const T*, T*>;
+        using reference = std::conditional_t<Const, const T&, T&>;
+    public:
+        basic_iterator() = default;
+
+        template < bool C = Const, typename = std::enable_if_t<C> >
+        basic_iterator(const basic_iterator<false>& other) noexcept
+        : array_(other.array_)
+        , index_(other.index_)
+        , segment_(other.segment_)
+        , offset_(other.offset_)
+        , stamp_(other.stamp_) {}
+
+        reference operator*() const noexcept {
+            locate_();
+            return *array_->slot_(segment_, offset_);
+        }
+
+        pointer operator->() const noexcept {
+            return &**this;
+        }
+
+        reference operator[](difference_type n) const noexcept {
+            return *(*this + n);
+        }
+
+        basic_iterator& operator++() noexcept {
+            if ( stamp_ == array_->stamp_ ) {
+                if ( offset_ + 1 < array_->counts_[segment_] ) {
+                    ++offset_;
+                } else {
+                    segment_ = array_->next_(segment_);
+                    offset_ = 0;
+                }
+            }
+            ++index_;
+            return *this;
+        }
+
+        basic_iterator& operator--() noexcept {
+            if ( stamp_ == array_->stamp_ ) {
+                if ( offset_ > 0 ) {
+                    --offset_;
+                } else {
+                    segment_ = array_->prev_(segment_);
+                    offset_ = array_->counts_[segment_] - 1;
+                }
+            }
+            --index_;
+            return *this;
+        }
+
+        basic_iterator operator++(int) noexcept { basic_iterator iter = *this; ++*this; return iter; }
+        basic_iterator operator--(int) noexcept { basic_iterator iter = *this; --*this; return iter; }
+
+        // a jump within the cached segment stays located, so the last
+        // steps of a binary search do not search the Fenwick tree again
+        basic_iterator& operator+=(difference_type n) noexcept {
+            if ( stamp_ == array_->stamp_ && segment_ < array_->segment_count_ ) {
+                const difference_type offset = static_cast<difference_type>(offset_) + n;
+                if ( offset >= 0 && offset < static_cast<difference_type>(array_->counts_[segment_]) ) {
+                    offset_ = static_cast<size_type>(offset);
+                } else {
+                    stamp_ = unlocated;
+                }
+            }
+            index_ = static_cast<size_type>(static_cast<difference_type>(index_) + n);
+            return *this;
+        }
+
+        basic_iterator& operator-=(difference_type n) noexcept {
+            return *this += -n;
+        }
+
+        friend basic_iterator operator+(basic_iterator iter, difference_type n) noexcept { return iter += n; }
+        friend basic_iterator operator+(difference_type n, basic_iterator iter) noexcept { return iter += n; }
+        friend basic_iterator operator-(basic_iterator iter, difference_type n) noexcept { return iter -= n; }
+
+        friend difference_type operator-(const basic_iterator& l, const basic_iterator& r) noexcept {
+            return static_cast<difference_type>(l.index_) - static_cast<difference_type>(r.index_);
+        }
+
+        friend bool operator==(const basic_iterator& l, const basic_iterator& r) noexcept { return l.index_ == r.index_; }
+        friend bool operator!=(const basic_iterator& l, const basic_iterator& r) noexcept { return l.index_ != r.index_; }
+        friend bool operator<(const basic_iterator& l, const basic_iterator& r) noexcept { return l.index_ < r.index_; }
+        friend bool operator>(const basic_iterator& l, const basic_iterator& r) noexcept { return l.index_ > r.index_; }
+        friend bool operator<=(const basic_iterator& l, const basic_iterator& r) noexcept { return l.index_ <= r.index_; }
+        friend bool operator>=(const basic_iterator& l, const basic_iterator& r) noexcept { return l.index_ >= r.index_; }
+    private:
+        friend class packed_memory_array;
+        template < bool > friend class basic_iterator;
+
+        using array_pointer = std::conditional_t<Const, const packed_memory_array*, packed_memory_array*>;
+
+        basic_iterator(array_pointer array, size_type index) noexcept
+        : array_(array)
+        , index_(index) {}
+
+        void locate_() const noexcept {
+            if ( stamp_ != array_->stamp_ ) {
+                const auto location = array_->locate_(index_);
+                segment_ = location.first;
+                offset_ = location.second;
+                stamp_ = array_->stamp_;
+            }
+        }
+    private:
+        array_pointer array_ = nullptr;
+        size_type index_ = 0;
+        mutable size_type segment_ = 0;
+        mutable size_type offset_ = 0;
+        mutable size_type stamp_ = unlocated;
+    };
+}
+
+namespace flat_hpp
+{
+    template < typename T
+             , typename Allocator
+             , std::size_t SegmentSize >
+    void swap(
+        packed_memory_array<T, Allocator, SegmentSize>& l,
+        packed_memory_array<T, Allocator, SegmentSize>& r) noexcept
+    {
+        l.swap(r);
+    }
+
+    template < typename T
+             , typename Allocator
+             , std::size_t SegmentSize >
+    bool operator==(
+        const packed_memory_array<T, Allocator, SegmentSize>& l,
+        const packed_memory_array<T, Allocator, SegmentSize>& r)
+    {
+        return l.size() == r.size()
+            && std::equal(l.begin(), l.end(), r.begin());
+    }
+
+    template < typename T
+             , typename Allocator
+             , std::size_t SegmentSize >
+    bool operator!=(
+        const packed_memory_array<T, Allocator, SegmentSize>& l,
+        const packed_memory_array<T, Allocator, SegmentSize>& r)
+    {
+        return !(l == r);
+    }
+
+    template < typename T
+             , typename Allocator
+             , std::size_t SegmentSize >
+    bool operator<(
+        const packed_memory_array<T, Allocator, SegmentSize>& l,
+        const packed_memory_array<T, Allocator, SegmentSize>& r)
+    {
+        return std::lexicographical_compare(l.begin(), l.end(), r.begin(), r.end());
+    }
+}
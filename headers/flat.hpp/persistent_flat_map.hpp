@@ -0,0 +1,547 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "flat_fwd.hpp"
+
+#include <iterator>
+#include <memory>
+
+namespace flat_hpp
+{
+    template < typename Key
+             , typename Value
+             , typename Compare
+             , std::size_t ChunkSize >
+    class persistent_flat_map
+        : private detail::pair_compare<
+            std::pair<Key, Value>,
+            Compare>
+    {
+        using base_type = detail::pair_compare<
+            std::pair<Key, Value>,
+            Compare>;
+
+        using chunk_type = std::vector<std::pair<Key, Value>>;
+        using chunk_pointer = std::shared_ptr<const chunk_type>;
+
+        struct directory {
+            std::vector<chunk_pointer> chunks;
+            std::vector<Key> firsts;
+            std::size_t size = 0;
+        };
+
+        static_assert(
+            ChunkSize > 1,
+            "flat_hpp::persistent_flat_map: ChunkSize must be greater than one");
+
+        class basic_iterator;
+    public:
+        using key_type = Key;
+        using mapped_type = Value;
+        using value_type = std::pair<Key, Value>;
+
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        using key_compare = Compare;
+
+        using reference = const value_type&;
+        using const_reference = const value_type&;
+        using pointer = const value_type*;
+        using const_pointer = const value_type*;
+
+        using iterator = basic_iterator;
+        using const_iterator = basic_iterator;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        static constexpr size_type chunk_size = ChunkSize;
+    public:
+        persistent_flat_map() = default;
+        ~persistent_flat_map() = default;
+
+        explicit persistent_flat_map(const Compare& c)
+        : base_type(c) {}
+
+        template < typename InputIter >
+        persistent_flat_map(InputIter first, InputIter last) {
+            from_range_(first, last);
+        }
+
+        template < typename InputIter >
+        persistent_flat_map(InputIter first, InputIter last, const Compare& c)
+        : base_type(c) {
+            from_range_(first, last);
+        }
+
+        persistent_flat_map(std::initializer_list<value_type> ilist) {
+            from_range_(ilist.begin(), ilist.end());
+        }
+
+        persistent_flat_map(std::initializer_list<value_type> ilist, const Compare& c)
+        : base_type(c) {
+            from_range_(ilist.begin(), ilist.end());
+        }
+
+        // copies share the whole storage and cost O(1)
+        persistent_flat_map(persistent_flat_map&& other) = default;
+        persistent_flat_map(const persistent_flat_map& other) = default;
+
+        persistent_flat_map& operator=(persistent_flat_map&& other) = default;
+        persistent_flat_map& operator=(const persistent_flat_map& other) = default;
+
+        const_iterator begin() const
+        noexcept {
+            return const_iterator(&dir_(), 0, 0);
+        }
+
+        const_iterator cbegin() const
+        noexcept {
+            return begin();
+        }
+
+        const_iterator end() const
+        noexcept {
+            return const_iterator(&dir_(), dir_().chunks.size(), 0);
+        }
+
+        const_iterator cend() const
+        noexcept {
+            return end();
+        }
+
+        const_reverse_iterator rbegin() const
+        noexcept {
+            return const_reverse_iterator(end());
+        }
+
+        const_reverse_iterator crbegin() const
+        noexcept {
+            return const_reverse_iterator(end());
+        }
+
+        const_reverse_iterator rend() const
+        noexcept {
+            return const_reverse_iterator(begin());
+        }
+
+        const_reverse_iterator crend() const
+        noexcept {
+            return const_reverse_iterator(begin());
+        }
+
+        bool empty() const
+        noexcept {
+            return dir_().size == 0;
+        }
+
+        size_type size() const
+        noexcept {
+            return dir_().size;
+        }
+
+        size_type chunk_count() const
+        noexcept {
+            return dir_().chunks.size();
+        }
+
+        // the number of chunks this version shares with the other one
+        size_type shared_chunk_count(const persistent_flat_map& other) const {
+            std::vector<const chunk_type*> others;
+            others.reserve(other.chunk_count());
+            for ( const chunk_pointer& chunk : other.dir_().chunks ) {
+                others.push_back(chunk.get());
+            }
+            std::sort(others.begin(), others.end(), std::less<>());
+
+            size_type count = 0;
+            for ( const chunk_pointer& chunk : dir_().chunks ) {
+                if ( std::binary_search(others.begin(), others.end(), chunk.get(), std::less<>()) ) {
+                    ++count;
+                }
+            }
+            return count;
+        }
+
+        const mapped_type& at(const key_type& key) const {
+            const const_iterator iter = find(key);
+            if ( iter != end() ) {
+                return iter->second;
+            }
+            throw std::out_of_range("persistent_flat_map::at: key not found");
+        }
+
+        // returns a version where the key maps to the value, it copies
+        // one chunk and the chunk index and shares the other chunks
+        template < typename TT >
+        persistent_flat_map with_inserted(const key_type& key, TT&& value) const {
+            const position pos = lower_position_(key);
+            persistent_flat_map result(key_comp());
+            auto ndir = std::make_shared<directory>(dir_());
+
+            if ( ndir->chunks.empty() ) {
+                ndir->chunks.push_back(std::make_shared<const chunk_type>(
+                    1, value_type(key, std::forward<TT>(value))));
+                ndir->firsts.push_back(key);
+                ndir->size = 1;
+                result.root_ = std::move(ndir);
+                return result;
+            }
+
+            chunk_type chunk = *ndir->chunks[pos.chunk];
+            if ( found_(pos, key) ) {
+                chunk[pos.index].second = std::forward<TT>(value);
+            } else {
+                chunk.insert(
+                    chunk.begin() + static_cast<difference_type>(pos.index),
+                    value_type(key, std::forward<TT>(value)));
+                ++ndir->size;
+            }
+
+            // a full chunk is split in halves like in chunked_flat_map
+            if ( chunk.size() > chunk_size ) {
+                const auto half = static_cast<difference_type>(chunk.size() / 2);
+                chunk_type tail(
+                    std::make_move_iterator(chunk.begin() + half),
+                    std::make_move_iterator(chunk.end()));
+                chunk.erase(chunk.begin() + half, chunk.end());
+
+                const auto next = static_cast<difference_type>(pos.chunk + 1);
+                ndir->firsts.insert(ndir->firsts.begin() + next, tail.front().first);
+                ndir->chunks.insert(ndir->chunks.begin() + next,
+                    std::make_shared<const chunk_type>(std::move(tail)));
+            }
+
+            ndir->firsts[pos.chunk] = chunk.front().first;
+            ndir->chunks[pos.chunk] = std::make_shared<const chunk_type>(std::move(chunk));
+            result.root_ = std::move(ndir);
+            return result;
+        }
+
+        // returns a version without the key, or this one if there is no such key
+        persistent_flat_map with_erased(const key_type& key) const {
+            const position pos = lower_position_(key);
+            if ( !found_(pos, key) ) {
+                return *this;
+            }
+
+            persistent_flat_map result(key_comp());
+            auto ndir = std::make_shared<directory>(dir_());
+            --ndir->size;
+
+            const auto c = static_cast<difference_type>(pos.chunk);
+            if ( ndir->chunks[pos.chunk]->size() == 1 ) {
+                ndir->chunks.erase(ndir->chunks.begin() + c);
+                ndir->firsts.erase(ndir->firsts.begin() + c);
+            } else {
+                chunk_type chunk = *ndir->chunks[pos.chunk];
+                chunk.erase(chunk.begin() + static_cast<difference_type>(pos.index));
+                ndir->firsts[pos.chunk] = chunk.front().first;
+                ndir->chunks[pos.chunk] = std::make_shared<const chunk_type>(std::move(chunk));
+            }
+
+            result.root_ = std::move(ndir);
+            return result;
+        }
+
+        void clear() noexcept {
+            root_.reset();
+        }
+
+        void swap(persistent_flat_map& other)
+            noexcept(std::is_nothrow_swappable_v<base_type>)
+        {
+            using std::swap;
+            swap(
+                static_cast<base_type&>(*this),
+                static_cast<base_type&>(other));
+            swap(root_, other.root_);
+        }
+
+        size_type count(const key_type& key) const {
+            return contains(key) ? 1 : 0;
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            size_type>
+        count(const K& key) const {
+            return contains(key) ? 1 : 0;
+        }
+
+        const_iterator find(const key_type& key) const {
+            const position pos = lower_position_(key);
+            return found_(pos, key) ? make_iterator_(pos) : end();
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            const_iterator>
+        find(const K& key) const {
+            const position pos = lower_position_(key);
+            return found_(pos, key) ? make_iterator_(pos) : end();
+        }
+
+        bool contains(const key_type& key) const {
+            return found_(lower_position_(key), key);
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            bool>
+        contains(const K& key) const {
+            return found_(lower_position_(key), key);
+        }
+
+        std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const {
+            return equal_range_(key);
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            std::pair<const_iterator, const_iterator>>
+        equal_range(const K& key) const {
+            return equal_range_(key);
+        }
+
+        const_iterator lower_bound(const key_type& key) const {
+            return make_iterator_(lower_position_(key));
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            const_iterator>
+        lower_bound(const K& key) const {
+            return make_iterator_(lower_position_(key));
+        }
+
+        const_iterator upper_bound(const key_type& key) const {
+            return make_iterator_(upper_position_(key));
+        }
+
+        template < typename K >
+        std::enable_if_t<
+            detail::is_transparent_v<Compare, K>,
+            const_iterator>
+        upper_bound(const K& key) const {
+            return make_iterator_(upper_position_(key));
+        }
+
+        key_compare key_comp() const {
+            return *this;
+        }
+    private:
+        struct position {
+            size_type chunk;
+            size_type index;
+        };
+
+        const directory& dir_() const noexcept {
+            static const directory empty;
+            return root_ ? *root_ : empty;
+        }
+
+        template < typename K >
+        size_type chunk_of_(const K& key) const {
+            const std::vector<key_type>& firsts = dir_().firsts;
+            const auto iter = std::upper_bound(firsts.begin(), firsts.end(), key,
+                [this](const K& l, const key_type& r){
+                    return static_cast<const Compare&>(*this)(l, r);
+                });
+            return iter != firsts.begin()
+                ? static_cast<size_type>(iter - firsts.begin()) - 1
+                : 0;
+        }
+
+        template < typename K >
+        position lower_position_(const K& key) const {
+            if ( dir_().chunks.empty() ) {
+                return {0, 0};
+            }
+            const size_type c = chunk_of_(key);
+            const chunk_type& chunk = *dir_().chunks[c];
+            const auto iter = std::lower_bound(chunk.begin(), chunk.end(), key, base_type(*this));
+            return {c, static_cast<size_type>(iter - chunk.begin())};
+        }
+
+        template < typename K >
+        position upper_position_(const K& key) const {
+            if ( dir_().chunks.empty() ) {
+                return {0, 0};
+            }
+            const size_type c = chunk_of_(key);
+            const chunk_type& chunk = *dir_().chunks[c];
+            const auto iter = std::upper_bound(chunk.begin(), chunk.end(), key, base_type(*this));
+            return {c, static_cast<size_type>(iter - chunk.begin())};
+        }
+
+        template < typename K >
+        bool found_(const position& pos, const K& key) const {
+            const directory& dir = dir_();
+            return pos.chunk < dir.chunks.size()
+                && pos.index < dir.chunks[pos.chunk]->size()
+                && !this->operator()(key, (*dir.chunks[pos.chunk])[pos.index]);
+        }
+
+        const_iterator make_iterator_(const position& pos) const noexcept {
+            const directory& dir = dir_();
+            return pos.chunk < dir.chunks.size() && pos.index == dir.chunks[pos.chunk]->size()
+                ? const_iterator(&dir, pos.chunk + 1, 0)
+                : const_iterator(&dir, pos.chunk, pos.index);
+        }
+
+        template < typename K >
+        std::pair<const_iterator, const_iterator> equal_range_(const K& key) const {
+            const const_iterator first = lower_bound(key);
+            const bool found = first != end() && !this->operator()(key, *first);
+            const_iterator last = first;
+            return std::make_pair(first, found ? ++last : last);
+        }
+
+        template < typename InputIter >
+        void from_range_(InputIter first, InputIter last) {
+            chunk_type data(first, last);
+            std::stable_sort(data.begin(), data.end(), base_type(*this));
+            data.erase(
+                std::unique(data.begin(), data.end(),
+                    detail::eq_compare<base_type>(*this)),
+                data.end());
+
+            auto ndir = std::make_shared<directory>();
+            for ( size_type i = 0; i < data.size(); i += chunk_size ) {
+                const size_type n = std::min(chunk_size, data.size() - i);
+                ndir->chunks.push_back(std::make_shared<const chunk_type>(
+                    std::make_move_iterator(data.begin() + static_cast<difference_type>(i)),
+                    std::make_move_iterator(data.begin() + static_cast<difference_type>(i + n))));
+                ndir->firsts.push_back(ndir->chunks.back()->front().first);
+            }
+            ndir->size = data.size();
+            root_ = std::move(ndir);
+        }
+    private:
+        // a version never changes after it is built, so readers
+        // of a version need no locks while it is alive
+        std::shared_ptr<const directory> root_;
+    };
+
+    template < typename Key
+             , typename Value
+             , typename Compare
+             , std::size_t ChunkSize >
+    class persistent_flat_map<Key, Value, Compare, ChunkSize>::basic_iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = std::pair<Key, Value>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+    public:
+        basic_iterator() = default;
+
+        reference operator*() const
+        noexcept {
+            return (*dir_->chunks[chunk_])[index_];
+        }
+
+        pointer operator->() const
+        noexcept {
+            return &(*dir_->chunks[chunk_])[index_];
+        }
+
+        basic_iterator& operator++() noexcept {
+            if ( ++index_ == dir_->chunks[chunk_]->size() ) {
+                ++chunk_;
+                index_ = 0;
+            }
+            return *this;
+        }
+
+        basic_iterator operator++(int) noexcept {
+            basic_iterator iter = *this;
+            ++*this;
+            return iter;
+        }
+
+        basic_iterator& operator--() noexcept {
+            if ( index_ == 0 ) {
+                --chunk_;
+                index_ = dir_->chunks[chunk_]->size();
+            }
+            --index_;
+            return *this;
+        }
+
+        basic_iterator operator--(int) noexcept {
+            basic_iterator iter = *this;
+            --*this;
+            return iter;
+        }
+
+        friend bool operator==(const basic_iterator& l, const basic_iterator& r) noexcept {
+            return l.chunk_ == r.chunk_ && l.index_ == r.index_;
+        }
+
+        friend bool operator!=(const basic_iterator& l, const basic_iterator& r) noexcept {
+            return !(l == r);
+        }
+    private:
+        friend class persistent_flat_map;
+
+        basic_iterator(const directory* dir, size_type chunk, size_type index) noexcept
+        : dir_(dir)
+        , chunk_(chunk)
+        , index_(index) {}
+    private:
+        const directory* dir_ = nullptr;
+        size_type chunk_ = 0;
+        size_type index_ = 0;
+    };
+}
+
+namespace flat_hpp
+{
+    template < typename Key
+             , typename Value
+             , typename Compare
+             , std::size_t ChunkSize >
+    void swap(
+        persistent_flat_map<Key, Value, Compare, ChunkSize>& l,
+        persistent_flat_map<Key, Value, Compare, ChunkSize>& r)
+        noexcept(noexcept(l.swap(r)))
+    {
+        l.swap(r);
+    }
+
+    template < typename Key
+             , typename Value
+             , typename Compare
+             , std::size_t ChunkSize >
+    bool operator==(
+        const persistent_flat_map<Key, Value, Compare, ChunkSize>& l,
+        const persistent_flat_map<Key, Value, Compare, ChunkSize>& r)
+    {
+        return l.size() == r.size()
+            && std::equal(l.begin(), l.end(), r.begin());
+    }
+
+    template < typename Key
+             , typename Value
+             , typename Compare
+             , std::size_t ChunkSize >
+    bool operator!=(
+        const persistent_flat_map<Key, Value, Compare, ChunkSize>& l,
+        const persistent_flat_map<Key, Value, Compare, ChunkSize>& r)
+    {
+        return !(l == r);
+    }
+}
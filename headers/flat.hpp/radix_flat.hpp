@@ -0,0 +1,256 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "flat_fwd.hpp"
+
+#include <cstdint>
+#include <limits>
+
+#include "detail/is_multi.hpp"
+
+namespace flat_hpp
+{
+    template < typename Flat
+             , unsigned Bits >
+    class radix_flat {
+    public:
+        using flat_type = Flat;
+
+        using key_type = typename Flat::key_type;
+        using value_type = typename Flat::value_type;
+        using size_type = typename Flat::size_type;
+        using difference_type = typename Flat::difference_type;
+
+        using iterator = typename Flat::iterator;
+        using const_iterator = typename Flat::const_iterator;
+
+        static constexpr unsigned radix_bits = Bits;
+        static constexpr size_type bucket_count = size_type{1} << Bits;
+
+        static_assert(
+            std::is_integral_v<key_type>,
+            "flat_hpp::radix_flat: key_type must be an integral type");
+
+        static_assert(
+            std::is_same_v<typename Flat::key_compare, std::less<key_type>> ||
+            std::is_same_v<typename Flat::key_compare, std::less<>>,
+            "flat_hpp::radix_flat: key_compare must be std::less");
+
+        static_assert(
+            Bits > 0 && Bits <= 24 && Bits <= std::numeric_limits<std::make_unsigned_t<key_type>>::digits,
+            "flat_hpp::radix_flat: Bits must be in [1, min(24, key bits)]");
+    public:
+        radix_flat() = default;
+
+        explicit radix_flat(Flat flat)
+        : flat_(std::move(flat))
+        , starts_(bucket_count + 1) {
+            fill_starts_(starts_);
+        }
+
+        const Flat& flat() const
+        noexcept {
+            return flat_;
+        }
+
+        Flat extract() && {
+            Flat flat = std::move(flat_);
+            clear();
+            return flat;
+        }
+
+        const_iterator begin() const
+        noexcept {
+            return flat_.begin();
+        }
+
+        const_iterator cbegin() const
+        noexcept {
+            return flat_.cbegin();
+        }
+
+        const_iterator end() const
+        noexcept {
+            return flat_.end();
+        }
+
+        const_iterator cend() const
+        noexcept {
+            return flat_.cend();
+        }
+
+        bool empty() const
+        noexcept {
+            return flat_.empty();
+        }
+
+        size_type size() const
+        noexcept {
+            return flat_.size();
+        }
+
+        decltype(auto) insert(value_type&& value) {
+            const key_type key = key_of_(value);
+            allocate_starts_();
+            decltype(auto) result = flat_.insert(std::move(value));
+            if ( inserted_(result) ) {
+                shift_starts_(key, 1);
+            }
+            return result;
+        }
+
+        decltype(auto) insert(const value_type& value) {
+            allocate_starts_();
+            decltype(auto) result = flat_.insert(value);
+            if ( inserted_(result) ) {
+                shift_starts_(key_of_(value), 1);
+            }
+            return result;
+        }
+
+        // the new directory is allocated before the container changes,
+        // so a failed allocation leaves the old one in place
+        template < typename InputIter >
+        void insert(InputIter first, InputIter last) {
+            std::vector<size_type> starts(bucket_count + 1);
+            flat_.insert(first, last);
+            fill_starts_(starts);
+            starts_.swap(starts);
+        }
+
+        size_type erase(const key_type& key) {
+            const size_type count = flat_.erase(key);
+            if ( count > 0 ) {
+                shift_starts_(key, -static_cast<difference_type>(count));
+            }
+            return count;
+        }
+
+        void clear() noexcept {
+            flat_.clear();
+            starts_.clear();
+        }
+
+        size_type count(const key_type& key) const {
+            const auto range = equal_range(key);
+            return static_cast<size_type>(range.second - range.first);
+        }
+
+        const_iterator find(const key_type& key) const {
+            const const_iterator iter = lower_bound(key);
+            return iter != end() && key_of_(*iter) == key
+                ? iter
+                : end();
+        }
+
+        bool contains(const key_type& key) const {
+            return find(key) != end();
+        }
+
+        std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const {
+            const auto window = window_(key);
+            return std::equal_range(window.first, window.second, key, key_less());
+        }
+
+        const_iterator lower_bound(const key_type& key) const {
+            const auto window = window_(key);
+            return std::lower_bound(window.first, window.second, key, key_less());
+        }
+
+        const_iterator upper_bound(const key_type& key) const {
+            const auto window = window_(key);
+            return std::upper_bound(window.first, window.second, key, key_less());
+        }
+
+        size_type memory_usage() const
+        noexcept {
+            return starts_.size() * sizeof(size_type);
+        }
+    private:
+        template < typename T >
+        static const key_type& key_of_(const T& value) noexcept {
+            if constexpr ( std::is_integral_v<T> ) {
+                return value;
+            } else {
+                return value.first;
+            }
+        }
+
+        static size_type bucket_(const key_type& key) noexcept {
+            using ukey_type = std::make_unsigned_t<key_type>;
+            constexpr unsigned digits = std::numeric_limits<ukey_type>::digits;
+
+            // flipping the sign bit keeps the order of signed keys
+            ukey_type ukey = static_cast<ukey_type>(key);
+            if constexpr ( std::is_signed_v<key_type> ) {
+                ukey ^= static_cast<ukey_type>(ukey_type{1} << (digits - 1));
+            }
+            return static_cast<size_type>(ukey >> (digits - Bits));
+        }
+
+        struct key_less {
+            template < typename L, typename R >
+            bool operator()(const L& l, const R& r) const {
+                return key_of_(l) < key_of_(r);
+            }
+        };
+
+        template < typename Result >
+        static bool inserted_(const Result& result) noexcept {
+            if constexpr ( detail::is_multi_v<Flat> ) {
+                return true;
+            } else {
+                return result.second;
+            }
+        }
+
+        // an empty adaptor has no directory, it is allocated
+        // before the first insert so that the update cannot throw
+        void allocate_starts_() {
+            if ( starts_.empty() ) {
+                starts_.assign(bucket_count + 1, 0);
+            }
+        }
+
+        // the elements of the later buckets move by delta positions
+        void shift_starts_(const key_type& key, difference_type delta) noexcept {
+            for ( size_type bucket = bucket_(key) + 1; bucket <= bucket_count; ++bucket ) {
+                starts_[bucket] = static_cast<size_type>(static_cast<difference_type>(starts_[bucket]) + delta);
+            }
+        }
+
+        void fill_starts_(std::vector<size_type>& starts) const noexcept {
+            const auto first = flat_.begin();
+            size_type index = 0;
+            for ( size_type bucket = 0; bucket < bucket_count; ++bucket ) {
+                while ( index < flat_.size()
+                    && bucket_(key_of_(first[static_cast<difference_type>(index)])) < bucket )
+                {
+                    ++index;
+                }
+                starts[bucket] = index;
+            }
+            starts[bucket_count] = flat_.size();
+        }
+
+        // the directory is kept up to date by every modification,
+        // so lookups only read it and can run concurrently
+        std::pair<const_iterator, const_iterator> window_(const key_type& key) const {
+            if ( starts_.empty() ) {
+                return {flat_.end(), flat_.end()};
+            }
+            const size_type bucket = bucket_(key);
+            return {
+                flat_.begin() + static_cast<difference_type>(starts_[bucket]),
+                flat_.begin() + static_cast<difference_type>(starts_[bucket + 1])};
+        }
+    private:
+        Flat flat_;
+        std::vector<size_type> starts_;
+    };
+}
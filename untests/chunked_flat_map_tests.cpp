@@ -0,0 +1,172 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <flat.hpp/chunked_flat_map.hpp>
+#include <flat.hpp/flat_map.hpp>
+#include "flat_tests.hpp"
+
+#include <random>
+#include <string>
+#include <string_view>
+
+namespace
+{
+    using namespace flat_hpp;
+
+    template < typename T >
+    constexpr std::add_const_t<T>& my_as_const(T& t) noexcept {
+        return t;
+    }
+
+    template < typename Chunked, typename Flat >
+    bool same_content(const Chunked& c, const Flat& f) {
+        return c.size() == f.size()
+            && std::equal(c.begin(), c.end(), f.begin(), f.end())
+            && std::equal(c.rbegin(), c.rend(), f.rbegin(), f.rend());
+    }
+}
+
+TEST_CASE("chunked_flat_map") {
+    SUBCASE("ctors") {
+        using map_t = chunked_flat_map<int, unsigned, std::less<int>, 4>;
+
+        map_t s0;
+        REQUIRE(s0.empty());
+        REQUIRE(s0.begin() == s0.end());
+        REQUIRE(s0.chunk_count() == 0);
+
+        map_t s1{{5, 50u}, {1, 10u}, {3, 30u}, {1, 11u}, {9, 90u}, {7, 70u}};
+        REQUIRE(s1.size() == 5);
+        REQUIRE(s1.chunk_count() == 2);
+        REQUIRE(same_content(s1, flat_map<int, unsigned>{{1, 10u}, {3, 30u}, {5, 50u}, {7, 70u}, {9, 90u}}));
+
+        const std::vector<std::pair<int, unsigned>> v{{2, 20u}, {1, 10u}};
+        chunked_flat_map<int, unsigned, std::greater<int>, 2> s2(v.begin(), v.end(), std::greater<int>());
+        REQUIRE(s2.begin()->first == 2);
+
+        map_t s3 = s1;
+        REQUIRE(s3 == s1);
+        s3 = {{1, 1u}};
+        REQUIRE(s3 != s1);
+        swap(s3, s1);
+        REQUIRE(s1.size() == 1);
+        REQUIRE(s3.size() == 5);
+    }
+    SUBCASE("random_operations") {
+        chunked_flat_map<int, unsigned, std::less<int>, 8> s0;
+        flat_map<int, unsigned> s1;
+
+        std::mt19937 gen(5);
+        std::uniform_int_distribution<int> keys(0, 500);
+        for ( unsigned i = 0; i < 20000; ++i ) {
+            const int key = keys(gen);
+            switch ( gen() % 4 ) {
+            case 0: {
+                const auto r0 = s0.insert({key, i});
+                const auto r1 = s1.insert({key, i});
+                REQUIRE(r0.second == r1.second);
+                REQUIRE(r0.first->first == key);
+                REQUIRE(r0.first->second == r1.first->second);
+                break;
+            }
+            case 1:
+                REQUIRE(s0.erase(key) == s1.erase(key));
+                break;
+            case 2: {
+                const auto iter = s0.lower_bound(key);
+                if ( iter != s0.end() ) {
+                    const int erased = iter->first;
+                    const auto next = s0.erase(iter);
+                    s1.erase(erased);
+                    REQUIRE((next == s0.end()) == (s1.upper_bound(erased) == s1.end()));
+                    REQUIRE((next == s0.end() || next->first == s1.upper_bound(erased)->first));
+                }
+                break;
+            }
+            default:
+                s0.insert_or_assign(key, i);
+                s1.insert_or_assign(key, i);
+                break;
+            }
+
+            REQUIRE(s0.contains(key) == s1.contains(key));
+            REQUIRE(s0.count(key + 1) == s1.count(key + 1));
+            REQUIRE((s0.upper_bound(key) == s0.end()) == (s1.upper_bound(key) == s1.end()));
+        }
+
+        REQUIRE(same_content(s0, s1));
+        REQUIRE(s0.chunk_count() >= s0.size() / 8);
+        for ( int key = -1; key < 502; ++key ) {
+            REQUIRE(std::distance(s0.begin(), s0.lower_bound(key)) == s1.lower_bound(key) - s1.begin());
+            REQUIRE(std::distance(s0.begin(), s0.upper_bound(key)) == s1.upper_bound(key) - s1.begin());
+            const auto r0 = my_as_const(s0).equal_range(key);
+            REQUIRE(std::distance(r0.first, r0.second) == static_cast<std::ptrdiff_t>(s1.count(key)));
+        }
+    }
+    SUBCASE("sequential_inserts") {
+        chunked_flat_map<int, int, std::less<int>, 16> s0;
+        for ( int i = 0; i < 1000; ++i ) {
+            REQUIRE(s0.try_emplace(i, -i).second);
+        }
+        for ( int i = -1; i > -1000; --i ) {
+            REQUIRE(s0.emplace(i, -i).second);
+        }
+        REQUIRE(s0.size() == 1999);
+        REQUIRE(s0.begin()->first == -999);
+        REQUIRE(s0.rbegin()->first == 999);
+        REQUIRE(s0.chunk_count() < 1999 / 8 + 2);
+
+        int expected = -999;
+        for ( const auto& pair : s0 ) {
+            REQUIRE(pair.first == expected++);
+        }
+    }
+    SUBCASE("sparse_erases") {
+        chunked_flat_map<int, int, std::less<int>, 16> s0;
+        for ( int i = 0; i < 1000; ++i ) {
+            s0.emplace(i, i);
+        }
+        for ( auto iter = s0.begin(); iter != s0.end(); ) {
+            const int key = iter->first;
+            iter = key % 10 != 0 ? s0.erase(iter) : std::next(iter);
+            REQUIRE((iter == s0.end() || iter->first == key + 1));
+        }
+        REQUIRE(s0.size() == 100);
+        REQUIRE(s0.chunk_count() <= s0.size() / 4 + 1);
+
+        int expected = 0;
+        for ( const auto& pair : s0 ) {
+            REQUIRE(pair.first == expected);
+            expected += 10;
+        }
+        REQUIRE(s0.find(500)->second == 500);
+        REQUIRE_FALSE(s0.contains(501));
+    }
+    SUBCASE("element_access") {
+        chunked_flat_map<std::string, int, std::less<>, 4> s0;
+        s0["hello"] = 1;
+        s0["world"] += 2;
+        s0.try_emplace("hello", 10);
+        REQUIRE(s0.at("hello") == 1);
+        REQUIRE(my_as_const(s0).at("world") == 2);
+        REQUIRE_THROWS_AS(s0.at("none"), std::out_of_range);
+
+        REQUIRE(s0.find(std::string_view("world"))->second == 2);
+        REQUIRE(my_as_const(s0).contains(std::string_view("hello")));
+        REQUIRE(s0.count(std::string_view("none")) == 0);
+        REQUIRE(s0.lower_bound(std::string_view("i"))->first == "world");
+        REQUIRE(s0.upper_bound(std::string_view("world")) == s0.end());
+
+        chunked_flat_map<std::string, int, std::less<>, 4>::const_iterator iter = s0.begin();
+        REQUIRE(iter == s0.cbegin());
+        REQUIRE(++iter != s0.cend());
+        REQUIRE(--iter == s0.cbegin());
+
+        s0.clear();
+        REQUIRE(s0.empty());
+        REQUIRE(s0.chunk_count() == 0);
+    }
+}
@@ -0,0 +1,124 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <flat.hpp/compressed_flat_set.hpp>
+#include <flat.hpp/flat_set.hpp>
+#include "flat_tests.hpp"
+
+#include <random>
+
+namespace
+{
+    using namespace flat_hpp;
+
+    flat_set<std::uint64_t> make_random_set(std::size_t count, std::uint64_t range) {
+        std::mt19937_64 gen(42);
+        std::uniform_int_distribution<std::uint64_t> dist(0, range);
+        flat_set<std::uint64_t> set;
+        while ( set.size() < count ) {
+            set.insert(dist(gen));
+        }
+        return set;
+    }
+}
+
+TEST_CASE("compressed_flat_set") {
+    SUBCASE("types") {
+        using set_t = compressed_flat_set<std::uint32_t>;
+        STATIC_REQUIRE(set_t::block_size == 128);
+        STATIC_REQUIRE(std::is_same_v<set_t::value_type, std::uint32_t>);
+        STATIC_REQUIRE(std::is_same_v<
+            std::iterator_traits<set_t::const_iterator>::iterator_category,
+            std::input_iterator_tag>);
+        STATIC_REQUIRE(std::is_same_v<
+            std::iterator_traits<set_t::const_iterator>::reference,
+            std::uint32_t>);
+    }
+    SUBCASE("empty") {
+        compressed_flat_set<std::uint32_t> s0;
+        REQUIRE(s0.empty());
+        REQUIRE(s0.size() == 0);
+        REQUIRE(s0.begin() == s0.end());
+        REQUIRE_FALSE(s0.contains(0));
+        REQUIRE(s0.lower_bound(0) == s0.end());
+        REQUIRE(s0.memory_usage() == 0);
+    }
+    SUBCASE("small") {
+        const std::uint16_t keys[] = {0, 1, 2, 7, 100, 65535};
+        compressed_flat_set<std::uint16_t, 4> s0(sorted_unique_range, std::begin(keys), std::end(keys));
+
+        REQUIRE(s0.size() == 6);
+        REQUIRE(s0.block_count() == 2);
+        REQUIRE(std::equal(s0.begin(), s0.end(), std::begin(keys), std::end(keys)));
+
+        REQUIRE(s0.contains(0));
+        REQUIRE(s0.contains(7));
+        REQUIRE(s0.contains(65535));
+        REQUIRE_FALSE(s0.contains(3));
+        REQUIRE(s0.count(100) == 1);
+        REQUIRE(s0.count(101) == 0);
+
+        REQUIRE(*s0.lower_bound(3) == 7);
+        REQUIRE(*s0.lower_bound(8) == 100);
+        REQUIRE(*s0.upper_bound(7) == 100);
+        REQUIRE(s0.upper_bound(65535) == s0.end());
+        REQUIRE(s0.find(5) == s0.end());
+        REQUIRE(*s0.find(2) == 2);
+
+        const auto p = s0.equal_range(100);
+        REQUIRE(*p.first == 100);
+        REQUIRE(*p.second == 65535);
+
+        std::uint16_t block[4] = {};
+        s0.decode_block(0, block);
+        REQUIRE(std::equal(block, block + 4, std::begin(keys)));
+        s0.decode_block(1, block);
+        REQUIRE(block[0] == 100);
+        REQUIRE(block[1] == 65535);
+    }
+    SUBCASE("random") {
+        const auto set = make_random_set(10000, 1000000);
+        const compressed_flat_set<std::uint64_t> s0(set);
+
+        REQUIRE(s0.size() == set.size());
+        REQUIRE(std::equal(s0.begin(), s0.end(), set.begin(), set.end()));
+        REQUIRE(s0.memory_usage() * 4 < set.size() * sizeof(std::uint64_t));
+
+        std::mt19937_64 gen(21);
+        std::uniform_int_distribution<std::uint64_t> dist(0, 1000001);
+        for ( int i = 0; i < 1000; ++i ) {
+            const std::uint64_t key = dist(gen);
+            REQUIRE(s0.contains(key) == set.contains(key));
+            const auto iter = s0.lower_bound(key);
+            const auto expected = set.lower_bound(key);
+            REQUIRE((iter == s0.end()) == (expected == set.end()));
+            if ( expected != set.end() ) {
+                REQUIRE(*iter == *expected);
+            }
+        }
+    }
+    SUBCASE("dense") {
+        std::vector<std::uint32_t> keys(1000);
+        for ( std::uint32_t i = 0; i < keys.size(); ++i ) {
+            keys[i] = i + 10;
+        }
+        const compressed_flat_set<std::uint32_t> s0(sorted_unique_range, keys.begin(), keys.end());
+        REQUIRE(std::equal(s0.begin(), s0.end(), keys.begin(), keys.end()));
+        REQUIRE(s0.memory_usage() < 200);
+        REQUIRE(*s0.lower_bound(0) == 10);
+        REQUIRE(s0.lower_bound(1010) == s0.end());
+    }
+    SUBCASE("operators") {
+        const std::uint32_t keys[] = {1, 5, 9};
+        compressed_flat_set<std::uint32_t> s0(sorted_unique_range, std::begin(keys), std::end(keys));
+        compressed_flat_set<std::uint32_t> s1(sorted_unique_range, std::begin(keys), std::end(keys) - 1);
+        REQUIRE(s0 == s0);
+        REQUIRE(s0 != s1);
+        swap(s0, s1);
+        REQUIRE(s0.size() == 2);
+        REQUIRE(s1.size() == 3);
+    }
+}
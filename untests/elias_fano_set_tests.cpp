@@ -0,0 +1,152 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <flat.hpp/elias_fano_set.hpp>
+#include <flat.hpp/flat_set.hpp>
+#include "flat_tests.hpp"
+
+#include <random>
+
+namespace
+{
+    using namespace flat_hpp;
+
+    template < typename Key >
+    flat_set<Key> make_random_set(std::size_t count, Key range) {
+        std::mt19937_64 gen(42);
+        std::uniform_int_distribution<Key> dist(0, range);
+        flat_set<Key> set;
+        while ( set.size() < count ) {
+            set.insert(dist(gen));
+        }
+        return set;
+    }
+}
+
+TEST_CASE("elias_fano_set") {
+    SUBCASE("detail") {
+        REQUIRE(detail::select64(1, 0) == 0);
+        REQUIRE(detail::select64(0x8000000000000000ull, 0) == 63);
+        REQUIRE(detail::select64(0xF0F0ull, 0) == 4);
+        REQUIRE(detail::select64(0xF0F0ull, 4) == 12);
+        REQUIRE(detail::select64(~0ull, 63) == 63);
+        REQUIRE(detail::select64(0x0100000000000100ull, 1) == 56);
+    }
+    SUBCASE("types") {
+        using set_t = elias_fano_set<std::uint32_t>;
+        STATIC_REQUIRE(std::is_same_v<
+            std::iterator_traits<set_t::const_iterator>::iterator_category,
+            std::input_iterator_tag>);
+        STATIC_REQUIRE(std::is_same_v<
+            std::iterator_traits<set_t::const_iterator>::reference,
+            std::uint32_t>);
+    }
+    SUBCASE("empty") {
+        elias_fano_set<std::uint32_t> s0;
+        REQUIRE(s0.empty());
+        REQUIRE(s0.size() == 0);
+        REQUIRE(s0.begin() == s0.end());
+        REQUIRE_FALSE(s0.contains(0));
+        REQUIRE(s0.next_geq(0) == s0.end());
+        REQUIRE(s0.rank(10) == 0);
+    }
+    SUBCASE("small") {
+        const std::uint8_t keys[] = {0, 3, 4, 100, 255};
+        elias_fano_set<std::uint8_t> s0(sorted_unique_range, std::begin(keys), std::end(keys));
+
+        REQUIRE(s0.size() == 5);
+        REQUIRE(std::equal(s0.begin(), s0.end(), std::begin(keys), std::end(keys)));
+
+        REQUIRE(s0.contains(0));
+        REQUIRE(s0.contains(255));
+        REQUIRE_FALSE(s0.contains(1));
+        REQUIRE(s0.count(100) == 1);
+        REQUIRE(*s0.find(4) == 4);
+        REQUIRE(s0.find(5) == s0.end());
+
+        REQUIRE(*s0.next_geq(1) == 3);
+        REQUIRE(*s0.next_geq(5) == 100);
+        REQUIRE(*s0.next_geq(101) == 255);
+
+        REQUIRE(s0.rank(0) == 0);
+        REQUIRE(s0.rank(4) == 2);
+        REQUIRE(s0.rank(5) == 3);
+        REQUIRE(s0.rank(255) == 4);
+
+        for ( std::size_t i = 0; i < s0.size(); ++i ) {
+            REQUIRE(s0.select(i) == keys[i]);
+        }
+    }
+    SUBCASE("random") {
+        const auto set = make_random_set<std::uint64_t>(20000, 5000000);
+        const elias_fano_set<std::uint64_t> s0(set);
+
+        REQUIRE(s0.size() == set.size());
+        REQUIRE(std::equal(s0.begin(), s0.end(), set.begin(), set.end()));
+        REQUIRE(s0.memory_usage() * 4 < set.size() * sizeof(std::uint64_t));
+
+        for ( std::size_t i = 0; i < set.size(); i += 7 ) {
+            REQUIRE(s0.select(i) == set.begin()[static_cast<std::ptrdiff_t>(i)]);
+        }
+
+        std::mt19937_64 gen(21);
+        std::uniform_int_distribution<std::uint64_t> dist(0, 5000001);
+        for ( int i = 0; i < 2000; ++i ) {
+            const std::uint64_t key = dist(gen);
+            const auto expected = set.lower_bound(key);
+            REQUIRE(s0.contains(key) == set.contains(key));
+            REQUIRE(s0.rank(key) == static_cast<std::size_t>(std::distance(set.begin(), expected)));
+            const auto iter = s0.next_geq(key);
+            REQUIRE((iter == s0.end()) == (expected == set.end()));
+            if ( expected != set.end() ) {
+                REQUIRE(*iter == *expected);
+            }
+        }
+    }
+    SUBCASE("clustered") {
+        std::vector<std::uint64_t> keys;
+        for ( std::uint64_t i = 0; i < 1000; ++i ) {
+            keys.push_back(1000000 + i * 3);
+        }
+        keys.push_back(3000000);
+        keys.push_back(3000001);
+        const elias_fano_set<std::uint64_t> s0(sorted_unique_range, keys.begin(), keys.end());
+
+        REQUIRE(s0.rank(0) == 0);
+        REQUIRE(*s0.next_geq(0) == 1000000);
+        REQUIRE(*s0.next_geq(1002998) == 3000000);
+        REQUIRE(s0.next_geq(3000002) == s0.end());
+        for ( std::uint64_t i = 0; i < 1000; ++i ) {
+            REQUIRE(s0.rank(1000000 + i * 3) == i);
+            REQUIRE(s0.rank(1000000 + i * 3 + 1) == i + 1);
+            REQUIRE(*s0.next_geq(1000000 + i * 3 - 1) == 1000000 + i * 3);
+        }
+        REQUIRE(s0.rank(3000001) == 1001);
+    }
+    SUBCASE("dense") {
+        std::vector<std::uint16_t> keys(3000);
+        for ( std::size_t i = 0; i < keys.size(); ++i ) {
+            keys[i] = static_cast<std::uint16_t>(i * 2 + 1);
+        }
+        const elias_fano_set<std::uint16_t> s0(sorted_unique_range, keys.begin(), keys.end());
+        REQUIRE(std::equal(s0.begin(), s0.end(), keys.begin(), keys.end()));
+        for ( std::uint16_t key = 0; key < 6010; ++key ) {
+            REQUIRE(s0.rank(key) == std::min(key / 2u, 3000u));
+            REQUIRE(s0.contains(key) == (key % 2 == 1 && key < 6000));
+        }
+        REQUIRE(s0.select(2999) == 5999);
+    }
+    SUBCASE("operators") {
+        const std::uint32_t keys[] = {1, 5, 9};
+        elias_fano_set<std::uint32_t> s0(sorted_unique_range, std::begin(keys), std::end(keys));
+        elias_fano_set<std::uint32_t> s1(sorted_unique_range, std::begin(keys), std::end(keys) - 1);
+        REQUIRE(s0 == s0);
+        REQUIRE(s0 != s1);
+        swap(s0, s1);
+        REQUIRE(s0.size() == 2);
+        REQUIRE(s1.size() == 3);
+    }
+}
@@ -0,0 +1,119 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <flat.hpp/filtered_flat.hpp>
+#include <flat.hpp/flat_map.hpp>
+#include <flat.hpp/flat_multiset.hpp>
+#include <flat.hpp/flat_set.hpp>
+#include "flat_tests.hpp"
+
+#include <cmath>
+#include <string>
+
+namespace
+{
+    using namespace flat_hpp;
+}
+
+TEST_CASE("filtered_flat") {
+    SUBCASE("blocked_bloom") {
+        detail::blocked_bloom f0;
+        REQUIRE(f0.may_contain(42));
+        REQUIRE(f0.memory_usage() == 0);
+
+        detail::blocked_bloom f1(1000, 10);
+        REQUIRE(f1.hash_count() == 6);
+        REQUIRE(f1.memory_usage() == 20 * 64);
+        for ( std::uint64_t i = 0; i < 1000; ++i ) {
+            f1.add(detail::mix64(i));
+        }
+        for ( std::uint64_t i = 0; i < 1000; ++i ) {
+            REQUIRE(f1.may_contain(detail::mix64(i)));
+        }
+
+        std::size_t false_positives = 0;
+        for ( std::uint64_t i = 1000; i < 101000; ++i ) {
+            false_positives += f1.may_contain(detail::mix64(i)) ? 1 : 0;
+        }
+        const double measured = static_cast<double>(false_positives) / 100000.0;
+        REQUIRE(f1.false_positive_rate() > 0.0);
+        REQUIRE(f1.false_positive_rate() < 0.03);
+        REQUIRE(measured < 0.03);
+        REQUIRE(std::abs(measured - f1.false_positive_rate()) < 0.01);
+    }
+    SUBCASE("lookups") {
+        flat_set<std::string> s;
+        for ( int i = 0; i < 2000; i += 2 ) {
+            s.insert(std::to_string(i));
+        }
+
+        filtered_flat<flat_set<std::string>> f0(std::move(s));
+        REQUIRE(f0.size() == 1000);
+        for ( int i = 0; i < 2000; ++i ) {
+            const std::string key = std::to_string(i);
+            REQUIRE(f0.contains(key) == (i % 2 == 0));
+            REQUIRE(f0.count(key) == (i % 2 == 0 ? 1u : 0u));
+            REQUIRE((f0.find(key) != f0.end()) == (i % 2 == 0));
+        }
+
+        const filter_stats stats = f0.stats();
+        REQUIRE(stats.key_count == 1000);
+        REQUIRE(stats.stale_count == 0);
+        REQUIRE(stats.memory_usage == 20 * 64);
+        REQUIRE(std::abs(stats.bits_per_key - 10.24) < 1e-9);
+        REQUIRE(stats.false_positive_rate < 0.03);
+
+        const flat_set<std::string> s0 = std::move(f0).extract();
+        REQUIRE(s0.size() == 1000);
+        REQUIRE(f0.empty());
+        REQUIRE_FALSE(f0.contains("0"));
+    }
+    SUBCASE("incremental") {
+        filtered_flat<flat_map<int, unsigned>> f0;
+        for ( int i = 0; i < 1000; ++i ) {
+            REQUIRE(f0.insert({i, static_cast<unsigned>(i)}).second);
+            REQUIRE_FALSE(f0.insert({i, 0u}).second);
+        }
+        for ( int i = 0; i < 1000; ++i ) {
+            REQUIRE(f0.find(i)->second == static_cast<unsigned>(i));
+        }
+        REQUIRE(f0.stats().key_count == 1000);
+        REQUIRE(f0.stats().memory_usage * 8 < 1000 * 2 * 11);
+
+        f0.find(5)->second = 50;
+        REQUIRE(f0.flat().at(5) == 50);
+
+        REQUIRE(f0.erase(5) == 1);
+        REQUIRE(f0.erase(5) == 0);
+        REQUIRE_FALSE(f0.contains(5));
+        REQUIRE(f0.stats().stale_count == 1);
+
+        f0.freeze();
+        REQUIRE(f0.stats().stale_count == 0);
+        REQUIRE(f0.stats().key_count == 999);
+
+        f0.clear();
+        REQUIRE_FALSE(f0.contains(1));
+        f0.insert({1, 1u});
+        REQUIRE(f0.contains(1));
+
+        const std::vector<std::pair<int, unsigned>> pairs{{7, 7u}, {8, 8u}};
+        f0.insert(pairs.begin(), pairs.end());
+        REQUIRE(f0.stats().key_count == 3);
+        REQUIRE(f0.contains(8));
+    }
+    SUBCASE("multi") {
+        filtered_flat<flat_multiset<int>> f0(flat_multiset<int>{1, 1, 2}, 16);
+        REQUIRE(f0.count(1) == 2);
+        REQUIRE(f0.count(3) == 0);
+        f0.insert(3);
+        f0.insert(3);
+        REQUIRE(f0.count(3) == 2);
+        REQUIRE(f0.erase(1) == 2);
+        REQUIRE(f0.stats().stale_count == 2);
+        REQUIRE(f0.stats().hash_count == 11);
+    }
+}
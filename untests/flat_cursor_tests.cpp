@@ -0,0 +1,72 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <flat.hpp/flat_cursor.hpp>
+#include <flat.hpp/flat_map.hpp>
+#include <flat.hpp/flat_set.hpp>
+#include "flat_tests.hpp"
+
+#include <string>
+#include <string_view>
+
+namespace
+{
+    using namespace flat_hpp;
+}
+
+TEST_CASE("flat_cursor") {
+    SUBCASE("detail") {
+        const std::vector<int> v{1, 3, 3, 5, 7, 9, 11, 13, 15, 17};
+        for ( int key = 0; key <= 18; ++key ) {
+            for ( auto hint = v.begin(); hint <= v.end(); ++hint ) {
+                REQUIRE(detail::gallop_lower_bound(v.begin(), v.end(), hint, key, std::less<>())
+                    == std::lower_bound(v.begin(), v.end(), key));
+                REQUIRE(detail::gallop_upper_bound(v.begin(), v.end(), hint, key, std::less<>())
+                    == std::upper_bound(v.begin(), v.end(), key));
+            }
+        }
+        const std::vector<int> e;
+        REQUIRE(detail::gallop_lower_bound(e.begin(), e.end(), e.begin(), 42, std::less<>()) == e.end());
+    }
+    SUBCASE("cursor") {
+        using map_t = flat_map<int, unsigned>;
+
+        map_t s0;
+        for ( int i = 0; i < 100; ++i ) {
+            s0.emplace(i * 2, static_cast<unsigned>(i));
+        }
+
+        flat_cursor<map_t> c0(s0);
+        for ( int key = 0; key < 200; ++key ) {
+            REQUIRE(c0.lower_bound(key) == s0.lower_bound(key));
+            REQUIRE(c0.contains(key) == s0.contains(key));
+        }
+        REQUIRE(c0.position() == s0.end());
+
+        REQUIRE(c0.find(10)->second == 5u);
+        REQUIRE(c0.position() == s0.find(10));
+        REQUIRE(c0.find(11) == s0.end());
+        REQUIRE(c0.position() == s0.find(10));
+
+        s0.clear();
+        REQUIRE(c0.position() == s0.end());
+        REQUIRE(c0.lower_bound(42) == s0.end());
+
+        c0.reset();
+        REQUIRE(c0.position() == s0.begin());
+    }
+    SUBCASE("const_cursor") {
+        using set_t = flat_set<std::string, std::less<>>;
+
+        const set_t s0{"a", "b", "c", "d"};
+        flat_cursor<const set_t> c0(s0);
+        STATIC_REQUIRE(std::is_same_v<flat_cursor<const set_t>::iterator, set_t::const_iterator>);
+        REQUIRE(*c0.lower_bound(std::string_view("bb")) == "c");
+        REQUIRE(c0.contains(std::string_view("d")));
+        REQUIRE_FALSE(c0.contains(std::string_view("e")));
+        REQUIRE(*c0.position() == "d");
+    }
+}
@@ -0,0 +1,139 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <flat.hpp/flat_diff.hpp>
+#include <flat.hpp/flat_map.hpp>
+#include <flat.hpp/flat_set.hpp>
+#include "flat_tests.hpp"
+
+#include <deque>
+#include <random>
+#include <string>
+
+namespace
+{
+    using namespace flat_hpp;
+
+    struct counting_less {
+        std::size_t* counter = nullptr;
+
+        bool operator()(int l, int r) const {
+            ++*counter;
+            return l < r;
+        }
+    };
+}
+
+TEST_CASE("flat_diff") {
+    SUBCASE("diff") {
+        using map_t = flat_map<int, std::string>;
+
+        const map_t from{{1, "a"}, {2, "b"}, {3, "c"}, {5, "e"}};
+        const map_t to{{0, "z"}, {2, "b"}, {3, "C"}, {4, "d"}, {6, "f"}};
+
+        std::vector<int> added;
+        std::vector<int> removed;
+        std::vector<std::string> changed;
+        diff(from, to,
+            [&added](const auto& value){ added.push_back(value.first); },
+            [&removed](const auto& value){ removed.push_back(value.first); },
+            [&changed](const auto& l, const auto& r){ changed.push_back(l.second + r.second); });
+
+        REQUIRE(added == std::vector<int>{0, 4, 6});
+        REQUIRE(removed == std::vector<int>{1, 5});
+        REQUIRE(changed == std::vector<std::string>{"cC"});
+    }
+    SUBCASE("diff_sets") {
+        using set_t = flat_set<int>;
+
+        std::vector<int> added;
+        std::vector<int> removed;
+        std::size_t changed = 0;
+        diff(set_t{1, 2, 3}, set_t{2, 3, 4, 5},
+            [&added](int value){ added.push_back(value); },
+            [&removed](int value){ removed.push_back(value); },
+            [&changed](int, int){ ++changed; });
+
+        REQUIRE(added == std::vector<int>{4, 5});
+        REQUIRE(removed == std::vector<int>{1});
+        REQUIRE(changed == 0u);
+
+        diff(set_t{}, set_t{},
+            [](int){ REQUIRE(false); },
+            [](int){ REQUIRE(false); },
+            [](int, int){ REQUIRE(false); });
+    }
+    SUBCASE("galloping") {
+        using set_t = flat_set<int, counting_less>;
+
+        std::size_t counter = 0;
+        set_t from(counting_less{&counter});
+        set_t to(counting_less{&counter});
+        for ( int i = 0; i < 10000; ++i ) {
+            from.insert(i * 2);
+        }
+        to.insert({5001, 5003});
+
+        counter = 0;
+        std::size_t added = 0;
+        std::size_t removed = 0;
+        diff(from, to,
+            [&added](int){ ++added; },
+            [&removed](int){ ++removed; },
+            [](int, int){});
+
+        REQUIRE(added == 2u);
+        REQUIRE(removed == 10000u);
+        REQUIRE(counter < 200u);
+    }
+    SUBCASE("patch") {
+        using map_t = flat_map<int, std::string>;
+
+        const map_t from{{1, "a"}, {2, "b"}, {3, "c"}, {5, "e"}};
+        const map_t to{{0, "z"}, {2, "b"}, {3, "C"}, {4, "d"}, {6, "f"}};
+
+        const flat_patch<map_t> patch = make_patch(from, to);
+        REQUIRE(patch.size() == 6u);
+        REQUIRE(patch.erasures() == std::vector<int>{1, 5});
+        REQUIRE(patch.upserts().size() == 4u);
+
+        map_t target = from;
+        patch.apply(target);
+        REQUIRE(target == to);
+
+        map_t empty;
+        patch.apply(empty);
+        REQUIRE(empty == map_t{{0, "z"}, {3, "C"}, {4, "d"}, {6, "f"}});
+
+        REQUIRE(make_patch(to, to).empty());
+    }
+    SUBCASE("patch_deque") {
+        using map_t = flat_map<int, std::string, std::less<int>, std::deque<std::pair<int, std::string>>>;
+
+        const map_t from{{1, "a"}, {2, "b"}, {4, "d"}};
+        const map_t to{{2, "B"}, {3, "c"}, {4, "d"}};
+
+        map_t target = from;
+        make_patch(from, to).apply(target);
+        REQUIRE(target == to);
+    }
+    SUBCASE("patch_random") {
+        using set_t = flat_set<int>;
+        std::mt19937 engine(17);
+
+        for ( int round = 0; round < 20; ++round ) {
+            set_t from;
+            set_t to;
+            for ( int i = 0; i < 300; ++i ) {
+                from.insert(static_cast<int>(engine() % 500u));
+                to.insert(static_cast<int>(engine() % 500u));
+            }
+            set_t target = from;
+            make_patch(from, to).apply(target);
+            REQUIRE(target == to);
+        }
+    }
+}
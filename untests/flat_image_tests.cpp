@@ -0,0 +1,121 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <flat.hpp/flat_image.hpp>
+#include <flat.hpp/flat_map.hpp>
+#include <flat.hpp/flat_map_view.hpp>
+#include <flat.hpp/flat_set.hpp>
+#include <flat.hpp/flat_set_view.hpp>
+#include "flat_tests.hpp"
+
+#include <deque>
+#include <sstream>
+#include <string>
+
+namespace
+{
+    using namespace flat_hpp;
+
+    std::vector<std::uint64_t> to_aligned_image(const std::string& bytes) {
+        std::vector<std::uint64_t> image((bytes.size() + 7) / 8);
+        std::memcpy(image.data(), bytes.data(), bytes.size());
+        return image;
+    }
+}
+
+TEST_CASE("flat_image") {
+    SUBCASE("traits") {
+        STATIC_REQUIRE(image_compare_tag<std::less<int>>::value == 1);
+        STATIC_REQUIRE(image_compare_tag<std::less<>>::value == 1);
+        STATIC_REQUIRE(image_compare_tag<std::greater<int>>::value == 2);
+        STATIC_REQUIRE(image_compare_tag<interpolation_less<int>>::value == 1);
+        STATIC_REQUIRE(image_compare_tag<bool(*)(int, int)>::value == 0);
+        STATIC_REQUIRE(detail::image_key_kind_of<std::int32_t>() != detail::image_key_kind_of<std::uint32_t>());
+        STATIC_REQUIRE(detail::image_key_kind_of<std::int32_t>() != detail::image_key_kind_of<float>());
+        STATIC_REQUIRE(detail::image_key_kind_of<std::int32_t>() != detail::image_key_kind_of<std::int64_t>());
+        STATIC_REQUIRE(detail::is_bitwise_serializable_v<std::pair<int, float>>);
+        STATIC_REQUIRE_FALSE(detail::is_bitwise_serializable_v<std::pair<int, std::string>>);
+        STATIC_REQUIRE_FALSE(detail::is_bitwise_serializable_v<std::pair<std::uint8_t, std::uint32_t>>);
+        STATIC_REQUIRE(detail::is_bitwise_serializable_v<double>);
+        STATIC_REQUIRE(detail::is_contiguous_v<flat_set<int>>);
+        STATIC_REQUIRE(detail::is_contiguous_v<flat_set_view<int>>);
+        STATIC_REQUIRE_FALSE(detail::is_contiguous_v<flat_set<int, std::less<int>, std::deque<int>>>);
+    }
+    SUBCASE("map") {
+        flat_map<int, unsigned> m0{{3,30},{1,10},{2,20}};
+
+        std::ostringstream os;
+        write_image(os, m0);
+        const std::string bytes = os.str();
+        REQUIRE(bytes.size() == sizeof(image_header) + 3 * sizeof(std::pair<int, unsigned>));
+
+        const auto image = to_aligned_image(bytes);
+        const auto v0 = image_view<flat_map_view<int, unsigned>>(image.data(), bytes.size(), true);
+        REQUIRE(v0.size() == 3);
+        REQUIRE(v0.at(1) == 10);
+        REQUIRE(v0.at(3) == 30);
+        REQUIRE(std::equal(v0.begin(), v0.end(), m0.begin(), m0.end()));
+    }
+    SUBCASE("set") {
+        flat_set<int, std::less<int>, std::deque<int>> s0{5,1,3};
+
+        std::ostringstream os;
+        write_image(os, s0);
+        const std::string bytes = os.str();
+
+        const auto image = to_aligned_image(bytes);
+        const auto v0 = image_view<flat_set_view<int>>(image.data(), bytes.size());
+        REQUIRE(std::equal(v0.begin(), v0.end(), s0.begin(), s0.end()));
+
+        using greater_view_t = flat_set_view<int, std::greater<int>>;
+        REQUIRE_THROWS_AS(
+            image_view<greater_view_t>(image.data(), bytes.size()),
+            std::invalid_argument);
+        REQUIRE_THROWS_AS(
+            image_view<flat_set_view<long long>>(image.data(), bytes.size()),
+            std::invalid_argument);
+        REQUIRE_THROWS_AS(
+            image_view<flat_set_view<float>>(image.data(), bytes.size()),
+            std::invalid_argument);
+        REQUIRE_THROWS_AS(
+            image_view<flat_set_view<unsigned>>(image.data(), bytes.size()),
+            std::invalid_argument);
+        REQUIRE_THROWS_AS(
+            image_view<flat_set_view<int>>(image.data(), bytes.size() - 1),
+            std::invalid_argument);
+        REQUIRE_THROWS_AS(
+            image_view<flat_set_view<int>>(image.data(), sizeof(image_header) - 1),
+            std::invalid_argument);
+    }
+    SUBCASE("checksum") {
+        flat_set<int> s0{1,2,3};
+
+        std::ostringstream os;
+        write_image(os, s0);
+        const std::string bytes = os.str();
+
+        auto image = to_aligned_image(bytes);
+        reinterpret_cast<char*>(image.data())[sizeof(image_header)] ^= 1;
+        REQUIRE_NOTHROW(image_view<flat_set_view<int>>(image.data(), bytes.size()));
+        REQUIRE_THROWS_AS(
+            image_view<flat_set_view<int>>(image.data(), bytes.size(), true),
+            std::invalid_argument);
+    }
+    SUBCASE("byte_order") {
+        flat_set<int> s0{1,2,3};
+
+        std::ostringstream os;
+        write_image(os, s0);
+        const std::string bytes = os.str();
+
+        auto image = to_aligned_image(bytes);
+        char* byte_order = reinterpret_cast<char*>(image.data()) + offsetof(image_header, byte_order);
+        std::reverse(byte_order, byte_order + sizeof(std::uint64_t));
+        REQUIRE_THROWS_AS(
+            image_view<flat_set_view<int>>(image.data(), bytes.size()),
+            std::invalid_argument);
+    }
+}
@@ -0,0 +1,116 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <flat.hpp/flat_join.hpp>
+#include <flat.hpp/flat_map.hpp>
+#include <flat.hpp/flat_multimap.hpp>
+#include <flat.hpp/flat_set.hpp>
+#include "flat_tests.hpp"
+
+#include <string>
+
+namespace
+{
+    using namespace flat_hpp;
+
+    struct counting_less {
+        std::size_t* counter = nullptr;
+
+        bool operator()(int l, int r) const {
+            ++*counter;
+            return l < r;
+        }
+    };
+}
+
+TEST_CASE("flat_join") {
+    const flat_map<int, std::string> names{{1, "a"}, {2, "b"}, {4, "d"}, {5, "e"}};
+    const flat_map<int, double> scores{{2, 2.5}, {3, 3.5}, {5, 5.5}};
+
+    SUBCASE("join") {
+        std::vector<std::string> result;
+        join(names, scores, [&result](const auto& l, const auto& r){
+            result.push_back(l.second + std::to_string(static_cast<int>(r.second)));
+        });
+        REQUIRE(result == std::vector<std::string>{"b2", "e5"});
+    }
+    SUBCASE("left_join") {
+        std::vector<std::string> result;
+        left_join(names, scores, [&result](const auto& l, const std::pair<int, double>* r){
+            result.push_back(l.second + (r ? std::to_string(static_cast<int>(r->second)) : "-"));
+        });
+        REQUIRE(result == std::vector<std::string>{"a-", "b2", "d-", "e5"});
+    }
+    SUBCASE("semi_and_anti_join") {
+        const flat_set<int> ids{0, 2, 5, 9};
+
+        std::vector<int> semi;
+        semi_join(names, ids, [&semi](const auto& value){ semi.push_back(value.first); });
+        REQUIRE(semi == std::vector<int>{2, 5});
+
+        std::vector<int> anti;
+        anti_join(names, ids, [&anti](const auto& value){ anti.push_back(value.first); });
+        REQUIRE(anti == std::vector<int>{1, 4});
+
+        std::vector<int> ids_anti;
+        anti_join(ids, scores, [&ids_anti](int id){ ids_anti.push_back(id); });
+        REQUIRE(ids_anti == std::vector<int>{0, 9});
+    }
+    SUBCASE("multimaps") {
+        const flat_multimap<int, char> l{{1, 'a'}, {1, 'b'}, {2, 'c'}, {3, 'd'}};
+        const flat_multimap<int, char> r{{1, 'x'}, {1, 'y'}, {3, 'z'}, {3, 'w'}};
+
+        std::vector<std::string> result;
+        join(l, r, [&result](const auto& a, const auto& b){
+            result.push_back({a.second, b.second});
+        });
+        REQUIRE(result == std::vector<std::string>{"ax", "ay", "bx", "by", "dz", "dw"});
+
+        std::size_t semi = 0;
+        semi_join(l, r, [&semi](const auto&){ ++semi; });
+        REQUIRE(semi == 3u);
+
+        std::size_t unmatched = 0;
+        left_join(l, r, [&unmatched](const auto&, const auto* b){ unmatched += b ? 0 : 1; });
+        REQUIRE(unmatched == 1u);
+    }
+    SUBCASE("multi_join") {
+        const flat_set<int> ids{1, 2, 3, 5, 8};
+
+        std::vector<std::string> result;
+        multi_join([&result](const auto& n, const auto& s, int id){
+            result.push_back(n.second + std::to_string(static_cast<int>(s.second) + id));
+        }, names, scores, ids);
+        REQUIRE(result == std::vector<std::string>{"b4", "e10"});
+
+        std::size_t count = 0;
+        multi_join([&count](int, int){ ++count; }, ids, flat_set<int>{});
+        REQUIRE(count == 0u);
+    }
+    SUBCASE("galloping") {
+        using set_t = flat_set<int, counting_less>;
+
+        std::size_t counter = 0;
+        set_t big(counting_less{&counter});
+        set_t small(counting_less{&counter});
+        for ( int i = 0; i < 10000; ++i ) {
+            big.insert(i);
+        }
+        small.insert({10, 5000, 9999, 20000});
+
+        counter = 0;
+        std::vector<int> result;
+        join(big, small, [&result](int l, int){ result.push_back(l); });
+        REQUIRE(result == std::vector<int>{10, 5000, 9999});
+        REQUIRE(counter < 200u);
+
+        counter = 0;
+        result.clear();
+        multi_join([&result](int l, int, int){ result.push_back(l); }, big, small, big);
+        REQUIRE(result == std::vector<int>{10, 5000, 9999});
+        REQUIRE(counter < 400u);
+    }
+}
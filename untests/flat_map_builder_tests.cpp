@@ -0,0 +1,109 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <flat.hpp/flat_map_builder.hpp>
+#include "flat_tests.hpp"
+
+#include <deque>
+#include <random>
+#include <sstream>
+#include <string>
+
+namespace
+{
+    using namespace flat_hpp;
+
+    std::vector<std::pair<int, unsigned>> make_random_pairs(std::size_t count) {
+        std::mt19937 gen(7);
+        std::uniform_int_distribution<int> dist(0, 3000);
+        std::vector<std::pair<int, unsigned>> pairs;
+        for ( std::size_t i = 0; i < count; ++i ) {
+            pairs.emplace_back(dist(gen), static_cast<unsigned>(i));
+        }
+        return pairs;
+    }
+}
+
+TEST_CASE("flat_map_builder") {
+    SUBCASE("in_memory") {
+        const auto pairs = make_random_pairs(500);
+
+        flat_map_builder<int, unsigned> b0(1 << 20);
+        b0.insert(pairs.begin(), pairs.end());
+        const flat_map<int, unsigned> m0 = b0.build();
+
+        REQUIRE(m0 == flat_map<int, unsigned>(keep_first, pairs.begin(), pairs.end()));
+        REQUIRE(b0.stats().inserted_count == 500);
+        REQUIRE(b0.stats().run_count == 0);
+        REQUIRE(b0.stats().spilled_count == 0);
+        REQUIRE(b0.stats().merged_count == m0.size());
+
+        REQUIRE(b0.build().empty());
+    }
+    SUBCASE("spilled") {
+        const auto pairs = make_random_pairs(5000);
+
+        std::size_t reports = 0;
+        flat_map_builder<int, unsigned> b0(100 * sizeof(std::pair<int, unsigned>));
+        b0.on_progress([&reports](const builder_stats&){
+            ++reports;
+        });
+        for ( const auto& pair : pairs ) {
+            b0.emplace(pair.first, pair.second);
+        }
+        const flat_map<int, unsigned> m0 = b0.build();
+
+        REQUIRE(m0 == flat_map<int, unsigned>(keep_first, pairs.begin(), pairs.end()));
+        REQUIRE(b0.stats().inserted_count == 5000);
+        REQUIRE(b0.stats().run_count == 50);
+        REQUIRE(b0.stats().merged_count == b0.stats().spilled_count);
+        REQUIRE(b0.stats().peak_memory >= 100 * sizeof(std::pair<int, unsigned>));
+        REQUIRE(reports == 51);
+
+        flat_map_builder<int, unsigned, std::greater<>, std::deque<std::pair<int, unsigned>>> b1(64);
+        b1.insert({3, 30u});
+        b1.insert({1, 10u});
+        b1.insert({3, 31u});
+        b1.insert({2, 20u});
+        b1.insert({1, 11u});
+        REQUIRE(b1.build() == flat_map<int, unsigned, std::greater<>, std::deque<std::pair<int, unsigned>>>{
+            {1, 10u}, {2, 20u}, {3, 30u}});
+    }
+    SUBCASE("image") {
+        const auto pairs = make_random_pairs(3000);
+
+        flat_map_builder<int, unsigned> b0(256);
+        b0.insert(pairs.begin(), pairs.end());
+        std::stringstream ss0;
+        ss0 << "prefix";
+        b0.build(ss0);
+
+        ss0.seekg(6);
+        flat_map<int, unsigned> m0;
+        load(ss0, m0, true);
+        REQUIRE(m0 == flat_map<int, unsigned>(keep_first, pairs.begin(), pairs.end()));
+
+        flat_map_builder<std::string, int> b1(1);
+        b1.insert({"world", 1});
+        b1.insert({"hello", 2});
+        b1.insert({"world", 3});
+        std::stringstream ss1;
+        b1.build(ss1);
+
+        flat_map<std::string, int> m1;
+        load(ss1, m1, true);
+        REQUIRE(m1 == flat_map<std::string, int>{{"hello", 2}, {"world", 1}});
+
+        flat_map_builder<int, unsigned> b2(1024);
+        b2.insert({1, 1u});
+        std::stringstream ss2;
+        b2.build(ss2);
+
+        flat_map<int, unsigned> m2;
+        load(ss2, m2, true);
+        REQUIRE(m2 == flat_map<int, unsigned>{{1, 1u}});
+    }
+}
@@ -8,6 +8,7 @@
 #include "flat_tests.hpp"
 
 #include <deque>
+#include <numeric>
 #include <string>
 #include <string_view>
 
@@ -52,6 +53,47 @@ namespace
     constexpr std::add_const_t<T>& my_as_const(T& t) noexcept {
         return t;
     }
+
+    struct op_counts {
+        int constructs = 0;
+        int copies = 0;
+        int moves = 0;
+    };
+
+    class counted {
+    public:
+        counted(op_counts& counts, int value)
+        : counts_(&counts)
+        , value_(value) {
+            ++counts_->constructs;
+        }
+
+        counted(const counted& other)
+        : counts_(other.counts_)
+        , value_(other.value_) {
+            ++counts_->copies;
+        }
+
+        counted(counted&& other) noexcept
+        : counts_(other.counts_)
+        , value_(other.value_) {
+            ++counts_->moves;
+        }
+
+        counted& operator=(const counted& other) = default;
+        counted& operator=(counted&& other) noexcept = default;
+
+        int value() const noexcept {
+            return value_;
+        }
+
+        friend bool operator<(const counted& l, const counted& r) noexcept {
+            return l.value_ < r.value_;
+        }
+    private:
+        op_counts* counts_ = nullptr;
+        int value_ = 0;
+    };
 }
 
 TEST_CASE("flat_map") {
@@ -660,4 +702,302 @@ TEST_CASE("flat_map") {
         REQUIRE(s0 <= s0);
         REQUIRE(s0 >= s0);
     }
+#ifdef FLAT_HPP_HAS_MEMORY_RESOURCE
+    SUBCASE("pmr") {
+        using map_t = flat_hpp::pmr::flat_map<int, unsigned>;
+        using alloc_t = map_t::container_type::allocator_type;
+        STATIC_REQUIRE(std::is_same_v<alloc_t, std::pmr::polymorphic_allocator<map_t::value_type>>);
+
+        std::pmr::monotonic_buffer_resource arena;
+        // catches element storage outside the arena, the temporary buffers
+        // of std::stable_sort and std::inplace_merge use operator new instead
+        std::pmr::memory_resource* default_resource =
+            std::pmr::set_default_resource(std::pmr::null_memory_resource());
+
+        map_t s0{alloc_t(&arena)};
+        s0 = {{3,4},{1,2}};
+        s0.insert({5,6});
+        map_t s1({{1,2},{3,4}}, alloc_t(&arena));
+        s1.insert({5,6});
+
+        std::pmr::set_default_resource(default_resource);
+        REQUIRE(s0.get_allocator().resource() == &arena);
+        REQUIRE(s0 == map_t{{1,2},{3,4},{5,6}});
+        REQUIRE(s1 == map_t{{1,2},{3,4},{5,6}});
+    }
+#endif
+    SUBCASE("extract") {
+        using map_t = flat_map<int, unsigned>;
+
+        map_t s0{{3,4},{1,2}};
+        map_t::container_type c0 = std::move(s0).extract();
+        REQUIRE(s0.empty());
+        REQUIRE(c0 == map_t::container_type{{1,2},{3,4}});
+
+        const map_t::container_type c1{{4,1},{5,2}};
+        s0.replace(map_t::container_type(c1));
+        REQUIRE(s0 == map_t(sorted_range, c1.begin(), c1.end()));
+        REQUIRE(std::move(s0).extract() == c1);
+    }
+    SUBCASE("order_statistics") {
+        using map_t = flat_map<int, unsigned>;
+
+        map_t s0{{1,2},{3,4},{5,6},{7,8}};
+        REQUIRE(s0.nth(2)->first == 5);
+        REQUIRE(my_as_const(s0).nth(3)->second == 8);
+        REQUIRE(s0.nth(4) == s0.end());
+        REQUIRE(s0.index_of(s0.find(3)) == 1);
+
+        REQUIRE(s0.rank(0) == 0);
+        REQUIRE(s0.rank(6) == 3);
+        REQUIRE(s0.count_range(2, 7) == 2);
+        REQUIRE(s0.count_range(7, 2) == 0);
+
+        flat_map<std::string, int, std::less<>> s1{{"a", 1}, {"b", 2}, {"c", 3}};
+        REQUIRE(s1.rank(std::string_view("bb")) == 2);
+        REQUIRE(s1.count_range(std::string_view("a"), std::string_view("z")) == 3);
+    }
+    SUBCASE("ranges") {
+        using map_t = flat_map<int, unsigned>;
+
+        map_t s0{{1,2},{3,4},{5,6},{7,8}};
+        {
+            const auto keys = my_as_const(s0).keys();
+            REQUIRE(keys.size() == 4);
+            REQUIRE(keys[2] == 5);
+            REQUIRE(std::is_sorted(keys.begin(), keys.end()));
+            REQUIRE(std::binary_search(keys.begin(), keys.end(), 7));
+            REQUIRE(std::accumulate(keys.begin(), keys.end(), 0) == 16);
+            REQUIRE(keys.end() - keys.begin() == 4);
+            REQUIRE(*(keys.begin() + 3) == 7);
+        }
+        {
+            for ( unsigned& v : s0.values() ) {
+                v *= 2;
+            }
+            const auto values = my_as_const(s0).values();
+            REQUIRE(std::accumulate(values.begin(), values.end(), 0u) == 40u);
+            REQUIRE(values.front() == 4u);
+            REQUIRE(values.back() == 16u);
+        }
+        {
+            auto r0 = s0.range(2, 7);
+            REQUIRE(r0.size() == 2);
+            REQUIRE(r0.front().first == 3);
+            r0.back().second = 42;
+            REQUIRE(s0.at(5) == 42);
+
+            REQUIRE(my_as_const(s0).range(7, 2).empty());
+            REQUIRE(s0.range_from(4).size() == 2);
+            REQUIRE(my_as_const(s0).range_from(8).empty());
+        }
+        {
+            flat_map<std::string, int, std::less<>> s1{{"a", 1}, {"b", 2}, {"c", 3}};
+            REQUIRE(s1.range(std::string_view("a"), std::string_view("c")).size() == 2);
+            REQUIRE(my_as_const(s1).range_from(std::string_view("b")).front().second == 2);
+        }
+    }
+    SUBCASE("hinted_lookup") {
+        using map_t = flat_map<int, unsigned>;
+
+        map_t s0{{1,2},{3,4},{5,6},{7,8}};
+        for ( int key = 0; key < 9; ++key ) {
+            for ( auto hint = s0.cbegin(); hint <= s0.cend(); ++hint ) {
+                REQUIRE(s0.lower_bound(hint, key) == s0.lower_bound(key));
+                REQUIRE(my_as_const(s0).find(hint, key) == s0.find(key));
+            }
+        }
+
+        REQUIRE(s0.insert(s0.end(), {2, 3})->second == 3u);
+        REQUIRE(s0.insert(s0.begin(), {2, 4})->second == 3u);
+        REQUIRE(s0.size() == 5);
+
+        flat_map<std::string, int, std::less<>> s1{{"a", 1}, {"b", 2}};
+        REQUIRE(s1.find(s1.end(), std::string_view("a"))->second == 1);
+        REQUIRE(my_as_const(s1).lower_bound(s1.begin(), std::string_view("c")) == s1.end());
+    }
+    SUBCASE("append") {
+        struct counting_less {
+            int* count = nullptr;
+            bool operator()(int l, int r) const {
+                ++*count;
+                return l < r;
+            }
+        };
+
+        int comparisons = 0;
+        flat_map<int, unsigned, counting_less> s0(counting_less{&comparisons});
+        for ( int i = 0; i < 30; ++i ) {
+            s0.insert({i, 1u});
+            s0.try_emplace(i + 100, 2u);
+            s0.insert_or_assign(i + 200, 3u);
+            comparisons = 0;
+        }
+        for ( int i = 300; i < 400; ++i ) {
+            s0.emplace(i, 4u);
+        }
+        REQUIRE(comparisons == 100);
+        REQUIRE(s0.size() == 190);
+
+        flat_map<int, unsigned> s1;
+        REQUIRE(s1.append({1, 2})->second == 2u);
+        REQUIRE(s1.emplace_back_unchecked(3, 4u)->first == 3);
+        REQUIRE(s1 == flat_map<int, unsigned>{{1, 2}, {3, 4}});
+    }
+    SUBCASE("emplace_in_place") {
+        op_counts counts;
+        flat_map<int, counted> s0;
+        s0.reserve(8);
+
+        REQUIRE(s0.try_emplace(1, counts, 10).second);
+        REQUIRE(counts.constructs == 1);
+        REQUIRE(counts.moves == 0);
+
+        REQUIRE_FALSE(s0.try_emplace(1, counts, 11).second);
+        REQUIRE(counts.constructs == 1);
+
+        REQUIRE(s0.emplace(2, counted(counts, 20)).second);
+        REQUIRE(counts.moves == 1);
+
+        const counted c0(counts, 30);
+        REQUIRE(s0.emplace_hint(s0.end(), 3, c0)->second.value() == 30);
+        REQUIRE(counts.copies == 1);
+        REQUIRE(counts.moves == 1);
+
+        REQUIRE_FALSE(s0.emplace(std::make_pair(2, c0)).second);
+        REQUIRE(counts.copies == 2);
+        REQUIRE(counts.moves == 1);
+
+        REQUIRE(s0.insert_or_assign(4, c0).second);
+        REQUIRE(counts.copies == 3);
+        REQUIRE(counts.moves == 1);
+
+        REQUIRE(s0.at(1).value() == 10);
+        REQUIRE(s0.size() == 4);
+
+        flat_map<int, std::string> s1;
+        REQUIRE(s1.try_emplace(1).second);
+        REQUIRE(s1[2].empty());
+        REQUIRE(s1.size() == 2);
+    }
+    SUBCASE("upsert") {
+        using map_t = flat_map<int, unsigned>;
+
+        map_t s0;
+        REQUIRE(s0.upsert(1, 10u, std::plus<>()).second);
+        REQUIRE_FALSE(s0.upsert(1, 5u, std::plus<>()).second);
+        const int two = 2;
+        REQUIRE(s0.upsert(two, 7u, std::plus<>()).first->second == 7u);
+        REQUIRE(s0.upsert(two, 1u, [](unsigned l, unsigned r){ return l * 10 + r; }).first->second == 71u);
+        REQUIRE(s0 == map_t{{1, 15}, {2, 71}});
+
+        flat_map<int, std::string> s1{{1, "a"}};
+        s1.upsert(1, std::string("b"), std::plus<>());
+        s1.upsert(0, std::string("z"), std::plus<>());
+        REQUIRE(s1.at(1) == "ab");
+        REQUIRE(s1.at(0) == "z");
+    }
+    SUBCASE("insert_or_combine") {
+        using map_t = flat_map<int, unsigned>;
+        {
+            map_t s0{{1, 1}, {3, 3}, {5, 5}};
+            const std::vector<std::pair<int, unsigned>> v{{5, 10}, {2, 20}, {3, 30}, {2, 40}, {6, 50}, {5, 60}};
+            s0.insert_or_combine(v.begin(), v.end(), std::plus<>());
+            REQUIRE(s0 == map_t{{1, 1}, {2, 60}, {3, 33}, {5, 75}, {6, 50}});
+        }
+        {
+            map_t s0;
+            s0.insert_or_combine({{3, 1}, {1, 2}, {3, 4}}, std::plus<>());
+            REQUIRE(s0 == map_t{{1, 2}, {3, 5}});
+            s0.insert_or_combine({}, std::plus<>());
+            REQUIRE(s0.size() == 2);
+        }
+        {
+            flat_map<int, std::string> s0{{2, "b"}};
+            s0.insert_or_combine({{2, "x"}, {1, "a"}, {2, "y"}, {1, "c"}}, std::plus<>());
+            REQUIRE(s0.at(1) == "ac");
+            REQUIRE(s0.at(2) == "bxy");
+        }
+        {
+            map_t s0;
+            map_t s1;
+            std::vector<std::pair<int, unsigned>> v;
+            for ( unsigned i = 0; i < 1000; ++i ) {
+                v.emplace_back(static_cast<int>(i * 7919 % 211), i);
+            }
+            s0.insert_or_combine(v.begin(), v.begin() + 500, std::plus<>());
+            s0.insert_or_combine(v.begin() + 500, v.end(), std::plus<>());
+            for ( const auto& p : v ) {
+                s1.upsert(p.first, p.second, std::plus<>());
+            }
+            REQUIRE(s0 == s1);
+        }
+    }
+    SUBCASE("duplicate_policy") {
+        using map_t = flat_map<int, unsigned>;
+        const std::vector<std::pair<int, unsigned>> v{{3, 1}, {1, 2}, {3, 3}, {2, 4}, {1, 5}};
+        {
+            const map_t s0(keep_first, v.begin(), v.end());
+            REQUIRE(s0 == map_t{{1, 2}, {2, 4}, {3, 1}});
+
+            const map_t s1(keep_last, v.begin(), v.end());
+            REQUIRE(s1 == map_t{{1, 5}, {2, 4}, {3, 3}});
+
+            const map_t s2(combine(std::plus<>()), v.begin(), v.end());
+            REQUIRE(s2 == map_t{{1, 7}, {2, 4}, {3, 4}});
+
+            const flat_map<int, unsigned, std::greater<int>> s3(keep_last, v.begin(), v.end(), std::greater<int>());
+            REQUIRE(s3.begin()->second == 3u);
+
+            const map_t s4(keep_last, {{1, 1}, {1, 2}});
+            REQUIRE(s4.at(1) == 2u);
+
+            const map_t s5(keep_last, {{1, 1}, {1, 2}}, std::less<int>());
+            REQUIRE(s5.at(1) == 2u);
+
+            const map_t s6(keep_first, v.begin(), v.end(), std::allocator<std::pair<int, unsigned>>());
+            REQUIRE(s6 == s0);
+
+            const map_t s7(combine(std::plus<>()), v.begin(), v.end(), std::less<int>(), std::allocator<std::pair<int, unsigned>>());
+            REQUIRE(s7 == s2);
+
+            const map_t s8(keep_first, {{1, 1}, {1, 2}}, std::allocator<std::pair<int, unsigned>>());
+            REQUIRE(s8.at(1) == 1u);
+        }
+        {
+            map_t s0{{1, 10}, {4, 40}};
+            s0.insert(keep_first, v.begin(), v.end());
+            REQUIRE(s0 == map_t{{1, 10}, {2, 4}, {3, 1}, {4, 40}});
+
+            map_t s1{{1, 10}, {4, 40}};
+            s1.insert(keep_last, v.begin(), v.end());
+            REQUIRE(s1 == map_t{{1, 5}, {2, 4}, {3, 3}, {4, 40}});
+
+            map_t s2{{1, 10}, {4, 40}};
+            s2.insert(combine([](unsigned l, unsigned r){ return l * 10 + r; }), v.begin(), v.end());
+            REQUIRE(s2 == map_t{{1, 1025}, {2, 4}, {3, 13}, {4, 40}});
+
+            map_t s3{{1, 10}};
+            s3.insert(keep_last, {{1, 11}, {0, 1}});
+            REQUIRE(s3 == map_t{{0, 1}, {1, 11}});
+        }
+    }
+    SUBCASE("interpolation_search") {
+        using map_t = flat_map<std::uint64_t, unsigned, interpolation_less<std::uint64_t>>;
+
+        map_t s0;
+        for ( std::uint64_t i = 0; i < 1000; ++i ) {
+            s0.emplace_back_unchecked(i * i * i, static_cast<unsigned>(i));
+        }
+        s0.emplace_back_unchecked(std::numeric_limits<std::uint64_t>::max(), 1000u);
+
+        for ( std::uint64_t i = 0; i < 1000; ++i ) {
+            REQUIRE(s0.at(i * i * i) == i);
+            REQUIRE(s0.lower_bound(i * i * i + 1) - s0.begin() == static_cast<std::ptrdiff_t>(i + 1));
+            REQUIRE(s0.upper_bound(i * i * i) - s0.begin() == static_cast<std::ptrdiff_t>(i + 1));
+            REQUIRE(s0.equal_range(i * i * i).second - s0.equal_range(i * i * i).first == 1);
+        }
+        REQUIRE(s0.find(std::numeric_limits<std::uint64_t>::max())->second == 1000u);
+        REQUIRE(s0.find(2) == s0.end());
+    }
 }
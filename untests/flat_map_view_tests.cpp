@@ -0,0 +1,94 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <flat.hpp/flat_map_view.hpp>
+#include "flat_tests.hpp"
+
+#include <string>
+#include <string_view>
+
+namespace
+{
+    using namespace flat_hpp;
+}
+
+TEST_CASE("flat_map_view") {
+    SUBCASE("types") {
+        using view_t = flat_map_view<int, unsigned>;
+
+        STATIC_REQUIRE(std::is_same_v<view_t::key_type, int>);
+        STATIC_REQUIRE(std::is_same_v<view_t::mapped_type, unsigned>);
+        STATIC_REQUIRE(std::is_same_v<view_t::value_type, std::pair<int, unsigned>>);
+        STATIC_REQUIRE(std::is_same_v<view_t::const_iterator, const std::pair<int, unsigned>*>);
+
+        STATIC_REQUIRE(std::is_nothrow_default_constructible_v<view_t>);
+        REQUIRE(sizeof(view_t) == sizeof(const void*) * 2);
+    }
+    SUBCASE("lookup") {
+        using view_t = flat_map_view<int, unsigned>;
+        const std::pair<int, unsigned> data[] = {{1,10},{3,30},{5,50}};
+        view_t v0(sorted_unique_range, data, 3);
+
+        REQUIRE(v0.size() == 3);
+        REQUIRE(v0.at(3) == 30);
+        REQUIRE_THROWS_AS(v0.at(4), std::out_of_range);
+        REQUIRE(v0.count(5) == 1);
+        REQUIRE(v0.count(0) == 0);
+        REQUIRE(v0.find(1) == v0.begin());
+        REQUIRE(v0.find(2) == v0.end());
+        REQUIRE(v0.contains(5));
+        REQUIRE(v0.equal_range(3) == std::make_pair(v0.begin() + 1, v0.begin() + 2));
+        REQUIRE(v0.lower_bound(2) == v0.begin() + 1);
+        REQUIRE(v0.upper_bound(5) == v0.end());
+        REQUIRE(v0.value_comp()({1,50},{2,10}));
+    }
+    SUBCASE("order_statistics") {
+        using view_t = flat_map_view<int, unsigned>;
+        const std::pair<int, unsigned> data[] = {{1,10},{3,30},{5,50},{7,70}};
+        view_t v0(sorted_unique_range, data, 4);
+
+        REQUIRE(v0.nth(2)->second == 50);
+        REQUIRE(v0.rank(4) == 2);
+        REQUIRE(v0.index_of(v0.find(7)) == 3);
+        REQUIRE(v0.count_range(2, 7) == 2);
+
+        const auto r0 = v0.range(2, 7);
+        REQUIRE(r0.size() == 2);
+        REQUIRE(r0.front().first == 3);
+        REQUIRE(v0.range_from(4).front().first == 5);
+    }
+    SUBCASE("interpolation") {
+        using view_t = flat_map_view<unsigned, unsigned, interpolation_less<>>;
+        std::vector<std::pair<unsigned, unsigned>> data;
+        for ( unsigned i = 0; i < 500; ++i ) {
+            data.emplace_back(i * i, i);
+        }
+        view_t v0(sorted_unique_range, data.data(), data.size());
+        for ( unsigned i = 0; i < 500; ++i ) {
+            REQUIRE(v0.at(i * i) == i);
+            REQUIRE(v0.lower_bound(i * i + 1) == v0.begin() + i + 1);
+        }
+    }
+    SUBCASE("heterogeneous") {
+        using view_t = flat_map_view<std::string, int, std::less<>>;
+        const std::pair<std::string, int> data[] = {{"hello", 42}, {"world", 84}};
+        view_t v0(sorted_unique_range, data, 2);
+
+        REQUIRE(v0.at(std::string_view("world")) == 84);
+        REQUIRE(v0.find(std::string_view("hello")) == v0.begin());
+        REQUIRE(v0.count(std::string_view("42")) == 0);
+        REQUIRE(v0.upper_bound(std::string_view("hello")) == v0.begin() + 1);
+    }
+    SUBCASE("operators") {
+        using view_t = flat_map_view<int, unsigned>;
+        const std::pair<int, unsigned> data0[] = {{1,10},{3,30}};
+        const std::pair<int, unsigned> data1[] = {{1,10},{3,30}};
+        const std::pair<int, unsigned> data2[] = {{1,10},{3,31}};
+        REQUIRE(view_t(sorted_unique_range, data0, 2) == view_t(sorted_unique_range, data1, 2));
+        REQUIRE(view_t(sorted_unique_range, data0, 2) != view_t(sorted_unique_range, data2, 2));
+        REQUIRE(view_t(sorted_unique_range, data0, 1) != view_t(sorted_unique_range, data1, 2));
+    }
+}
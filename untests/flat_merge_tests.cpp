@@ -0,0 +1,115 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <flat.hpp/flat_map.hpp>
+#include <flat.hpp/flat_merge.hpp>
+#include <flat.hpp/flat_multimap.hpp>
+#include <flat.hpp/flat_multiset.hpp>
+#include <flat.hpp/flat_set.hpp>
+#include "flat_tests.hpp"
+
+#include <deque>
+#include <list>
+#include <random>
+
+namespace
+{
+    using namespace flat_hpp;
+
+    std::vector<std::vector<int>> make_random_runs(std::size_t run_count, std::size_t run_size) {
+        std::mt19937 gen(42);
+        std::uniform_int_distribution<int> dist(0, 5000);
+        std::vector<std::vector<int>> runs(run_count);
+        for ( std::vector<int>& run : runs ) {
+            for ( std::size_t i = 0; i < run_size; ++i ) {
+                run.push_back(dist(gen));
+            }
+            std::sort(run.begin(), run.end());
+        }
+        return runs;
+    }
+}
+
+TEST_CASE("flat_merge") {
+    SUBCASE("loser_tree") {
+        const std::vector<std::vector<int>> runs{{1, 4, 7}, {}, {2, 4, 9}, {0}, {4}};
+        detail::loser_tree<std::vector<int>::const_iterator, std::less<>> tree(
+            detail::collect_runs(runs), std::less<>());
+
+        std::vector<std::pair<int, std::size_t>> result;
+        for ( ; !tree.empty(); tree.pop() ) {
+            result.emplace_back(tree.top(), tree.top_run());
+        }
+        REQUIRE(result == std::vector<std::pair<int, std::size_t>>{
+            {0, 3}, {1, 0}, {2, 2}, {4, 0}, {4, 2}, {4, 4}, {7, 0}, {9, 2}});
+
+        const std::vector<std::vector<int>> no_runs;
+        REQUIRE(detail::loser_tree<std::vector<int>::const_iterator, std::less<>>(
+            detail::collect_runs(no_runs), std::less<>()).empty());
+    }
+    SUBCASE("assign_merged") {
+        const auto runs = make_random_runs(13, 200);
+
+        flat_set<int> s0{-1};
+        s0.assign_merged(runs);
+        flat_multiset<int> s1;
+        s1.assign_merged(runs);
+
+        flat_set<int> e0;
+        flat_multiset<int> e1;
+        for ( const auto& run : runs ) {
+            e0.insert(run.begin(), run.end());
+            e1.insert(run.begin(), run.end());
+        }
+        REQUIRE(s0 == e0);
+        REQUIRE(s1 == e1);
+
+        const std::list<std::deque<int>> other_runs{{3, 5}, {1, 5, 6}};
+        flat_set<int, std::less<int>, std::deque<int>> s2;
+        s2.assign_merged(other_runs);
+        REQUIRE(s2 == flat_set<int, std::less<int>, std::deque<int>>{1, 3, 5, 6});
+    }
+    SUBCASE("assign_merged_maps") {
+        using pairs_t = std::vector<std::pair<int, unsigned>>;
+        const std::vector<pairs_t> runs{{{1, 10}, {3, 30}}, {{1, 11}, {2, 21}}, {{3, 32}}};
+
+        flat_map<int, unsigned> s0;
+        s0.assign_merged(runs);
+        REQUIRE(s0 == flat_map<int, unsigned>{{1, 10}, {2, 21}, {3, 30}});
+
+        flat_multimap<int, unsigned> s1;
+        s1.assign_merged(runs);
+        REQUIRE(s1 == flat_multimap<int, unsigned>(sorted_range,
+            {{1, 10}, {1, 11}, {2, 21}, {3, 30}, {3, 32}}));
+    }
+    SUBCASE("parallel_assign_merged") {
+        const auto runs = make_random_runs(7, 500);
+        for ( std::size_t threads : {0u, 1u, 2u, 3u, 8u} ) {
+            flat_set<int> s0{-1};
+            flat_set<int> e0;
+            parallel_assign_merged(s0, runs, threads);
+            e0.assign_merged(runs);
+            REQUIRE(s0 == e0);
+
+            flat_multiset<int> s1;
+            flat_multiset<int> e1;
+            parallel_assign_merged(s1, runs, threads);
+            e1.assign_merged(runs);
+            REQUIRE(s1 == e1);
+        }
+
+        using pairs_t = std::vector<std::pair<int, unsigned>>;
+        const std::vector<pairs_t> map_runs{{{1, 10}, {3, 30}, {5, 50}}, {{1, 11}, {3, 31}}, {}};
+        flat_multimap<int, unsigned> s2;
+        parallel_assign_merged(s2, map_runs, 2);
+        REQUIRE(s2 == flat_multimap<int, unsigned>(sorted_range,
+            {{1, 10}, {1, 11}, {3, 30}, {3, 31}, {5, 50}}));
+
+        flat_map<int, unsigned> s3{{0, 0}};
+        parallel_assign_merged(s3, std::vector<pairs_t>(), 4);
+        REQUIRE(s3.empty());
+    }
+}
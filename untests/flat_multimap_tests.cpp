@@ -8,6 +8,7 @@
 #include "flat_tests.hpp"
 
 #include <deque>
+#include <numeric>
 #include <string>
 #include <string_view>
 
@@ -52,6 +53,47 @@ namespace
     constexpr std::add_const_t<T>& my_as_const(T& t) noexcept {
         return t;
     }
+
+    struct op_counts {
+        int constructs = 0;
+        int copies = 0;
+        int moves = 0;
+    };
+
+    class counted {
+    public:
+        counted(op_counts& counts, int value)
+        : counts_(&counts)
+        , value_(value) {
+            ++counts_->constructs;
+        }
+
+        counted(const counted& other)
+        : counts_(other.counts_)
+        , value_(other.value_) {
+            ++counts_->copies;
+        }
+
+        counted(counted&& other) noexcept
+        : counts_(other.counts_)
+        , value_(other.value_) {
+            ++counts_->moves;
+        }
+
+        counted& operator=(const counted& other) = default;
+        counted& operator=(counted&& other) noexcept = default;
+
+        int value() const noexcept {
+            return value_;
+        }
+
+        friend bool operator<(const counted& l, const counted& r) noexcept {
+            return l.value_ < r.value_;
+        }
+    private:
+        op_counts* counts_ = nullptr;
+        int value_ = 0;
+    };
 }
 
 TEST_CASE("flat_multimap") {
@@ -634,4 +676,134 @@ TEST_CASE("flat_multimap") {
         REQUIRE(s0 <= s0);
         REQUIRE(s0 >= s0);
     }
+#ifdef FLAT_HPP_HAS_MEMORY_RESOURCE
+    SUBCASE("pmr") {
+        using map_t = flat_hpp::pmr::flat_multimap<int, unsigned>;
+        using alloc_t = map_t::container_type::allocator_type;
+        STATIC_REQUIRE(std::is_same_v<alloc_t, std::pmr::polymorphic_allocator<map_t::value_type>>);
+
+        std::pmr::monotonic_buffer_resource arena;
+        // catches element storage outside the arena, the temporary buffers
+        // of std::stable_sort and std::inplace_merge use operator new instead
+        std::pmr::memory_resource* default_resource =
+            std::pmr::set_default_resource(std::pmr::null_memory_resource());
+
+        map_t s0{alloc_t(&arena)};
+        s0 = {{3,4},{1,2},{1,3}};
+        s0.insert({5,6});
+        map_t s1({{1,2},{1,3},{3,4}}, alloc_t(&arena));
+        s1.insert({5,6});
+
+        std::pmr::set_default_resource(default_resource);
+        REQUIRE(s0.get_allocator().resource() == &arena);
+        REQUIRE(s0 == map_t{{1,2},{1,3},{3,4},{5,6}});
+        REQUIRE(s1 == map_t{{1,2},{1,3},{3,4},{5,6}});
+    }
+#endif
+    SUBCASE("extract") {
+        using map_t = flat_multimap<int, unsigned>;
+
+        map_t s0{{3,4},{1,2},{1,3}};
+        map_t::container_type c0 = std::move(s0).extract();
+        REQUIRE(s0.empty());
+        REQUIRE(c0 == map_t::container_type{{1,2},{1,3},{3,4}});
+
+        const map_t::container_type c1{{4,1},{4,2}};
+        s0.replace(map_t::container_type(c1));
+        REQUIRE(s0 == map_t(sorted_range, c1.begin(), c1.end()));
+        REQUIRE(std::move(s0).extract() == c1);
+    }
+    SUBCASE("order_statistics") {
+        using map_t = flat_multimap<int, unsigned>;
+
+        map_t s0{{1,2},{3,4},{3,5},{7,8}};
+        REQUIRE(s0.nth(1)->first == 3);
+        REQUIRE(my_as_const(s0).nth(3)->second == 8);
+        REQUIRE(s0.index_of(s0.find(7)) == 3);
+
+        REQUIRE(s0.rank(3) == 1);
+        REQUIRE(s0.rank(4) == 3);
+        REQUIRE(s0.count_range(3, 4) == 2);
+
+        flat_multimap<std::string, int, std::less<>> s1{{"a", 1}, {"b", 2}, {"b", 3}};
+        REQUIRE(s1.rank(std::string_view("c")) == 3);
+        REQUIRE(s1.count_range(std::string_view("b"), std::string_view("c")) == 2);
+    }
+    SUBCASE("ranges") {
+        using map_t = flat_multimap<int, unsigned>;
+
+        map_t s0{{1,2},{3,4},{3,5},{7,8}};
+        const auto keys = s0.keys();
+        REQUIRE(std::count(keys.begin(), keys.end(), 3) == 2);
+        REQUIRE(std::accumulate(s0.values().begin(), s0.values().end(), 0u) == 19u);
+        REQUIRE(my_as_const(s0).values()[3] == 8u);
+
+        REQUIRE(s0.range(3, 4).size() == 2);
+        REQUIRE(my_as_const(s0).range_from(4).front().first == 7);
+
+        flat_multimap<std::string, int, std::less<>> s1{{"a", 1}, {"b", 2}, {"b", 3}};
+        REQUIRE(s1.range(std::string_view("b"), std::string_view("c")).size() == 2);
+        REQUIRE(my_as_const(s1).range_from(std::string_view("a")).size() == 3);
+    }
+    SUBCASE("hinted_lookup") {
+        using map_t = flat_multimap<int, unsigned>;
+
+        map_t s0{{1,2},{3,4},{3,5},{7,8}};
+        for ( int key = 0; key < 9; ++key ) {
+            for ( auto hint = s0.cbegin(); hint <= s0.cend(); ++hint ) {
+                REQUIRE(s0.lower_bound(hint, key) == s0.lower_bound(key));
+                REQUIRE(my_as_const(s0).find(hint, key) == s0.find(key));
+            }
+        }
+
+        REQUIRE(s0.index_of(s0.insert(s0.begin(), {3, 6})) == 3);
+        REQUIRE(s0.index_of(s0.insert(s0.end(), {0, 1})) == 0);
+
+        flat_multimap<std::string, int, std::less<>> s1{{"a", 1}, {"b", 2}};
+        REQUIRE(s1.find(s1.end(), std::string_view("a"))->second == 1);
+        REQUIRE(my_as_const(s1).lower_bound(s1.begin(), std::string_view("c")) == s1.end());
+    }
+    SUBCASE("append") {
+        struct counting_less {
+            int* count = nullptr;
+            bool operator()(int l, int r) const {
+                ++*count;
+                return l < r;
+            }
+        };
+
+        int comparisons = 0;
+        flat_multimap<int, unsigned, counting_less> s0(counting_less{&comparisons});
+        for ( int i = 0; i < 100; ++i ) {
+            s0.emplace(i / 2, 1u);
+        }
+        REQUIRE(comparisons == 99);
+
+        flat_multimap<int, unsigned> s1;
+        s1.append({1, 2});
+        s1.emplace_back_unchecked(1, 3u);
+        REQUIRE(s1 == flat_multimap<int, unsigned>{{1, 2}, {1, 3}});
+    }
+    SUBCASE("emplace_in_place") {
+        op_counts counts;
+        flat_multimap<int, counted> s0;
+        s0.reserve(8);
+
+        s0.emplace(1, counted(counts, 10));
+        s0.emplace_hint(s0.end(), 1, counted(counts, 11));
+        s0.emplace_hint(s0.begin(), 2, counted(counts, 20));
+        REQUIRE(counts.constructs == 3);
+        REQUIRE(counts.moves == 3);
+        REQUIRE(s0.size() == 3);
+        REQUIRE((s0.begin() + 1)->second.value() == 11);
+        REQUIRE((s0.begin() + 2)->first == 2);
+    }
+    SUBCASE("interpolation_search") {
+        flat_multimap<int, unsigned, interpolation_less<int>> s0{{1, 1u}, {3, 2u}, {3, 3u}, {8, 4u}};
+        REQUIRE(s0.count(3) == 2);
+        REQUIRE(s0.lower_bound(3) - s0.begin() == 1);
+        REQUIRE(s0.upper_bound(3) - s0.begin() == 3);
+        REQUIRE(s0.find(8)->second == 4u);
+        REQUIRE(s0.find(7) == s0.end());
+    }
 }
@@ -52,6 +52,47 @@ namespace
     constexpr std::add_const_t<T>& my_as_const(T& t) noexcept {
         return t;
     }
+
+    struct op_counts {
+        int constructs = 0;
+        int copies = 0;
+        int moves = 0;
+    };
+
+    class counted {
+    public:
+        counted(op_counts& counts, int value)
+        : counts_(&counts)
+        , value_(value) {
+            ++counts_->constructs;
+        }
+
+        counted(const counted& other)
+        : counts_(other.counts_)
+        , value_(other.value_) {
+            ++counts_->copies;
+        }
+
+        counted(counted&& other) noexcept
+        : counts_(other.counts_)
+        , value_(other.value_) {
+            ++counts_->moves;
+        }
+
+        counted& operator=(const counted& other) = default;
+        counted& operator=(counted&& other) noexcept = default;
+
+        int value() const noexcept {
+            return value_;
+        }
+
+        friend bool operator<(const counted& l, const counted& r) noexcept {
+            return l.value_ < r.value_;
+        }
+    private:
+        op_counts* counts_ = nullptr;
+        int value_ = 0;
+    };
 }
 
 TEST_CASE("flat_multiset") {
@@ -565,4 +606,136 @@ TEST_CASE("flat_multiset") {
         REQUIRE(s0 <= s0);
         REQUIRE(s0 >= s0);
     }
+#ifdef FLAT_HPP_HAS_MEMORY_RESOURCE
+    SUBCASE("pmr") {
+        using set_t = flat_hpp::pmr::flat_multiset<int>;
+        using alloc_t = set_t::container_type::allocator_type;
+        STATIC_REQUIRE(std::is_same_v<alloc_t, std::pmr::polymorphic_allocator<set_t::value_type>>);
+
+        std::pmr::monotonic_buffer_resource arena;
+        // catches element storage outside the arena, the temporary buffers
+        // of std::stable_sort and std::inplace_merge use operator new instead
+        std::pmr::memory_resource* default_resource =
+            std::pmr::set_default_resource(std::pmr::null_memory_resource());
+
+        set_t s0{alloc_t(&arena)};
+        s0 = {3,2,1,2};
+        s0.insert(4);
+        set_t s1({1,2,2,3}, alloc_t(&arena));
+        s1.insert(4);
+
+        std::pmr::set_default_resource(default_resource);
+        REQUIRE(s0.get_allocator().resource() == &arena);
+        REQUIRE(s0 == set_t{1,2,2,3,4});
+        REQUIRE(s1 == set_t{1,2,2,3,4});
+    }
+#endif
+    SUBCASE("extract") {
+        using set_t = flat_multiset<int>;
+
+        set_t s0{3,1,1,2};
+        set_t::container_type c0 = std::move(s0).extract();
+        REQUIRE(s0.empty());
+        REQUIRE(c0 == set_t::container_type{1,1,2,3});
+
+        const set_t::container_type c1{4,4,5};
+        s0.replace(set_t::container_type(c1));
+        REQUIRE(s0 == set_t(sorted_range, c1.begin(), c1.end()));
+        REQUIRE(std::move(s0).extract() == c1);
+    }
+    SUBCASE("order_statistics") {
+        using set_t = flat_multiset<int>;
+
+        set_t s0{1, 3, 3, 3, 9};
+        REQUIRE(*s0.nth(1) == 3);
+        REQUIRE(*my_as_const(s0).nth(4) == 9);
+        REQUIRE(s0.index_of(s0.find(9)) == 4);
+
+        REQUIRE(s0.rank(3) == 1);
+        REQUIRE(s0.rank(4) == 4);
+        REQUIRE(s0.count_range(3, 4) == 3);
+        REQUIRE(s0.count_range(0, 9) == 4);
+
+        flat_multiset<std::string, std::less<>> s1{"a", "b", "b", "c"};
+        REQUIRE(s1.rank(std::string_view("c")) == 3);
+        REQUIRE(s1.count_range(std::string_view("b"), std::string_view("c")) == 2);
+    }
+    SUBCASE("ranges") {
+        using set_t = flat_multiset<int>;
+
+        set_t s0{1, 3, 3, 5, 9};
+        REQUIRE(s0.range(3, 5).size() == 2);
+        REQUIRE(my_as_const(s0).range(3, 6).back() == 5);
+        REQUIRE(s0.range_from(4).size() == 2);
+
+        flat_multiset<std::string, std::less<>> s1{"a", "b", "b"};
+        REQUIRE(s1.range(std::string_view("b"), std::string_view("c")).size() == 2);
+        REQUIRE(my_as_const(s1).range_from(std::string_view("a")).size() == 3);
+    }
+    SUBCASE("hinted_lookup") {
+        using set_t = flat_multiset<int>;
+
+        set_t s0{1, 3, 3, 3, 9};
+        for ( int key = 0; key < 11; ++key ) {
+            for ( auto hint = s0.cbegin(); hint <= s0.cend(); ++hint ) {
+                REQUIRE(s0.lower_bound(hint, key) == s0.lower_bound(key));
+                REQUIRE(my_as_const(s0).find(hint, key) == s0.find(key));
+            }
+        }
+
+        REQUIRE(s0.index_of(s0.insert(s0.end(), 2)) == 1);
+        REQUIRE(s0.index_of(s0.insert(s0.begin(), 10)) == 6);
+        REQUIRE(s0 == set_t{1, 2, 3, 3, 3, 9, 10});
+
+        flat_multiset<std::string, std::less<>> s1{"a", "b", "b"};
+        REQUIRE(s1.find(s1.end(), std::string_view("b")) == s1.begin() + 1);
+        REQUIRE(my_as_const(s1).lower_bound(s1.begin(), std::string_view("bb")) == s1.end());
+    }
+    SUBCASE("append") {
+        struct counting_less {
+            int* count = nullptr;
+            bool operator()(int l, int r) const {
+                ++*count;
+                return l < r;
+            }
+        };
+
+        int comparisons = 0;
+        flat_multiset<int, counting_less> s0(counting_less{&comparisons});
+        for ( int i = 0; i < 100; ++i ) {
+            s0.insert(i / 2);
+        }
+        REQUIRE(comparisons == 99);
+        REQUIRE(s0.size() == 100);
+
+        flat_multiset<int> s1;
+        s1.append(1);
+        s1.append(1);
+        s1.emplace_back_unchecked(2);
+        REQUIRE(s1 == flat_multiset<int>{1, 1, 2});
+    }
+    SUBCASE("emplace_in_place") {
+        op_counts counts;
+        flat_multiset<counted> s0;
+        s0.reserve(8);
+
+        const counted c0(counts, 5);
+        s0.emplace(c0);
+        s0.emplace_hint(s0.end(), c0);
+        REQUIRE(counts.copies == 2);
+        REQUIRE(counts.moves == 0);
+
+        s0.emplace(counted(counts, 7));
+        REQUIRE(counts.moves == 1);
+        REQUIRE(s0.size() == 3);
+    }
+    SUBCASE("interpolation_search") {
+        flat_multiset<int, interpolation_less<int>> s0{1, 2, 2, 2, 5, 5, 9, 9, 9, 9, 100};
+        REQUIRE(s0.lower_bound(2) - s0.begin() == 1);
+        REQUIRE(s0.upper_bound(2) - s0.begin() == 4);
+        REQUIRE(s0.count(9) == 4);
+        REQUIRE(s0.count(7) == 0);
+        REQUIRE(s0.lower_bound(50) - s0.begin() == 10);
+        REQUIRE(s0.upper_bound(100) == s0.end());
+    }
 }
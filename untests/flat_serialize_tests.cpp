@@ -0,0 +1,198 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <flat.hpp/flat_map.hpp>
+#include <flat.hpp/flat_multimap.hpp>
+#include <flat.hpp/flat_multiset.hpp>
+#include <flat.hpp/flat_serialize.hpp>
+#include <flat.hpp/flat_set.hpp>
+#include "flat_tests.hpp"
+
+#include <deque>
+#include <sstream>
+#include <string>
+
+namespace
+{
+    using namespace flat_hpp;
+
+    template < typename Flat >
+    Flat round_trip(const Flat& flat, bool verify) {
+        std::stringstream ss;
+        save(ss, flat);
+        Flat result;
+        load(ss, result, verify);
+        return result;
+    }
+
+    struct less_t : std::less<int> {};
+    struct greater_t : std::greater<int> {};
+    struct other_less_t : std::less<int> {};
+}
+
+namespace flat_hpp
+{
+    // greater_t shares the tag of less_t on purpose, only verify can catch it
+    template <>
+    struct image_compare_tag<less_t>
+    : std::integral_constant<std::uint64_t, 0x100> {};
+
+    template <>
+    struct image_compare_tag<greater_t>
+    : std::integral_constant<std::uint64_t, 0x100> {};
+
+    template <>
+    struct image_compare_tag<other_less_t>
+    : std::integral_constant<std::uint64_t, 0x101> {};
+}
+
+TEST_CASE("flat_serialize") {
+    SUBCASE("bitwise") {
+        flat_set<int> s0{5,1,3};
+        flat_multiset<int> s1{5,1,3,3};
+        flat_map<int, unsigned> s2{{5,1},{1,2},{3,3}};
+        flat_multimap<int, unsigned> s3{{5,1},{1,2},{3,3},{5,4}};
+
+        REQUIRE(round_trip(s0, false) == s0);
+        REQUIRE(round_trip(s1, false) == s1);
+        REQUIRE(round_trip(s2, false) == s2);
+        REQUIRE(round_trip(s3, false) == s3);
+
+        REQUIRE(round_trip(s0, true) == s0);
+        REQUIRE(round_trip(s1, true) == s1);
+        REQUIRE(round_trip(s2, true) == s2);
+        REQUIRE(round_trip(s3, true) == s3);
+
+        REQUIRE(round_trip(flat_set<int>(), true).empty());
+    }
+    SUBCASE("bitwise_image") {
+        flat_map<int, unsigned> s0{{5,1},{1,2},{3,3}};
+
+        std::stringstream s0_save;
+        save(s0_save, s0);
+
+        std::stringstream s0_image;
+        write_image(s0_image, s0);
+
+        REQUIRE(s0_save.str() == s0_image.str());
+    }
+    SUBCASE("streamed") {
+        flat_set<std::string> s0{"world", "hello", ""};
+        flat_multiset<std::string> s1{"world", "hello", "hello"};
+        flat_map<std::string, std::string> s2{{"b", "2"}, {"a", std::string(10000, 'x')}};
+        flat_multimap<int, std::string> s3{{2, "b"}, {1, "a"}, {3, "c"}};
+
+        REQUIRE(round_trip(s0, true) == s0);
+        REQUIRE(round_trip(s1, true) == s1);
+        REQUIRE(round_trip(s2, true) == s2);
+        REQUIRE(round_trip(s3, false) == s3);
+
+        // streamed elements do not depend on the size of value_type
+        std::stringstream ss;
+        save(ss, s0);
+        std::string bytes = ss.str();
+        const std::uint64_t element_size = 1;
+        bytes.replace(offsetof(image_header, element_size), sizeof(element_size),
+            reinterpret_cast<const char*>(&element_size), sizeof(element_size));
+        std::stringstream foreign(bytes);
+        flat_set<std::string> s4;
+        load(foreign, s4, true);
+        REQUIRE(s4 == s0);
+    }
+    SUBCASE("non_contiguous") {
+        using set_t = flat_set<int, std::less<int>, std::deque<int>>;
+        set_t s0{5,1,3};
+        REQUIRE(round_trip(s0, true) == s0);
+    }
+    SUBCASE("padded") {
+        using map_t = flat_map<std::uint8_t, std::uint32_t>;
+        const map_t m0{{3,30},{1,10},{2,20}};
+        REQUIRE(round_trip(m0, true) == m0);
+
+        std::stringstream ss;
+        save(ss, m0);
+        image_header header{};
+        ss.read(reinterpret_cast<char*>(&header), sizeof(header));
+        REQUIRE((header.flags & image_flag_streamed) != 0);
+    }
+    SUBCASE("custom_compare") {
+        const flat_set<int, less_t> s0{3,1,2};
+        REQUIRE(round_trip(s0, true) == s0);
+        REQUIRE(round_trip(flat_map<int, std::string, less_t>{{2,"b"},{1,"a"}}, true)
+            == flat_map<int, std::string, less_t>{{1,"a"},{2,"b"}});
+    }
+    SUBCASE("multi_to_unique") {
+        flat_multimap<int, unsigned> s0{{1,2},{3,3},{4,4}};
+        s0.insert({3,4});
+
+        std::stringstream ss;
+        save(ss, s0);
+
+        flat_map<int, unsigned> s1{{7,7}};
+        load(ss, s1, true);
+        REQUIRE(s1 == flat_map<int, unsigned>{{1,2},{3,3},{4,4}});
+    }
+    SUBCASE("errors") {
+        flat_set<std::string> s0{"hello", "world"};
+
+        std::stringstream ss;
+        save(ss, s0);
+        const std::string bytes = ss.str();
+
+        {
+            std::stringstream truncated(bytes.substr(0, bytes.size() - 12));
+            flat_set<std::string> s1{"keep"};
+            REQUIRE_THROWS_AS(load(truncated, s1), std::runtime_error);
+            REQUIRE(s1 == flat_set<std::string>{"keep"});
+        }
+        {
+            std::string flipped = bytes;
+            flipped[sizeof(image_header) + 8] = 'j';
+            std::stringstream corrupted(flipped);
+            flat_set<std::string> s1{"keep"};
+            REQUIRE_THROWS_AS(load(corrupted, s1, true), std::runtime_error);
+            REQUIRE(s1 == flat_set<std::string>{"keep"});
+        }
+        {
+            std::stringstream other(bytes);
+            flat_set<std::string, std::greater<std::string>> s1;
+            REQUIRE_THROWS_AS(load(other, s1), std::runtime_error);
+        }
+        {
+            std::string swapped = bytes;
+            std::reverse(
+                swapped.begin() + offsetof(image_header, byte_order),
+                swapped.begin() + offsetof(image_header, byte_order) + sizeof(std::uint64_t));
+            std::stringstream foreign(swapped);
+            flat_set<std::string> s1;
+            REQUIRE_THROWS_AS(load(foreign, s1), std::runtime_error);
+        }
+        {
+            std::stringstream other;
+            save(other, flat_set<std::int32_t>{1,2,3});
+            flat_set<float> s1{4.f};
+            REQUIRE_THROWS_AS(load(other, s1), std::runtime_error);
+            REQUIRE(s1 == flat_set<float>{4.f});
+        }
+        {
+            std::stringstream garbage(std::string(100, 'x'));
+            flat_set<std::string> s1;
+            REQUIRE_THROWS_AS(load(garbage, s1), std::runtime_error);
+        }
+        {
+            std::stringstream other;
+            save(other, flat_set<int, greater_t>{1,2,3});
+            flat_set<int, less_t> s1;
+            REQUIRE_THROWS_AS(load(other, s1, true), std::runtime_error);
+        }
+        {
+            std::stringstream other;
+            save(other, flat_set<int, less_t>{1,2,3});
+            flat_set<int, other_less_t> s1;
+            REQUIRE_THROWS_AS(load(other, s1), std::runtime_error);
+        }
+    }
+}
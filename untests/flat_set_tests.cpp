@@ -26,6 +26,15 @@ namespace
         int i = 0;
     };
 
+    struct throwing_less {
+        bool operator()(int l, int r) const {
+            if ( l < 0 || r < 0 ) {
+                throw std::runtime_error("throwing_less");
+            }
+            return l < r;
+        }
+    };
+
     template < typename T >
     class dummy_less2 {
         dummy_less2() = default;
@@ -52,6 +61,47 @@ namespace
     constexpr std::add_const_t<T>& my_as_const(T& t) noexcept {
         return t;
     }
+
+    struct op_counts {
+        int constructs = 0;
+        int copies = 0;
+        int moves = 0;
+    };
+
+    class counted {
+    public:
+        counted(op_counts& counts, int value)
+        : counts_(&counts)
+        , value_(value) {
+            ++counts_->constructs;
+        }
+
+        counted(const counted& other)
+        : counts_(other.counts_)
+        , value_(other.value_) {
+            ++counts_->copies;
+        }
+
+        counted(counted&& other) noexcept
+        : counts_(other.counts_)
+        , value_(other.value_) {
+            ++counts_->moves;
+        }
+
+        counted& operator=(const counted& other) = default;
+        counted& operator=(counted&& other) noexcept = default;
+
+        int value() const noexcept {
+            return value_;
+        }
+
+        friend bool operator<(const counted& l, const counted& r) noexcept {
+            return l.value_ < r.value_;
+        }
+    private:
+        op_counts* counts_ = nullptr;
+        int value_ = 0;
+    };
 }
 
 TEST_CASE("flat_set") {
@@ -563,4 +613,243 @@ TEST_CASE("flat_set") {
         REQUIRE(s0 <= s0);
         REQUIRE(s0 >= s0);
     }
+#ifdef FLAT_HPP_HAS_MEMORY_RESOURCE
+    SUBCASE("pmr") {
+        using set_t = flat_hpp::pmr::flat_set<int>;
+        using alloc_t = set_t::container_type::allocator_type;
+        STATIC_REQUIRE(std::is_same_v<alloc_t, std::pmr::polymorphic_allocator<set_t::value_type>>);
+
+        std::pmr::monotonic_buffer_resource arena;
+        // catches element storage outside the arena, the temporary buffers
+        // of std::stable_sort and std::inplace_merge use operator new instead
+        std::pmr::memory_resource* default_resource =
+            std::pmr::set_default_resource(std::pmr::null_memory_resource());
+
+        set_t s0{alloc_t(&arena)};
+        s0 = {3,1,2};
+        s0.insert(4);
+        set_t s1({1,2,3}, alloc_t(&arena));
+        s1.insert(4);
+
+        std::pmr::set_default_resource(default_resource);
+        REQUIRE(s0.get_allocator().resource() == &arena);
+        REQUIRE(s0 == set_t{1,2,3,4});
+        REQUIRE(s1 == set_t{1,2,3,4});
+    }
+#endif
+    SUBCASE("extract") {
+        using set_t = flat_set<int>;
+
+        set_t s0{3,1,2};
+        set_t::container_type c0 = std::move(s0).extract();
+        REQUIRE(s0.empty());
+        REQUIRE(c0 == set_t::container_type{1,2,3});
+
+        const set_t::container_type c1{4,5};
+        s0.replace(set_t::container_type(c1));
+        REQUIRE(s0 == set_t(sorted_range, c1.begin(), c1.end()));
+        REQUIRE(std::move(s0).extract() == c1);
+    }
+    SUBCASE("assign_ilist_throws") {
+        using set_t = flat_set<int, throwing_less>;
+
+        set_t s0{3,1,2};
+        REQUIRE_THROWS_AS((s0 = {5,-1,4}), std::runtime_error);
+        REQUIRE(std::move(s0).extract() == set_t::container_type{1,2,3});
+    }
+    SUBCASE("order_statistics") {
+        using set_t = flat_set<int>;
+
+        set_t s0{1, 3, 5, 7, 9};
+        REQUIRE(*s0.nth(0) == 1);
+        REQUIRE(*my_as_const(s0).nth(3) == 7);
+        REQUIRE(s0.nth(5) == s0.end());
+
+        REQUIRE(s0.index_of(s0.begin()) == 0);
+        REQUIRE(s0.index_of(s0.find(7)) == 3);
+        REQUIRE(s0.index_of(s0.cend()) == 5);
+
+        REQUIRE(s0.rank(0) == 0);
+        REQUIRE(s0.rank(1) == 0);
+        REQUIRE(s0.rank(4) == 2);
+        REQUIRE(s0.rank(10) == 5);
+
+        REQUIRE(s0.count_range(3, 7) == 2);
+        REQUIRE(s0.count_range(0, 10) == 5);
+        REQUIRE(s0.count_range(7, 3) == 0);
+        REQUIRE(s0.count_range(4, 4) == 0);
+
+        flat_set<std::string, std::less<>> s1{"a", "b", "c"};
+        REQUIRE(s1.rank(std::string_view("b")) == 1);
+        REQUIRE(s1.count_range(std::string_view("a"), std::string_view("c")) == 2);
+    }
+    SUBCASE("ranges") {
+        using set_t = flat_set<int>;
+
+        set_t s0{1, 3, 5, 7, 9};
+        auto r0 = s0.range(3, 8);
+        REQUIRE(r0.size() == 3);
+        REQUIRE(r0.begin() == s0.begin() + 1);
+        REQUIRE(r0.front() == 3);
+        REQUIRE(r0.back() == 7);
+        REQUIRE(r0[1] == 5);
+
+        REQUIRE(my_as_const(s0).range(8, 3).empty());
+        REQUIRE(my_as_const(s0).range(10, 20).begin() == s0.cend());
+        REQUIRE(std::equal(s0.range_from(5).begin(), s0.range_from(5).end(), s0.begin() + 2, s0.end()));
+        REQUIRE(my_as_const(s0).range_from(0).size() == 5);
+
+        flat_set<std::string, std::less<>> s1{"a", "b", "c"};
+        REQUIRE(s1.range(std::string_view("b"), std::string_view("z")).size() == 2);
+        REQUIRE(my_as_const(s1).range_from(std::string_view("c")).front() == "c");
+    }
+    SUBCASE("hinted_lookup") {
+        using set_t = flat_set<int>;
+
+        set_t s0{1, 3, 5, 7, 9, 11, 13};
+        for ( int key = 0; key < 15; ++key ) {
+            for ( auto hint = s0.cbegin(); hint <= s0.cend(); ++hint ) {
+                REQUIRE(s0.lower_bound(hint, key) == s0.lower_bound(key));
+                REQUIRE(my_as_const(s0).lower_bound(hint, key) == s0.lower_bound(key));
+                REQUIRE(s0.find(hint, key) == s0.find(key));
+                REQUIRE(my_as_const(s0).find(hint, key) == s0.find(key));
+            }
+        }
+
+        REQUIRE(*s0.insert(s0.begin(), 8) == 8);
+        REQUIRE(*s0.insert(s0.end(), 8) == 8);
+        REQUIRE(*s0.insert(s0.end(), 0) == 0);
+        REQUIRE(s0 == set_t{0, 1, 3, 5, 7, 8, 9, 11, 13});
+
+        flat_set<std::string, std::less<>> s1{"a", "b", "c"};
+        REQUIRE(s1.find(s1.end(), std::string_view("b")) == s1.begin() + 1);
+        REQUIRE(my_as_const(s1).lower_bound(s1.begin(), std::string_view("bb")) == s1.begin() + 2);
+    }
+    SUBCASE("append") {
+        struct counting_less {
+            int* count = nullptr;
+            bool operator()(int l, int r) const {
+                ++*count;
+                return l < r;
+            }
+        };
+
+        int comparisons = 0;
+        flat_set<int, counting_less> s0(counting_less{&comparisons});
+        for ( int i = 0; i < 100; ++i ) {
+            REQUIRE(s0.insert(i).second);
+        }
+        REQUIRE(comparisons == 99);
+        REQUIRE(s0.emplace(50).second == false);
+        REQUIRE(s0.size() == 100);
+
+        flat_set<int> s1;
+        REQUIRE(*s1.append(1) == 1);
+        REQUIRE(*s1.append(3) == 3);
+        const int five = 5;
+        REQUIRE(*s1.append(five) == 5);
+        REQUIRE(*s1.emplace_back_unchecked(7) == 7);
+        REQUIRE(s1 == flat_set<int>{1, 3, 5, 7});
+    }
+    SUBCASE("emplace_in_place") {
+        op_counts counts;
+        flat_set<counted> s0;
+        s0.reserve(8);
+
+        const counted c0(counts, 5);
+        REQUIRE(s0.emplace(c0).second);
+        REQUIRE(counts.copies == 1);
+        REQUIRE(counts.moves == 0);
+
+        REQUIRE(s0.emplace_hint(s0.end(), counted(counts, 7))->value() == 7);
+        REQUIRE(counts.moves == 1);
+
+        REQUIRE_FALSE(s0.emplace(c0).second);
+        REQUIRE(counts.copies == 1);
+
+        REQUIRE(s0.emplace(counts, 9).second);
+        REQUIRE(counts.constructs == 3);
+        REQUIRE(s0.size() == 3);
+    }
+    SUBCASE("duplicate_policy") {
+        struct first_less {
+            bool operator()(const std::pair<int, int>& l, const std::pair<int, int>& r) const {
+                return l.first < r.first;
+            }
+        };
+        using set_t = flat_set<std::pair<int, int>, first_less>;
+        const std::vector<std::pair<int, int>> v{{2, 1}, {1, 2}, {2, 3}, {1, 4}};
+        {
+            const set_t s0(keep_first, v.begin(), v.end());
+            REQUIRE(s0.begin()->second == 2);
+            REQUIRE((s0.begin() + 1)->second == 1);
+
+            const set_t s1(keep_last, v.begin(), v.end());
+            REQUIRE(s1.begin()->second == 4);
+            REQUIRE((s1.begin() + 1)->second == 3);
+
+            const set_t s2(keep_last, {{2, 1}, {2, 2}}, first_less());
+            REQUIRE(s2.begin()->second == 2);
+
+            const set_t s3(keep_first, v.begin(), v.end(), std::allocator<std::pair<int, int>>());
+            REQUIRE(s3 == s0);
+
+            const set_t s4(keep_last, {{1, 1}, {1, 2}}, first_less(), std::allocator<std::pair<int, int>>());
+            REQUIRE(s4.begin()->second == 2);
+        }
+        {
+            set_t s0{{1, 0}, {3, 0}};
+            s0.insert(keep_last, v.begin(), v.end());
+            REQUIRE(s0.size() == 3);
+            REQUIRE(s0.begin()->second == 4);
+
+            set_t s1{{1, 0}, {3, 0}};
+            s1.insert(keep_first, {{1, 9}, {0, 9}});
+            REQUIRE(s1.size() == 3);
+            REQUIRE((s1.begin() + 1)->second == 0);
+        }
+    }
+    SUBCASE("interpolation_search") {
+        struct counting_less : interpolation_less<int> {
+            int* count = nullptr;
+            bool operator()(int l, int r) const {
+                ++*count;
+                return l < r;
+            }
+        };
+
+        int count = 0;
+        counting_less comp;
+        comp.count = &count;
+
+        flat_set<int, counting_less> s0(comp);
+        for ( int i = 0; i < 100000; ++i ) {
+            s0.emplace_back_unchecked(i * 3);
+        }
+
+        for ( int key = -5; key < 300005; key += 7 ) {
+            count = 0;
+            const auto iter = s0.lower_bound(key);
+            REQUIRE(count <= 5);
+            REQUIRE(iter - s0.begin() == (key <= 0 ? 0 : std::min((key + 2) / 3, 100000)));
+            REQUIRE(s0.upper_bound(key) - s0.begin() == (key < 0 ? 0 : std::min(key / 3 + 1, 100000)));
+            REQUIRE(s0.contains(key) == (key >= 0 && key % 3 == 0 && key < 300000));
+        }
+
+        flat_set<int, counting_less> s1(comp);
+        for ( int i = 0; i < 30; ++i ) {
+            s1.emplace_back_unchecked(1 << i);
+        }
+        for ( int i = 0; i < 30; ++i ) {
+            count = 0;
+            REQUIRE(s1.find(1 << i) - s1.begin() == i);
+            REQUIRE(count <= 2 + 8 + 5 + 1);
+            REQUIRE(s1.equal_range((1 << i) + 1).first - s1.begin() == i + 1);
+        }
+
+        flat_set<double, interpolation_less<>> s2{0.5, 1.5, 2.5, 100.0};
+        REQUIRE(s2.lower_bound(2.0) == s2.begin() + 2);
+        REQUIRE(s2.count(100.0) == 1);
+        REQUIRE(s2.upper_bound(1000.0) == s2.end());
+    }
 }
@@ -0,0 +1,121 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <flat.hpp/flat_set_view.hpp>
+#include "flat_tests.hpp"
+
+#include <string>
+#include <string_view>
+
+namespace
+{
+    using namespace flat_hpp;
+}
+
+TEST_CASE("flat_set_view") {
+    SUBCASE("types") {
+        using view_t = flat_set_view<int>;
+
+        STATIC_REQUIRE(std::is_same_v<view_t::key_type, int>);
+        STATIC_REQUIRE(std::is_same_v<view_t::value_type, int>);
+        STATIC_REQUIRE(std::is_same_v<view_t::iterator, const int*>);
+        STATIC_REQUIRE(std::is_same_v<view_t::const_iterator, const int*>);
+
+        STATIC_REQUIRE(std::is_nothrow_default_constructible_v<view_t>);
+        STATIC_REQUIRE(std::is_trivially_copyable_v<view_t>);
+        REQUIRE(sizeof(view_t) == sizeof(const int*) * 2);
+    }
+    SUBCASE("ctors") {
+        const int data[] = {1, 3, 5, 7};
+
+        flat_set_view<int> v0;
+        REQUIRE(v0.empty());
+        REQUIRE(v0.size() == 0);
+        REQUIRE(v0.begin() == v0.end());
+
+        flat_set_view<int> v1(sorted_unique_range, std::begin(data), std::end(data));
+        REQUIRE(v1.size() == 4);
+        REQUIRE(v1.data() == data);
+
+        flat_set_view<int> v2(sorted_unique_range, data, 4);
+        REQUIRE(v1 == v2);
+
+        flat_set_view<int> v3(sorted_unique_range, data, 3);
+        REQUIRE(v1 != v3);
+
+        const int rdata[] = {7, 5, 3, 1};
+        flat_set_view<int, std::greater<int>> v4(sorted_unique_range, rdata, 4, std::greater<int>());
+        REQUIRE(v4.find(3) == v4.begin() + 2);
+    }
+    SUBCASE("iterators") {
+        const int data[] = {1, 3, 5};
+        flat_set_view<int> v0(sorted_unique_range, data, 3);
+        REQUIRE(std::vector<int>(v0.begin(), v0.end()) == std::vector<int>{1, 3, 5});
+        REQUIRE(std::vector<int>(v0.rbegin(), v0.rend()) == std::vector<int>{5, 3, 1});
+        REQUIRE(v0.cbegin() == v0.begin());
+        REQUIRE(v0.cend() == v0.end());
+    }
+    SUBCASE("lookup") {
+        const int data[] = {1, 3, 5, 7};
+        flat_set_view<int> v0(sorted_unique_range, data, 4);
+
+        REQUIRE(v0.count(3) == 1);
+        REQUIRE(v0.count(4) == 0);
+        REQUIRE(v0.find(5) == v0.begin() + 2);
+        REQUIRE(v0.find(6) == v0.end());
+        REQUIRE(v0.contains(7));
+        REQUIRE_FALSE(v0.contains(0));
+        REQUIRE(v0.equal_range(3) == std::make_pair(v0.begin() + 1, v0.begin() + 2));
+        REQUIRE(v0.lower_bound(4) == v0.begin() + 2);
+        REQUIRE(v0.upper_bound(5) == v0.begin() + 3);
+    }
+    SUBCASE("order_statistics") {
+        const int data[] = {1, 3, 5, 7, 9};
+        flat_set_view<int> v0(sorted_unique_range, data, 5);
+
+        REQUIRE(*v0.nth(3) == 7);
+        REQUIRE(v0.nth(5) == v0.end());
+        REQUIRE(v0.index_of(v0.find(5)) == 2);
+        REQUIRE(v0.rank(6) == 3);
+        REQUIRE(v0.count_range(2, 8) == 3);
+        REQUIRE(v0.count_range(8, 2) == 0);
+
+        const auto r0 = v0.range(3, 9);
+        REQUIRE(std::vector<int>(r0.begin(), r0.end()) == std::vector<int>{3, 5, 7});
+        REQUIRE(v0.range(9, 3).empty());
+        REQUIRE(v0.range_from(6).size() == 2);
+    }
+    SUBCASE("interpolation") {
+        std::vector<int> data;
+        for ( int i = 0; i < 1000; i += 3 ) {
+            data.push_back(i);
+        }
+        flat_set_view<int, interpolation_less<int>> v0(sorted_unique_range, data.data(), data.size());
+        for ( int i = -1; i < 1001; ++i ) {
+            REQUIRE(v0.lower_bound(i) == std::lower_bound(v0.begin(), v0.end(), i));
+            REQUIRE(v0.upper_bound(i) == std::upper_bound(v0.begin(), v0.end(), i));
+            REQUIRE(v0.contains(i) == (i >= 0 && i % 3 == 0));
+        }
+    }
+    SUBCASE("heterogeneous") {
+        const std::string data[] = {"hello", "world"};
+        flat_set_view<std::string, std::less<>> v0(sorted_unique_range, data, 2);
+        REQUIRE(v0.find(std::string_view("world")) == v0.begin() + 1);
+        REQUIRE(v0.contains(std::string_view("hello")));
+        REQUIRE(v0.count(std::string_view("42")) == 0);
+        REQUIRE(v0.lower_bound(std::string_view("i")) == v0.begin() + 1);
+        REQUIRE(v0.upper_bound(std::string_view("world")) == v0.end());
+    }
+    SUBCASE("swap") {
+        const int data0[] = {1, 2};
+        const int data1[] = {3};
+        flat_set_view<int> v0(sorted_unique_range, data0, 2);
+        flat_set_view<int> v1(sorted_unique_range, data1, 1);
+        swap(v0, v1);
+        REQUIRE(v0.data() == data1);
+        REQUIRE(v1.data() == data0);
+    }
+}
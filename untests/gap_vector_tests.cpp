@@ -0,0 +1,192 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <flat.hpp/flat_map.hpp>
+#include <flat.hpp/flat_multiset.hpp>
+#include <flat.hpp/flat_set.hpp>
+#include <flat.hpp/gap_vector.hpp>
+#include "flat_tests.hpp"
+
+#include <random>
+#include <string>
+
+namespace
+{
+    using namespace flat_hpp;
+}
+
+TEST_CASE("gap_vector") {
+    SUBCASE("sequence") {
+        gap_vector<int> v;
+        REQUIRE(v.empty());
+        REQUIRE(v.begin() == v.end());
+
+        v.push_back(1);
+        v.push_back(4);
+        v.insert(v.begin() + 1, 2);
+        v.insert(v.begin() + 2, 3);
+        v.insert(v.begin(), 0);
+        REQUIRE(v == gap_vector<int>{0, 1, 2, 3, 4});
+        REQUIRE(v.size() == 5);
+        REQUIRE(v.front() == 0);
+        REQUIRE(v.back() == 4);
+        REQUIRE(v[3] == 3);
+        REQUIRE(v.end() - v.begin() == 5);
+        REQUIRE(*(v.rbegin() + 1) == 3);
+
+        REQUIRE(*v.erase(v.begin() + 1) == 2);
+        REQUIRE(v == gap_vector<int>{0, 2, 3, 4});
+        const auto iter = v.erase(v.begin() + 2, v.end());
+        REQUIRE(iter == v.end());
+        REQUIRE(v == gap_vector<int>{0, 2});
+
+        const int ints[] = {5, 6, 7};
+        REQUIRE(*v.insert(v.begin() + 1, std::begin(ints), std::end(ints)) == 5);
+        REQUIRE(v == gap_vector<int>{0, 5, 6, 7, 2});
+
+        v.pop_back();
+        REQUIRE(v == gap_vector<int>{0, 5, 6, 7});
+
+        v.clear();
+        REQUIRE(v.empty());
+        REQUIRE(v.capacity() > 0);
+        v.shrink_to_fit();
+        REQUIRE(v.capacity() == 0);
+    }
+    SUBCASE("gap") {
+        gap_vector<int> v;
+        v.reserve(32);
+        for ( int i = 0; i < 8; ++i ) {
+            v.push_back(i * 10);
+        }
+        REQUIRE(v.capacity() == 32);
+        REQUIRE(v.gap_position() == 8);
+
+        v.insert(v.begin() + 3, 25);
+        REQUIRE(v.gap_position() == 4);
+        v.insert(v.begin() + 4, 26);
+        REQUIRE(v.gap_position() == 5);
+        REQUIRE(v.capacity() == 32);
+
+        v.erase(v.begin() + 1);
+        REQUIRE(v.gap_position() == 1);
+        REQUIRE(v == gap_vector<int>{0, 20, 25, 26, 30, 40, 50, 60, 70});
+        REQUIRE(std::is_sorted(v.begin(), v.end()));
+    }
+    SUBCASE("ctors") {
+        using vec_t = gap_vector<std::string>;
+        vec_t v{"a", "b", "c"};
+        v.insert(v.begin() + 1, "ab");
+
+        vec_t v2 = v;
+        REQUIRE(v2 == v);
+        REQUIRE(v2.gap_position() == v2.size());
+
+        vec_t v3 = std::move(v2);
+        REQUIRE(v3 == v);
+        REQUIRE(v2.empty());
+
+        vec_t v4;
+        v4 = v3;
+        REQUIRE(v4 == v);
+        v4 = std::move(v3);
+        REQUIRE(v4 == v);
+
+        swap(v4, v2);
+        REQUIRE(v4.empty());
+        REQUIRE(v2 == vec_t{"a", "ab", "b", "c"});
+        REQUIRE(v4 < v2);
+    }
+    SUBCASE("clear") {
+        struct counted_t {
+            int* moves = nullptr;
+            explicit counted_t(int* m) : moves(m) {}
+            counted_t(const counted_t& other) = default;
+            counted_t(counted_t&& other) noexcept : moves(other.moves) { ++*moves; }
+            counted_t& operator=(const counted_t& other) = default;
+        };
+
+        int moves = 0;
+        gap_vector<counted_t> v;
+        v.reserve(16);
+        for ( int i = 0; i < 8; ++i ) {
+            v.push_back(counted_t(&moves));
+        }
+        v.insert(v.begin(), counted_t(&moves));
+        REQUIRE(v.gap_position() == 1);
+
+        moves = 0;
+        v.clear();
+        REQUIRE(v.empty());
+        REQUIRE(moves == 0);
+    }
+    SUBCASE("aliasing") {
+        gap_vector<std::string> v{"a", "b"};
+        v.shrink_to_fit();
+        v.insert(v.begin(), v.back());
+        v.insert(v.end(), v.front());
+        REQUIRE(v == gap_vector<std::string>{"b", "a", "b", "b"});
+    }
+    SUBCASE("flat_set") {
+        using set_t = flat_set<int, std::less<int>, gap_vector<int>>;
+
+        set_t s{5, 3, 1};
+        REQUIRE(s.insert(4).second);
+        REQUIRE_FALSE(s.insert(4).second);
+        s.insert({2, 6, 0});
+        REQUIRE(s.size() == 7u);
+        REQUIRE(s.erase(3) == 1u);
+        REQUIRE(s.contains(4));
+        REQUIRE_FALSE(s.contains(3));
+        REQUIRE(*s.lower_bound(3) == 4);
+        REQUIRE(std::is_sorted(s.begin(), s.end()));
+
+        std::vector<int> expected{0, 1, 2, 4, 5, 6};
+        REQUIRE(std::equal(s.begin(), s.end(), expected.begin(), expected.end()));
+    }
+    SUBCASE("flat_multiset") {
+        using set_t = flat_multiset<int, std::less<int>, gap_vector<int>>;
+
+        set_t s{3, 1, 3, 2};
+        s.insert(3);
+        REQUIRE(s.count(3) == 3u);
+        REQUIRE(s.erase(3) == 3u);
+        REQUIRE(s.size() == 2u);
+    }
+    SUBCASE("flat_map") {
+        using map_t = flat_map<int, std::string, std::less<int>, gap_vector<std::pair<int, std::string>>>;
+
+        map_t m;
+        m[2] = "two";
+        m[1] = "one";
+        m.emplace(3, "three");
+        m.try_emplace(0, "zero");
+        REQUIRE(m.size() == 4u);
+        REQUIRE(m.at(3) == "three");
+        REQUIRE(m.find(1)->second == "one");
+        REQUIRE(m.erase(2) == 1u);
+        REQUIRE_FALSE(m.contains(2));
+        REQUIRE(m.begin()->first == 0);
+    }
+    SUBCASE("clustered_inserts") {
+        using set_t = flat_set<int, std::less<int>, gap_vector<int>>;
+        std::mt19937 engine(42);
+
+        set_t s;
+        std::vector<int> expected;
+        for ( int cluster = 0; cluster < 8; ++cluster ) {
+            const int base = static_cast<int>(engine() % 1000u) * 1000;
+            for ( int i = 0; i < 100; ++i ) {
+                const int key = base + i;
+                s.insert(key);
+                expected.push_back(key);
+            }
+        }
+        std::sort(expected.begin(), expected.end());
+        expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+        REQUIRE(std::equal(s.begin(), s.end(), expected.begin(), expected.end()));
+    }
+}
@@ -0,0 +1,86 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <flat.hpp/flat_map.hpp>
+#include <flat.hpp/flat_set.hpp>
+#include <flat.hpp/learned_index.hpp>
+#include "flat_tests.hpp"
+
+#include <cstdint>
+#include <random>
+
+namespace
+{
+    using namespace flat_hpp;
+
+    template < typename Flat, typename Key >
+    void check_lookups(const Flat& flat, const learned_index<Flat>& index, const std::vector<Key>& keys) {
+        for ( const Key& key : keys ) {
+            REQUIRE(index.lower_bound(key) == flat.lower_bound(key));
+            REQUIRE(index.find(key) == flat.find(key));
+            REQUIRE(index.contains(key) == flat.contains(key));
+        }
+    }
+}
+
+TEST_CASE("learned_index") {
+    SUBCASE("uniform") {
+        std::mt19937_64 gen(3);
+        flat_set<std::uint64_t> s0;
+        for ( std::size_t i = 0; i < 20000; ++i ) {
+            s0.insert(gen());
+        }
+        s0.insert(0);
+        s0.insert(std::numeric_limits<std::uint64_t>::max());
+
+        learned_index<flat_set<std::uint64_t>> i0(s0, 16);
+        REQUIRE(i0.epsilon() == 16);
+        REQUIRE(i0.segment_count() > 0);
+        REQUIRE(i0.segment_count() < 200);
+        REQUIRE(i0.memory_usage() == i0.segment_count() * 24);
+
+        std::vector<std::uint64_t> keys(s0.begin(), s0.end());
+        for ( std::size_t i = 0; i < 20000; ++i ) {
+            keys.push_back(gen());
+        }
+        check_lookups(s0, i0, keys);
+    }
+    SUBCASE("skewed") {
+        flat_map<int, unsigned> m0;
+        for ( int i = -3000; i < 3000; ++i ) {
+            m0.emplace(i * i * (i < 0 ? -1 : 1) + (i % 7), static_cast<unsigned>(i + 3000));
+        }
+
+        for ( std::size_t epsilon : {0u, 1u, 4u, 64u} ) {
+            learned_index<flat_map<int, unsigned>> i0(m0, epsilon);
+            std::vector<int> keys;
+            for ( int key = -9'100'000; key < 9'100'000; key += 997 ) {
+                keys.push_back(key);
+            }
+            for ( const auto& pair : m0 ) {
+                keys.push_back(pair.first);
+                keys.push_back(pair.first + 1);
+            }
+            check_lookups(m0, i0, keys);
+        }
+
+        learned_index<flat_map<int, unsigned>> i1(m0, 0);
+        learned_index<flat_map<int, unsigned>> i2(m0, 64);
+        REQUIRE(i1.segment_count() > i2.segment_count());
+    }
+    SUBCASE("rebuild") {
+        flat_set<double> s0;
+        learned_index<flat_set<double>> i0(s0);
+        REQUIRE(i0.segment_count() == 0);
+        REQUIRE(i0.lower_bound(1.0) == s0.end());
+        REQUIRE_FALSE(i0.contains(1.0));
+
+        s0.insert({0.5, 1.5, 2.25, 100.0});
+        i0.rebuild();
+        REQUIRE(i0.segment_count() == 1);
+        check_lookups(s0, i0, std::vector<double>{-1.0, 0.5, 1.0, 2.25, 50.0, 100.0, 1000.0});
+    }
+}
@@ -0,0 +1,159 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <flat.hpp/flat_map.hpp>
+#include <flat.hpp/flat_set.hpp>
+#include <flat.hpp/merged_view.hpp>
+#include "flat_tests.hpp"
+
+#include <map>
+#include <optional>
+#include <random>
+#include <string>
+
+namespace
+{
+    using namespace flat_hpp;
+
+    struct is_erased {
+        bool operator()(const std::pair<int, std::optional<std::string>>& value) const noexcept {
+            return !value.second;
+        }
+    };
+
+    struct is_erased_int {
+        bool operator()(const std::pair<int, std::optional<int>>& value) const noexcept {
+            return !value.second;
+        }
+    };
+}
+
+TEST_CASE("merged_view") {
+    SUBCASE("sets") {
+        const flat_set<int> l0{1, 5, 9};
+        const flat_set<int> l1{2, 5, 7};
+        const flat_set<int> l2{};
+
+        const merged_view<flat_set<int>> view({&l0, &l1, &l2});
+        REQUIRE(view.level_count() == 3u);
+        REQUIRE(&view.level(1) == &l1);
+        REQUIRE_FALSE(view.empty());
+
+        const std::vector<int> merged(view.begin(), view.end());
+        REQUIRE(merged == std::vector<int>{1, 2, 5, 7, 9});
+
+        REQUIRE(view.contains(7));
+        REQUIRE_FALSE(view.contains(3));
+        REQUIRE(*view.lower_bound(3) == 5);
+        REQUIRE(*view.lower_bound(6) == 7);
+        REQUIRE(view.lower_bound(10) == view.end());
+
+        REQUIRE(merged_view<flat_set<int>>({}).empty());
+        REQUIRE(merged_view<flat_set<int>>({&l2}).empty());
+    }
+    SUBCASE("priority") {
+        using map_t = flat_map<int, std::string>;
+        const map_t newest{{2, "new"}, {4, "new"}};
+        const map_t oldest{{1, "old"}, {2, "old"}, {3, "old"}, {4, "old"}};
+
+        const merged_view<map_t> view({&newest, &oldest});
+        REQUIRE(view.find(2)->second == "new");
+        REQUIRE(view.find(3)->second == "old");
+        REQUIRE(view.find(5) == nullptr);
+
+        std::vector<std::string> values;
+        for ( const auto& value : view ) {
+            values.push_back(std::to_string(value.first) + value.second);
+        }
+        REQUIRE(values == std::vector<std::string>{"1old", "2new", "3old", "4new"});
+
+        const map_t compacted = view.compact();
+        REQUIRE(compacted == map_t{{1, "old"}, {2, "new"}, {3, "old"}, {4, "new"}});
+    }
+    SUBCASE("tombstones") {
+        using map_t = flat_map<int, std::optional<std::string>>;
+        using view_t = merged_view<map_t, is_erased>;
+
+        const map_t memtable{{1, std::nullopt}, {3, "c2"}, {6, std::nullopt}};
+        const map_t level0{{1, "a"}, {2, "b"}, {3, "c"}, {6, "f"}};
+        const map_t level1{{2, "b0"}, {4, std::nullopt}, {5, "e"}};
+
+        const view_t view({&memtable, &level0, &level1});
+        REQUIRE(view.find(1) == nullptr);
+        REQUIRE_FALSE(view.contains(6));
+        REQUIRE(view.find(2)->second == "b");
+        REQUIRE(view.find(3)->second == "c2");
+        REQUIRE_FALSE(view.contains(4));
+        REQUIRE(view.find(5)->second == "e");
+
+        std::vector<int> keys;
+        for ( auto iter = view.begin(); iter != view.end(); ++iter ) {
+            keys.push_back(iter->first);
+        }
+        REQUIRE(keys == std::vector<int>{2, 3, 5});
+        REQUIRE(view.lower_bound(1)->first == 2);
+        REQUIRE(view.lower_bound(6) == view.end());
+
+        const map_t compacted = view.compact();
+        REQUIRE(compacted.size() == 3u);
+        REQUIRE(compacted.at(2) == "b");
+    }
+    SUBCASE("lsm") {
+        using map_t = flat_map<int, std::optional<int>>;
+        using view_t = merged_view<map_t, is_erased_int>;
+        std::mt19937 engine(3);
+
+        std::vector<map_t> levels(4);
+        std::map<int, int> expected;
+        for ( std::size_t l = levels.size(); l-- > 0; ) {
+            for ( int i = 0; i < 200; ++i ) {
+                const int key = static_cast<int>(engine() % 300u);
+                if ( engine() % 5u == 0u ) {
+                    levels[l][key] = std::nullopt;
+                    expected.erase(key);
+                } else {
+                    levels[l][key] = i;
+                    expected[key] = i;
+                }
+            }
+        }
+
+        std::vector<const map_t*> pointers;
+        for ( const map_t& level : levels ) {
+            pointers.push_back(&level);
+        }
+        const view_t view(pointers);
+
+        std::vector<std::pair<int, int>> merged;
+        for ( const auto& value : view ) {
+            merged.emplace_back(value.first, *value.second);
+        }
+        REQUIRE(merged == std::vector<std::pair<int, int>>(expected.begin(), expected.end()));
+
+        for ( int key = 0; key < 300; ++key ) {
+            const auto* found = view.find(key);
+            REQUIRE((found ? expected.count(key) == 1 : expected.count(key) == 0));
+        }
+    }
+#ifdef FLAT_HPP_HAS_MEMORY_RESOURCE
+    SUBCASE("pmr_compact") {
+        using set_t = flat_hpp::pmr::flat_set<int>;
+        using alloc_t = set_t::container_type::allocator_type;
+
+        std::pmr::monotonic_buffer_resource arena;
+        const set_t l0({3, 1}, alloc_t(&arena));
+        const set_t l1({2, 3}, alloc_t(&arena));
+
+        std::pmr::memory_resource* default_resource =
+            std::pmr::set_default_resource(std::pmr::null_memory_resource());
+        const set_t compacted = merged_view<set_t>({&l0, &l1}).compact();
+        std::pmr::set_default_resource(default_resource);
+
+        REQUIRE(compacted == set_t{1, 2, 3});
+        REQUIRE(compacted.get_allocator().resource() == &arena);
+    }
+#endif
+}
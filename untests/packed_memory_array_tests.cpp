@@ -0,0 +1,282 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <flat.hpp/flat_map.hpp>
+#include <flat.hpp/flat_multiset.hpp>
+#include <flat.hpp/flat_set.hpp>
+#include <flat.hpp/packed_memory_array.hpp>
+#include "flat_tests.hpp"
+
+#include <map>
+#include <random>
+#include <string>
+
+namespace
+{
+    using namespace flat_hpp;
+
+    template < typename T >
+    using small_pma = packed_memory_array<T, std::allocator<T>, 8>;
+
+    // throws std::bad_alloc when the shared budget of allocations is spent
+    template < typename T >
+    struct limited_allocator {
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::true_type;
+
+        int* budget = nullptr;
+
+        explicit limited_allocator(int* b) noexcept : budget(b) {}
+
+        template < typename U >
+        limited_allocator(const limited_allocator<U>& other) noexcept : budget(other.budget) {}
+
+        T* allocate(std::size_t n) {
+            if ( *budget <= 0 ) {
+                throw std::bad_alloc();
+            }
+            --*budget;
+            return std::allocator<T>().allocate(n);
+        }
+
+        void deallocate(T* p, std::size_t n) noexcept {
+            std::allocator<T>().deallocate(p, n);
+        }
+
+        friend bool operator==(const limited_allocator& l, const limited_allocator& r) noexcept {
+            return l.budget == r.budget;
+        }
+
+        friend bool operator!=(const limited_allocator& l, const limited_allocator& r) noexcept {
+            return !(l == r);
+        }
+    };
+}
+
+TEST_CASE("packed_memory_array") {
+    SUBCASE("sequence") {
+        small_pma<int> v;
+        REQUIRE(v.empty());
+        REQUIRE(v.begin() == v.end());
+
+        v.push_back(1);
+        v.push_back(4);
+        v.insert(v.begin() + 1, 2);
+        v.insert(v.begin() + 2, 3);
+        v.insert(v.begin(), 0);
+        REQUIRE(v == small_pma<int>{0, 1, 2, 3, 4});
+        REQUIRE(v.size() == 5);
+        REQUIRE(v.front() == 0);
+        REQUIRE(v.back() == 4);
+        REQUIRE(v[3] == 3);
+        REQUIRE(v.end() - v.begin() == 5);
+        REQUIRE(*(v.rbegin() + 1) == 3);
+
+        REQUIRE(*v.erase(v.begin() + 1) == 2);
+        REQUIRE(v == small_pma<int>{0, 2, 3, 4});
+        const auto iter = v.erase(v.begin() + 2, v.end());
+        REQUIRE(iter == v.end());
+        REQUIRE(v == small_pma<int>{0, 2});
+
+        const int ints[] = {5, 6, 7};
+        REQUIRE(*v.insert(v.begin() + 1, std::begin(ints), std::end(ints)) == 5);
+        REQUIRE(v == small_pma<int>{0, 5, 6, 7, 2});
+
+        v.pop_back();
+        REQUIRE(v == small_pma<int>{0, 5, 6, 7});
+
+        v.clear();
+        REQUIRE(v.empty());
+        REQUIRE(v.capacity() > 0);
+        v.shrink_to_fit();
+        REQUIRE(v.capacity() == 0);
+    }
+    SUBCASE("rebalance") {
+        std::mt19937 engine(7);
+        small_pma<int> v;
+        std::vector<int> expected;
+        for ( int i = 0; i < 2000; ++i ) {
+            const std::size_t index = expected.empty() ? 0u : engine() % (expected.size() + 1);
+            if ( engine() % 3u == 0u && !expected.empty() ) {
+                const std::size_t erased = index % expected.size();
+                v.erase(v.begin() + static_cast<std::ptrdiff_t>(erased));
+                expected.erase(expected.begin() + static_cast<std::ptrdiff_t>(erased));
+            } else {
+                v.insert(v.begin() + static_cast<std::ptrdiff_t>(index), i);
+                expected.insert(expected.begin() + static_cast<std::ptrdiff_t>(index), i);
+            }
+        }
+        REQUIRE(v.size() == expected.size());
+        REQUIRE(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+        REQUIRE(std::equal(v.rbegin(), v.rend(), expected.rbegin(), expected.rend()));
+        REQUIRE(v.capacity() >= v.size());
+        REQUIRE(v.capacity() <= std::max<std::size_t>(v.size() * 8, 64));
+
+        for ( std::size_t i = 0; i < expected.size(); i += 17 ) {
+            REQUIRE(v[i] == expected[i]);
+        }
+
+        while ( !expected.empty() ) {
+            v.erase(v.begin());
+            expected.erase(expected.begin());
+            REQUIRE(v.size() == expected.size());
+        }
+        REQUIRE(v.segment_count() == 1);
+    }
+    SUBCASE("erase_range") {
+        small_pma<int> v;
+        std::vector<int> expected;
+        for ( int i = 0; i < 500; ++i ) {
+            v.push_back(i);
+            expected.push_back(i);
+        }
+        const std::size_t segment_count = v.segment_count();
+
+        REQUIRE(*v.erase(v.begin() + 3, v.begin() + 5) == 5);
+        expected.erase(expected.begin() + 3, expected.begin() + 5);
+        REQUIRE(*v.erase(v.begin() + 100, v.begin() + 400) == 402);
+        expected.erase(expected.begin() + 100, expected.begin() + 400);
+        REQUIRE(v.erase(v.begin() + 7, v.begin() + 7) == v.begin() + 7);
+        REQUIRE(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+        REQUIRE(v.segment_count() < segment_count);
+
+        for ( std::size_t i = 0; i < expected.size(); i += 7 ) {
+            REQUIRE(v[i] == expected[i]);
+            REQUIRE(*(v.begin() + static_cast<std::ptrdiff_t>(i)) == expected[i]);
+        }
+
+        v.erase(v.begin(), v.end());
+        REQUIRE(v.empty());
+        REQUIRE(v.segment_count() == 1);
+    }
+    SUBCASE("iterators") {
+        small_pma<int> v;
+        for ( int i = 0; i < 100; ++i ) {
+            v.push_back(i);
+        }
+        auto iter = v.begin() + 50;
+        REQUIRE(*iter == 50);
+        v.insert(v.begin() + 60, -1);
+        REQUIRE(*iter == 50);
+        REQUIRE(*--iter == 49);
+        REQUIRE(*(iter + 11) == -1);
+        REQUIRE(*(iter + 12) == 60);
+
+        int expected = 0;
+        for ( auto i = v.cbegin(); i != v.cbegin() + 60; ++i, ++expected ) {
+            REQUIRE(*i == expected);
+        }
+    }
+    SUBCASE("ctors") {
+        using vec_t = small_pma<std::string>;
+        vec_t v{"a", "b", "c"};
+        v.insert(v.begin() + 1, "ab");
+
+        vec_t v2 = v;
+        REQUIRE(v2 == v);
+
+        vec_t v3 = std::move(v2);
+        REQUIRE(v3 == v);
+        REQUIRE(v2.empty());
+
+        vec_t v4;
+        v4 = v3;
+        REQUIRE(v4 == v);
+        v4 = std::move(v3);
+        REQUIRE(v4 == v);
+
+        swap(v4, v2);
+        REQUIRE(v4.empty());
+        REQUIRE(v2 == vec_t{"a", "ab", "b", "c"});
+        REQUIRE(v4 < v2);
+    }
+    SUBCASE("throwing_allocator") {
+        using vec_t = packed_memory_array<std::string, limited_allocator<std::string>, 8>;
+
+        int budget = 1000;
+        vec_t v{limited_allocator<std::string>(&budget)};
+        std::vector<std::string> expected;
+        for ( int i = 0; i < 40; ++i ) {
+            expected.push_back(std::to_string(i));
+            v.push_back(expected.back());
+        }
+        const std::size_t capacity = v.capacity();
+
+        budget = 0;
+        REQUIRE_THROWS_AS(v.reserve(capacity * 4), std::bad_alloc);
+        REQUIRE_THROWS_AS(v.insert(v.begin() + 3, expected.begin(), expected.end()), std::bad_alloc);
+        budget = 1;
+        REQUIRE_THROWS_AS(v.insert(v.begin() + 3, expected.begin(), expected.end()), std::bad_alloc);
+
+        REQUIRE(v.capacity() == capacity);
+        REQUIRE(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+
+        budget = 1000;
+        v.insert(v.begin(), expected.begin(), expected.end());
+        REQUIRE(v.size() == 80);
+        REQUIRE(v[40] == "0");
+
+        int other_budget = 1000;
+        vec_t v2{limited_allocator<std::string>(&other_budget)};
+        v2.push_back("x");
+        v2 = v;
+        REQUIRE(v2.get_allocator() == v.get_allocator());
+        REQUIRE(v2 == v);
+    }
+    SUBCASE("flat_set") {
+        using set_t = flat_set<int, std::less<int>, small_pma<int>>;
+
+        set_t s{5, 3, 1};
+        REQUIRE(s.insert(4).second);
+        REQUIRE_FALSE(s.insert(4).second);
+        s.insert({2, 6, 0});
+        REQUIRE(s.size() == 7u);
+        REQUIRE(s.erase(3) == 1u);
+        REQUIRE(s.contains(4));
+        REQUIRE_FALSE(s.contains(3));
+        REQUIRE(*s.lower_bound(3) == 4);
+
+        std::vector<int> expected{0, 1, 2, 4, 5, 6};
+        REQUIRE(std::equal(s.begin(), s.end(), expected.begin(), expected.end()));
+
+        std::vector<int> big;
+        for ( int i = 1000; i > 0; --i ) {
+            big.push_back(i * 3);
+        }
+        s.insert(big.begin(), big.end());
+        REQUIRE(s.size() == 1005u);
+        REQUIRE(std::is_sorted(s.begin(), s.end()));
+    }
+    SUBCASE("flat_multiset") {
+        using set_t = flat_multiset<int, std::less<int>, small_pma<int>>;
+
+        set_t s{3, 1, 3, 2};
+        s.insert(3);
+        REQUIRE(s.count(3) == 3u);
+        REQUIRE(s.erase(3) == 3u);
+        REQUIRE(s.size() == 2u);
+    }
+    SUBCASE("flat_map") {
+        using map_t = flat_map<int, std::string, std::less<int>, packed_memory_array<std::pair<int, std::string>>>;
+
+        std::mt19937 engine(42);
+        map_t m;
+        std::map<int, std::string> expected;
+        for ( int i = 0; i < 3000; ++i ) {
+            const int key = static_cast<int>(engine() % 2000u);
+            if ( engine() % 4u == 0u ) {
+                REQUIRE(m.erase(key) == expected.erase(key));
+            } else {
+                m[key] = std::to_string(i);
+                expected[key] = std::to_string(i);
+            }
+        }
+        REQUIRE(m.size() == expected.size());
+        REQUIRE(std::equal(m.begin(), m.end(), expected.begin(), expected.end(),
+            [](const auto& l, const auto& r){ return l.first == r.first && l.second == r.second; }));
+        REQUIRE(m.find(-1) == m.end());
+    }
+}
@@ -0,0 +1,130 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <flat.hpp/flat_map.hpp>
+#include <flat.hpp/persistent_flat_map.hpp>
+#include "flat_tests.hpp"
+
+#include <random>
+#include <string>
+#include <thread>
+
+namespace
+{
+    using namespace flat_hpp;
+}
+
+TEST_CASE("persistent_flat_map") {
+    SUBCASE("versions") {
+        using map_t = persistent_flat_map<int, std::string, std::less<int>, 4>;
+
+        const map_t v0;
+        REQUIRE(v0.empty());
+        REQUIRE(v0.begin() == v0.end());
+        REQUIRE(v0.find(1) == v0.end());
+
+        const map_t v1 = v0.with_inserted(2, "two").with_inserted(1, "one");
+        const map_t v2 = v1.with_inserted(1, "uno");
+        const map_t v3 = v2.with_erased(2);
+
+        REQUIRE(v0.empty());
+        REQUIRE(v1.size() == 2u);
+        REQUIRE(v1.at(1) == "one");
+        REQUIRE(v2.at(1) == "uno");
+        REQUIRE(v2.at(2) == "two");
+        REQUIRE(v3.size() == 1u);
+        REQUIRE_FALSE(v3.contains(2));
+        REQUIRE_THROWS_AS(v3.at(2), std::out_of_range);
+
+        REQUIRE(v3.with_erased(42) == v3);
+        REQUIRE(v3.with_erased(1).empty());
+        REQUIRE(v1 != v2);
+    }
+    SUBCASE("sharing") {
+        using map_t = persistent_flat_map<int, int, std::less<int>, 4>;
+
+        flat_map<int, int> base;
+        for ( int i = 0; i < 40; ++i ) {
+            base.emplace(i * 2, i);
+        }
+
+        const map_t v1(base.begin(), base.end());
+        REQUIRE(v1.size() == 40u);
+        REQUIRE(v1.chunk_count() == 10u);
+        REQUIRE(std::equal(v1.begin(), v1.end(), base.begin(), base.end()));
+
+        const map_t v2 = v1.with_inserted(11, -1);
+        REQUIRE(v2.size() == 41u);
+        REQUIRE(v2.chunk_count() == 11u);
+        REQUIRE(v2.shared_chunk_count(v1) == 9u);
+        REQUIRE(v1.size() == 40u);
+        REQUIRE_FALSE(v1.contains(11));
+
+        const map_t v3 = v2.with_inserted(40, -2);
+        REQUIRE(v3.shared_chunk_count(v2) == 10u);
+        REQUIRE(v3.at(40) == -2);
+        REQUIRE(v2.at(40) == 20);
+
+        const map_t v4 = v3.with_erased(0).with_erased(2).with_erased(4).with_erased(6);
+        REQUIRE(v4.chunk_count() == 10u);
+        REQUIRE(v4.begin()->first == 8);
+        REQUIRE(v4.shared_chunk_count(v3) == 10u);
+
+        const map_t copy = v4;
+        REQUIRE(copy.shared_chunk_count(v4) == v4.chunk_count());
+    }
+    SUBCASE("lookups") {
+        using map_t = persistent_flat_map<int, int, std::less<>, 4>;
+
+        map_t m;
+        for ( int i = 10; i > 0; --i ) {
+            m = m.with_inserted(i * 10, i);
+        }
+        REQUIRE(m.size() == 10u);
+        REQUIRE(std::is_sorted(m.begin(), m.end()));
+        REQUIRE(m.lower_bound(25)->first == 30);
+        REQUIRE(m.upper_bound(30)->first == 40);
+        REQUIRE(m.lower_bound(101) == m.end());
+        REQUIRE(m.equal_range(50).first->first == 50);
+        REQUIRE(std::distance(m.equal_range(50).first, m.equal_range(50).second) == 1);
+        REQUIRE(std::distance(m.equal_range(55).first, m.equal_range(55).second) == 0);
+        REQUIRE(m.count(70) == 1u);
+        REQUIRE(m.count(71) == 0u);
+        REQUIRE(m.find(70L)->second == 7);
+        REQUIRE(m.rbegin()->first == 100);
+        REQUIRE((--m.end())->first == 100);
+    }
+    SUBCASE("readers") {
+        using map_t = persistent_flat_map<int, int, std::less<int>, 8>;
+
+        map_t current;
+        for ( int i = 0; i < 256; ++i ) {
+            current = current.with_inserted(i, i);
+        }
+
+        const map_t snapshot = current;
+        std::vector<std::thread> readers;
+        std::vector<int> sums(4, 0);
+        for ( std::size_t r = 0; r < sums.size(); ++r ) {
+            readers.emplace_back([&snapshot, &sums, r](){
+                for ( const auto& [key, value] : snapshot ) {
+                    sums[r] += key == value ? 1 : 0;
+                }
+            });
+        }
+        for ( int i = 0; i < 256; ++i ) {
+            current = current.with_inserted(i, -i).with_erased(i / 2);
+        }
+        for ( std::thread& reader : readers ) {
+            reader.join();
+        }
+
+        for ( int sum : sums ) {
+            REQUIRE(sum == 256);
+        }
+        REQUIRE(snapshot.size() == 256u);
+    }
+}
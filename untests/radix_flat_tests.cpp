@@ -0,0 +1,114 @@
+/*******************************************************************************
+ * This file is part of the "https://github.com/blackmatov/flat.hpp"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2019-2023, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <flat.hpp/flat_map.hpp>
+#include <flat.hpp/flat_multiset.hpp>
+#include <flat.hpp/flat_set.hpp>
+#include <flat.hpp/radix_flat.hpp>
+#include "flat_tests.hpp"
+
+#include <cstdint>
+#include <random>
+
+namespace
+{
+    using namespace flat_hpp;
+
+    template < typename Radix, typename Key >
+    void check_lookups(const Radix& radix, const std::vector<Key>& keys) {
+        const auto& flat = radix.flat();
+        for ( const Key& key : keys ) {
+            REQUIRE(radix.lower_bound(key) == flat.lower_bound(key));
+            REQUIRE(radix.upper_bound(key) == flat.upper_bound(key));
+            REQUIRE(radix.equal_range(key) == flat.equal_range(key));
+            REQUIRE(radix.find(key) == flat.find(key));
+            REQUIRE(radix.count(key) == flat.count(key));
+            REQUIRE(radix.contains(key) == flat.contains(key));
+        }
+    }
+}
+
+TEST_CASE("radix_flat") {
+    SUBCASE("ip_prefixes") {
+        std::mt19937 gen(11);
+        flat_map<std::uint32_t, unsigned> m0;
+        for ( unsigned i = 0; i < 20000; ++i ) {
+            m0.emplace(static_cast<std::uint32_t>(gen()) & 0xFFFFFF00u, i);
+        }
+        m0.emplace(0u, 0u);
+        m0.emplace(0xFFFFFFFFu, 0u);
+
+        radix_flat<flat_map<std::uint32_t, unsigned>> r0(std::move(m0));
+        REQUIRE(r0.size() > 19000);
+        REQUIRE(r0.memory_usage() == ((1u << 8) + 1) * sizeof(std::size_t));
+
+        std::vector<std::uint32_t> keys{0u, 1u, 0xFFFFFFFEu, 0xFFFFFFFFu};
+        for ( const auto& pair : r0 ) {
+            keys.push_back(pair.first);
+            keys.push_back(pair.first + 1);
+        }
+        for ( unsigned i = 0; i < 20000; ++i ) {
+            keys.push_back(static_cast<std::uint32_t>(gen()));
+        }
+        check_lookups(r0, keys);
+    }
+    SUBCASE("signed_keys") {
+        flat_set<std::int16_t> s0;
+        for ( int i = -32768; i < 32768; i += 37 ) {
+            s0.insert(static_cast<std::int16_t>(i));
+        }
+
+        radix_flat<flat_set<std::int16_t>, 8> r0(std::move(s0));
+        std::vector<std::int16_t> keys;
+        for ( int i = -32768; i < 32768; i += 5 ) {
+            keys.push_back(static_cast<std::int16_t>(i));
+        }
+        check_lookups(r0, keys);
+
+        radix_flat<flat_set<std::int16_t>, 16> r1(r0.flat());
+        check_lookups(r1, keys);
+    }
+    SUBCASE("mutations") {
+        radix_flat<flat_multiset<int>, 4> r0;
+        REQUIRE(r0.empty());
+        REQUIRE(r0.lower_bound(5) == r0.end());
+        REQUIRE_FALSE(r0.contains(5));
+
+        r0.insert(5);
+        r0.insert(5);
+        r0.insert(-7);
+        REQUIRE(r0.count(5) == 2);
+        REQUIRE(r0.find(-7) == r0.begin());
+
+        const std::vector<int> values{100, -100, 5, 1 << 30};
+        r0.insert(values.begin(), values.end());
+        check_lookups(r0, std::vector<int>{-101, -100, -7, 0, 5, 6, 100, 1 << 30, (1 << 30) + 1});
+
+        REQUIRE(r0.erase(5) == 3);
+        REQUIRE_FALSE(r0.contains(5));
+        check_lookups(r0, std::vector<int>{-100, 5, 100});
+
+        const flat_multiset<int> s0 = std::move(r0).extract();
+        REQUIRE(s0 == flat_multiset<int>{-100, -7, 100, 1 << 30});
+        REQUIRE(r0.empty());
+        REQUIRE_FALSE(r0.contains(100));
+    }
+    SUBCASE("incremental_directory") {
+        radix_flat<flat_set<std::uint16_t>, 6> r0;
+        std::mt19937 engine(5);
+        std::vector<std::uint16_t> keys;
+        for ( int i = 0; i < 2000; ++i ) {
+            const auto key = static_cast<std::uint16_t>(engine());
+            if ( engine() % 3 == 0 ) {
+                r0.erase(key);
+            } else {
+                r0.insert(key);
+            }
+            keys.push_back(key);
+        }
+        check_lookups(r0, keys);
+    }
+}